@@ -0,0 +1,92 @@
+#ifndef condition_h
+#define condition_h
+
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "memory.h"
+#include "processor.h"
+
+typedef std::map<std::string, MemAddr> SymbolTable;
+
+// Grouped by what they do to the stack: push, replace the top, then pop two
+// and push one
+enum class OPERATION : uint8_t {
+  PUSH,
+  REG,
+  CYCLES,
+  LOAD,
+  LOAD8,
+  NOT,
+  INVERT,
+  NEGATE,
+  MUL,
+  DIV,
+  MOD,
+  ADD,
+  SUB,
+  SHL,
+  SHR,
+  LT,
+  LE,
+  GT,
+  GE,
+  EQ,
+  NE,
+  BIT_AND,
+  BIT_XOR,
+  BIT_OR,
+  AND,
+  OR
+};
+
+struct Operation {
+  OPERATION code;
+  int64_t arg;
+};
+
+/**
+ * @brief Expression over the machine state, compiled once into postfix
+ * bytecode for a small stack machine
+ *
+ * Operands are numbers, registers (R0-R15, PC, SP, SR), CYCLES, symbols
+ * (their address) and memory contents as mem[ADDR] for a word or
+ * mem8[ADDR] for a byte. Operators are C's, with C's precedence. Memory is
+ * read without side effects, division by zero gives 0 and constant parts
+ * are folded while compiling.
+ */
+class Condition {
+ public:
+  Condition(const std::string& text, Processor* proc, Memory* mem,
+            const SymbolTable& symbols = {});
+  ~Condition(){};
+
+  int64_t Evaluate() const;
+  bool IsTrue() const { return Evaluate() != 0; }
+  const std::string& GetText() const { return text; }
+  size_t GetSize() const { return code.size(); }
+
+  static constexpr size_t MAX_DEPTH = 32;
+  static constexpr int REGISTERS = 16;
+
+ private:
+  std::string text;
+  std::vector<Operation> code;
+  const uint16_t* registers[REGISTERS];
+  const uint64_t* cycles;
+  Memory* mem;
+};
+
+class ConditionException : public std::exception {
+  std::string _msg;
+
+ public:
+  ConditionException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
+};
+
+#endif
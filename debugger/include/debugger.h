@@ -1,29 +1,177 @@
 #ifndef debugger_h
 #define debugger_h
 
+#include <bitset>
 #include <iostream>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
+#include "adc10.h"
+#include "clock.h"
+#include "condition.h"
+#include "flash.h"
+#include "input_log.h"
 #include "memory.h"
+#include "port.h"
 #include "processor.h"
+#include "read_elf.h"
+#include "recorder.h"
+#include "timer_a.h"
+#include "uart.h"
+#include "watchdog.h"
+
+enum class STOP_REASON { BREAKPOINT, WATCHPOINT, STEP_LIMIT, HISTORY_START };
+
+enum class WATCH { READ, WRITE, ACCESS, CHANGE };
+
+struct Watchpoint {
+  MemAddr addr;
+  uint32_t size;
+  WATCH type;
+};
+
+/**
+ * @brief Access that stopped execution, pc is the instruction that made it
+ * and the values are the contents before and after
+ *
+ */
+struct WatchHit {
+  MemAddr pc;
+  MemAddr addr;
+  uint16_t old_val;
+  uint16_t new_val;
+  bool byte;
+  bool write;
+};
+
+/**
+ * @brief More to a breakpoint than its address: it only stops when the
+ * condition holds, a tracepoint logs the collected values and carries on
+ *
+ */
+struct BreakpointAction {
+  std::optional<Condition> condition;
+  bool trace;
+  std::vector<Condition> collect;
+};
+
+struct TraceHit {
+  MemAddr pc;
+  uint64_t cycles;
+  std::vector<int64_t> values;
+};
 
 class Debugger {
  public:
-  Debugger();
+  explicit Debugger(const Device& device = Device::G2553);
   ~Debugger();
 
   void LoadMem(std::string path);
+  void LoadElf(std::istream& elf_file);
+  void LoadImage(MemAddr addr, const uint8_t* data, size_t size);
+  void Reset();
   MemAddr GetPC();
   MemAddr GetResetAddress();
   MemAddr GetSP();
-  uint8_t GetMemory(uint8_t addr);
-  uint16_t GetMemory(uint16_t addr);
+  uint8_t GetMemoryByte(MemAddr addr);
+  uint16_t GetMemory(MemAddr addr);
+  void ReadBlock(MemAddr addr, uint8_t* data, size_t size) {
+    mem.ReadBlock(addr, data, size);
+  }
+  void WriteBlock(MemAddr addr, const uint8_t* data, size_t size) {
+    mem.WriteBlock(addr, data, size);
+  }
+  std::string DumpMemory(MemAddr addr, uint32_t size) {
+    return mem.Dump(addr, size);
+  }
   uint16_t GetRegister(uint16_t reg);
   void DisplayRegisters();
   void DisplayInstruction(MemAddr addr);
   void Step();
 
+  void SetBreakpoint(MemAddr addr);
+  void SetBreakpoint(MemAddr addr, const std::string& condition);
+  void SetTracepoint(MemAddr addr, const std::vector<std::string>& collect,
+                     const std::string& condition = "");
+  void ClearBreakpoint(MemAddr addr);
+  void ClearBreakpoints();
+  bool HasBreakpoint(MemAddr addr) { return breakpoints[addr]; }
+  size_t GetBreakpointCount() { return breakpoint_count; }
+  const std::vector<TraceHit>& GetTraceHits() { return trace_hits; }
+  void ClearTraceHits() { trace_hits.clear(); }
+  Condition Compile(const std::string& text) {
+    return Condition(text, &proc, &mem, symbols);
+  }
+  void SetSymbols(const SymbolTable& symbols) { this->symbols = symbols; }
+  std::string Symbolize(MemAddr addr, bool data = false);
+  void DumpHistory(std::ostream& out);
+  const SymbolTable& GetSymbols() { return symbols; }
+  int AddWatchpoint(MemAddr addr, uint32_t size, WATCH type);
+  void RemoveWatchpoint(int id);
+  void ClearWatchpoints();
+  const WatchHit& GetWatchHit() { return watch_hit; }
+  STOP_REASON Continue(uint64_t steps = UINT64_MAX);
+  void SaveSnapshot(Snapshot& snapshot);
+  void LoadSnapshot(Snapshot& snapshot);
+  void StartRecording(double latency = Recorder::DEFAULT_LATENCY);
+  void StopRecording();
+  bool IsRecording() { return recorder.IsRecording(); }
+  uint64_t GetPosition() { return position; }
+  STOP_REASON ReverseStep(uint64_t steps = 1);
+  STOP_REASON ReverseContinue();
+
   Processor proc;
   Memory mem;
+  Clock clock;
+  Port p1{&clock, &proc, Port::P1};
+  Port p2{&clock, &proc, Port::P2};
+  TimerA timer0{&clock, &proc, TimerA::TIMER0};
+  TimerA timer1{&clock, &proc, TimerA::TIMER1};
+  Watchdog watchdog{&clock, &proc};
+  Uart uart{&clock, &proc};
+  Adc10 adc{&clock, &proc};
+  Flash flash{&clock, &proc};
+
+ private:
+  STOP_REASON Dispatch(uint64_t steps);
+  STOP_REASON Record(uint64_t steps);
+  template <bool CHECK_STOPS>
+  STOP_REASON Run(uint64_t steps);
+  void Seek(uint64_t target);
+  void Restore(size_t checkpoint);
+  void CatchUp();
+  bool Triggered(MemAddr pc);
+  void LoadSymbols(ElfReader& elf_reader);
+  void UpdateWatches();
+  void Watched(MemAddr addr, uint16_t old_val, uint16_t val, bool byte,
+               bool write);
+
+  std::vector<Peripheral*> peripherals;
+  // One bit per address, checked against the PC after every step
+  std::bitset<Memory::MEM_SIZE> breakpoints;
+  size_t breakpoint_count{0};
+  // Breakpoints with a condition or a trace, only looked up when reached
+  std::bitset<Memory::MEM_SIZE> has_action;
+  std::unordered_map<MemAddr, BreakpointAction> actions;
+  std::vector<TraceHit> trace_hits;
+  SymbolTable symbols;
+  // Function symbols by address for naming code locations, local labels
+  // left out
+  std::map<MemAddr, std::string> locations;
+  // Sized data symbols by address, an address only takes the name of the
+  // object it falls in
+  std::map<MemAddr, std::pair<std::string, uint32_t>> objects;
+  std::map<int, Watchpoint> watchpoints;
+  int next_watchpoint{0};
+  WatchHit watch_hit{};
+  bool watch_triggered{false};
+
+  // Steps taken through Continue(), recordings are indexed by it
+  uint64_t position{0};
+  InputLog inputs{&proc};
+  Recorder recorder;
 };
 
 #endif
\ No newline at end of file
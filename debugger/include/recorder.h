@@ -0,0 +1,65 @@
+#ifndef recorder_h
+#define recorder_h
+
+#include <cstdint>
+#include <vector>
+
+#include "snapshot.h"
+
+/**
+ * @brief Machine state at a point of a recording, position counts steps and
+ * inputs is how much of the input log came before it
+ *
+ */
+struct Checkpoint {
+  uint64_t position;
+  size_t inputs;
+  Snapshot snapshot;
+};
+
+/**
+ * @brief Checkpoints taken while recording, for getting back to any earlier
+ * position by restoring the one before it and replaying forward
+ *
+ * The spacing follows the measured speed so that replaying from one
+ * checkpoint to the next takes about the target latency. With too many of
+ * them every other one is dropped, older positions take longer to get back
+ * to but memory stays bounded.
+ */
+class Recorder {
+ public:
+  Recorder(){};
+  ~Recorder(){};
+
+  void Start(double latency);
+  void Stop();
+  bool IsRecording() { return recording; }
+  Snapshot& Add(uint64_t position, size_t inputs);
+  Checkpoint& Get(size_t index) { return checkpoints[index]; }
+  size_t Find(uint64_t position);
+  uint64_t GetStart() { return checkpoints.front().position; }
+  uint64_t GetEnd() { return end; }
+  void Extend(uint64_t position);
+  uint64_t GetNextCheckpoint() {
+    return checkpoints.back().position + interval;
+  }
+  uint64_t GetInterval() { return interval; }
+  size_t GetCount() { return checkpoints.size(); }
+  void Pace(uint64_t steps, double seconds);
+
+  // Seconds of replay to get from a checkpoint to any position after it
+  static constexpr double DEFAULT_LATENCY = 0.05;
+  static constexpr size_t MAX_CHECKPOINTS = 256;
+  static constexpr uint64_t MIN_INTERVAL = 1000;
+
+ private:
+  std::vector<Checkpoint> checkpoints;
+  bool recording{false};
+  double latency{DEFAULT_LATENCY};
+  uint64_t interval{MIN_INTERVAL};
+  // Furthest position recorded, inputs are replayed up to it
+  uint64_t end{0};
+  double steps_per_second{0};
+};
+
+#endif
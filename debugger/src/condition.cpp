@@ -0,0 +1,316 @@
+#include "condition.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+struct BinaryOp {
+  const char* token;
+  OPERATION op;
+  int precedence;
+};
+
+// Two character operators come first so they aren't read as one character
+constexpr BinaryOp BINARY_OPS[] = {
+    {"||", OPERATION::OR, 1},          {"&&", OPERATION::AND, 2},
+    {"==", OPERATION::EQ, 6},          {"!=", OPERATION::NE, 6},
+    {"<=", OPERATION::LE, 7},          {">=", OPERATION::GE, 7},
+    {"<<", OPERATION::SHL, 8},         {">>", OPERATION::SHR, 8},
+    {"|", OPERATION::BIT_OR, 3},       {"^", OPERATION::BIT_XOR, 4},
+    {"&", OPERATION::BIT_AND, 5},      {"<", OPERATION::LT, 7},
+    {">", OPERATION::GT, 7},           {"+", OPERATION::ADD, 9},
+    {"-", OPERATION::SUB, 9},          {"*", OPERATION::MUL, 10},
+    {"/", OPERATION::DIV, 10},         {"%", OPERATION::MOD, 10}};
+
+// Arithmetic wraps like the unsigned types it's done in
+inline int64_t Unary(OPERATION op, int64_t a) {
+  switch (op) {
+    case OPERATION::NOT:
+      return !a;
+    case OPERATION::INVERT:
+      return ~a;
+    default:
+      return static_cast<int64_t>(0 - static_cast<uint64_t>(a));
+  }
+}
+
+inline int64_t Binary(OPERATION op, int64_t a, int64_t b) {
+  auto ua = static_cast<uint64_t>(a);
+  auto ub = static_cast<uint64_t>(b);
+  switch (op) {
+    case OPERATION::MUL:
+      return static_cast<int64_t>(ua * ub);
+    case OPERATION::DIV:
+      if (b == 0) {
+        return 0;
+      }
+      return (b == -1) ? Unary(OPERATION::NEGATE, a) : a / b;
+    case OPERATION::MOD:
+      return (b == 0 || b == -1) ? 0 : a % b;
+    case OPERATION::ADD:
+      return static_cast<int64_t>(ua + ub);
+    case OPERATION::SUB:
+      return static_cast<int64_t>(ua - ub);
+    case OPERATION::SHL:
+      return static_cast<int64_t>(ua << (ub & 63));
+    case OPERATION::SHR:
+      return a >> (ub & 63);
+    case OPERATION::LT:
+      return a < b;
+    case OPERATION::LE:
+      return a <= b;
+    case OPERATION::GT:
+      return a > b;
+    case OPERATION::GE:
+      return a >= b;
+    case OPERATION::EQ:
+      return a == b;
+    case OPERATION::NE:
+      return a != b;
+    case OPERATION::BIT_AND:
+      return a & b;
+    case OPERATION::BIT_XOR:
+      return a ^ b;
+    case OPERATION::BIT_OR:
+      return a | b;
+    case OPERATION::AND:
+      return a && b;
+    default:
+      return a || b;
+  }
+}
+
+/**
+ * @brief Recursive descent over the text, emitting code as it goes and
+ * keeping track of how deep the stack gets
+ *
+ */
+class Compiler {
+ public:
+  Compiler(const std::string& text, const SymbolTable& symbols,
+           std::vector<Operation>& code)
+      : text(text), symbols(symbols), code(code){};
+
+  void Compile() {
+    ParseExpression(1);
+    SkipSpaces();
+    if (pos != text.size()) {
+      Fail("unexpected '" + std::string(1, text[pos]) + "'");
+    }
+  }
+
+ private:
+  void ParseExpression(int min_precedence) {
+    ParseUnary();
+    while (true) {
+      SkipSpaces();
+      const BinaryOp* match = nullptr;
+      for (auto& binary : BINARY_OPS) {
+        if (text.compare(pos, strlen(binary.token), binary.token) == 0) {
+          match = &binary;
+          break;
+        }
+      }
+      if (match == nullptr || match->precedence < min_precedence) {
+        return;
+      }
+      pos += strlen(match->token);
+      ParseExpression(match->precedence + 1);
+      Emit(match->op);
+    }
+  }
+
+  void ParseUnary() {
+    SkipSpaces();
+    if (pos < text.size()) {
+      auto c = text[pos];
+      if (c == '!' || c == '~' || c == '-') {
+        pos++;
+        ParseUnary();
+        Emit(c == '!'   ? OPERATION::NOT
+             : c == '~' ? OPERATION::INVERT
+                        : OPERATION::NEGATE);
+        return;
+      }
+    }
+    ParsePrimary();
+  }
+
+  void ParsePrimary() {
+    SkipSpaces();
+    if (pos >= text.size()) {
+      Fail("expected a value");
+    }
+    auto c = text[pos];
+    if (c == '(') {
+      pos++;
+      ParseExpression(1);
+      Expect(')');
+    } else if (isdigit(c)) {
+      char* end;
+      auto val = strtoull(text.c_str() + pos, &end, 0);
+      pos = end - text.c_str();
+      Emit(OPERATION::PUSH, static_cast<int64_t>(val));
+    } else if (isalpha(c) || c == '_' || c == '.' || c == '$') {
+      ParseName();
+    } else {
+      Fail("unexpected '" + std::string(1, c) + "'");
+    }
+  }
+
+  void ParseName() {
+    auto start = pos;
+    while (pos < text.size() &&
+           (isalnum(text[pos]) || strchr("_.$", text[pos]) != nullptr)) {
+      pos++;
+    }
+    auto name = text.substr(start, pos - start);
+    std::string lower;
+    for (auto c : name) {
+      lower += tolower(c);
+    }
+
+    SkipSpaces();
+    if ((lower == "mem" || lower == "mem8") && pos < text.size() &&
+        text[pos] == '[') {
+      pos++;
+      ParseExpression(1);
+      Expect(']');
+      Emit(lower == "mem" ? OPERATION::LOAD : OPERATION::LOAD8);
+      return;
+    }
+
+    int reg = -1;
+    if (lower == "pc") {
+      reg = 0;
+    } else if (lower == "sp") {
+      reg = 1;
+    } else if (lower == "sr") {
+      reg = 2;
+    } else if (lower.size() > 1 && lower.size() < 4 && lower[0] == 'r' &&
+               isdigit(lower[1]) && (lower.size() == 2 || lower[1] != '0') &&
+               isdigit(lower.back())) {
+      reg = std::stoi(lower.substr(1));
+    }
+    if (reg >= 0 && reg < Condition::REGISTERS) {
+      Emit(OPERATION::REG, reg);
+    } else if (lower == "cycles") {
+      Emit(OPERATION::CYCLES);
+    } else if (symbols.count(name)) {
+      Emit(OPERATION::PUSH, symbols.at(name));
+    } else {
+      Fail("unknown name '" + name + "'");
+    }
+  }
+
+  /**
+   * @brief Append an operation, folding it into the constants before it
+   * when it only depends on them
+   *
+   */
+  void Emit(OPERATION op, int64_t arg = 0) {
+    auto size = code.size();
+    if (op >= OPERATION::NOT && op <= OPERATION::NEGATE) {
+      if (size >= 1 && code[size - 1].code == OPERATION::PUSH) {
+        code[size - 1].arg = Unary(op, code[size - 1].arg);
+        return;
+      }
+    } else if (op >= OPERATION::MUL) {
+      if (size >= 2 && code[size - 1].code == OPERATION::PUSH &&
+          code[size - 2].code == OPERATION::PUSH) {
+        auto& left = code[size - 2];
+        left.arg = Binary(op, left.arg, code[size - 1].arg);
+        code.pop_back();
+        depth--;
+        return;
+      }
+    }
+
+    code.push_back({op, arg});
+    if (op <= OPERATION::CYCLES) {
+      if (++depth > Condition::MAX_DEPTH) {
+        Fail("expression is too deep");
+      }
+    } else if (op >= OPERATION::MUL) {
+      depth--;
+    }
+  }
+
+  void Expect(char c) {
+    SkipSpaces();
+    if (pos >= text.size() || text[pos] != c) {
+      Fail(std::string("expected '") + c + "'");
+    }
+    pos++;
+  }
+
+  void SkipSpaces() {
+    while (pos < text.size() && isspace(text[pos])) {
+      pos++;
+    }
+  }
+
+  [[noreturn]] void Fail(const std::string& error) {
+    throw ConditionException(error + " at " + std::to_string(pos) +
+                             " in: " + text);
+  }
+
+  const std::string& text;
+  const SymbolTable& symbols;
+  std::vector<Operation>& code;
+  size_t pos{0};
+  size_t depth{0};
+};
+
+}  // namespace
+
+Condition::Condition(const std::string& text, Processor* proc, Memory* mem,
+                     const SymbolTable& symbols)
+    : text(text), cycles(&proc->cycles), mem(mem) {
+  for (int reg = 0; reg < REGISTERS; reg++) {
+    registers[reg] = proc->register_map[reg];
+  }
+  Compiler(text, symbols, code).Compile();
+}
+
+/**
+ * @brief Run the code, the result is the only value left on the stack
+ *
+ */
+int64_t Condition::Evaluate() const {
+  int64_t stack[MAX_DEPTH];
+  size_t top = 0;
+  for (auto& op : code) {
+    switch (op.code) {
+      case OPERATION::PUSH:
+        stack[top++] = op.arg;
+        break;
+      case OPERATION::REG:
+        stack[top++] = *registers[op.arg];
+        break;
+      case OPERATION::CYCLES:
+        stack[top++] = static_cast<int64_t>(*cycles);
+        break;
+      case OPERATION::LOAD:
+        stack[top - 1] = mem->ReadRaw(static_cast<MemAddr>(stack[top - 1]),
+                                      false);
+        break;
+      case OPERATION::LOAD8:
+        stack[top - 1] = mem->ReadRaw(static_cast<MemAddr>(stack[top - 1]),
+                                      true);
+        break;
+      case OPERATION::NOT:
+      case OPERATION::INVERT:
+      case OPERATION::NEGATE:
+        stack[top - 1] = Unary(op.code, stack[top - 1]);
+        break;
+      default:
+        top--;
+        stack[top - 1] = Binary(op.code, stack[top - 1], stack[top]);
+        break;
+    }
+  }
+  return stack[0];
+}
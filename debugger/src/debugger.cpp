@@ -1,12 +1,199 @@
 #include "debugger.h"
 
-Debugger::Debugger() {}
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+
+/**
+ * @brief Peripherals the device doesn't have are left unmapped, their
+ * addresses are plain memory
+ *
+ */
+Debugger::Debugger(const Device& device) : proc(device) {
+  peripherals = {&clock, &p1, &p2, &timer0};
+  if (device.Has(Device::TIMER1)) {
+    peripherals.push_back(&timer1);
+  }
+  peripherals.push_back(&watchdog);
+  if (device.Has(Device::USCI)) {
+    peripherals.push_back(&uart);
+  }
+  if (device.Has(Device::ADC10)) {
+    peripherals.push_back(&adc);
+  }
+  peripherals.push_back(&flash);
+  for (auto peripheral : peripherals) {
+    peripheral->Attach(&mem);
+    peripheral->SetInputLog(&inputs);
+  }
+  inputs.SetApply([this](const InputEvent& event) {
+    if (event.source == INPUT::ADC) {
+      adc.SetInput(event.index, event.val);
+    } else if (event.source == INPUT::PORT) {
+      auto& port = (event.unit == Port::P1.number) ? p1 : p2;
+      port.SetInput(event.index, event.val);
+    }
+  });
+  watchdog.SetPuc([this]() { Reset(); });
+  watchdog.AddListener([this]() { flash.UpdateInterrupts(); });
+  flash.SetPuc([this]() { Reset(); });
+  mem.SetWatchHook([this](MemAddr addr, uint16_t old_val, uint16_t val,
+                          bool byte, bool write) {
+    Watched(addr, old_val, val, byte, write);
+  });
+  clock.SetCycleCounter(&proc.cycles);
+  proc.SetMemory(&mem);
+}
 
 Debugger::~Debugger() {}
 
 void Debugger::LoadMem(std::string path) {
   mem.LoadFile(path);
+  clock.SetCycleCounter(&proc.cycles);
   proc.SetMemory(&mem);
+  ElfReader elf_reader(path);
+  LoadSymbols(elf_reader);
+}
+
+void Debugger::LoadElf(std::istream& elf_file) {
+  mem.LoadElf(elf_file);
+  clock.SetCycleCounter(&proc.cycles);
+  proc.SetMemory(&mem);
+  ElfReader elf_reader(elf_file);
+  LoadSymbols(elf_reader);
+}
+
+/**
+ * @brief Symbols conditions can refer to by name
+ *
+ */
+void Debugger::LoadSymbols(ElfReader& elf_reader) {
+  symbols.clear();
+  locations.clear();
+  objects.clear();
+  auto elf_symbols = elf_reader.GetSymbols();
+  if (!elf_symbols.has_value()) {
+    return;
+  }
+  for (auto& [name, symbol] : elf_symbols.value()) {
+    auto addr = static_cast<MemAddr>(symbol.st_value);
+    symbols[name] = addr;
+    if (ELF32_ST_TYPE(symbol.st_info) == STT_FUNC && name[0] != '$') {
+      locations.emplace(addr, name);
+    } else if (ELF32_ST_TYPE(symbol.st_info) == STT_OBJECT &&
+               symbol.st_size > 0) {
+      objects.emplace(addr, std::make_pair(name, symbol.st_size));
+    }
+  }
+}
+
+/**
+ * @brief Name an address as the nearest function at or below it plus an
+ * offset, or for data the object it is in, empty if there is none
+ *
+ */
+std::string Debugger::Symbolize(MemAddr addr, bool data) {
+  MemAddr start;
+  std::string name;
+  if (data) {
+    auto next = objects.upper_bound(addr);
+    if (next == objects.begin()) {
+      return "";
+    }
+    auto& object = *std::prev(next);
+    if (addr >= object.first + object.second.second) {
+      return "";
+    }
+    start = object.first;
+    name = object.second.first;
+  } else {
+    auto next = locations.upper_bound(addr);
+    if (next == locations.begin()) {
+      return "";
+    }
+    start = std::prev(next)->first;
+    name = std::prev(next)->second;
+  }
+  if (start == addr) {
+    return name;
+  }
+  char offset[8];
+  snprintf(offset, sizeof(offset), "+0x%x", addr - start);
+  return name + offset;
+}
+
+/**
+ * @brief Write the instructions in the processor's history, oldest first,
+ * with their symbols
+ *
+ */
+void Debugger::DumpHistory(std::ostream& out) {
+  auto& history = proc.history;
+  out << "last " << history.GetSize() << " of " << history.GetCount()
+      << " instructions:\n";
+  for (size_t x = 0; x < history.GetSize(); x++) {
+    auto& entry = history.Get(x);
+    char line[64];
+    snprintf(line, sizeof(line), "%12llu  %04x  %04x  %-7s sp=%04x sr=%04x",
+             static_cast<unsigned long long>(entry.cycles), entry.pc,
+             entry.opcode, History::Mnemonic(entry.opcode).c_str(), entry.sp,
+             entry.sr);
+    out << line;
+    auto symbol = Symbolize(entry.pc);
+    if (!symbol.empty()) {
+      out << "  " << symbol;
+    }
+    out << "\n";
+  }
+}
+
+/**
+ * @brief Load a raw image, the processor is left alone until Reset()
+ *
+ */
+void Debugger::LoadImage(MemAddr addr, const uint8_t* data, size_t size) {
+  mem.LoadImage(addr, data, size);
+}
+
+/**
+ * @brief Power up clear, peripherals go back to their reset values
+ *
+ */
+void Debugger::Reset() {
+  for (auto peripheral : peripherals) {
+    peripheral->Reset();
+  }
+  proc.int_reset();
+}
+
+/**
+ * @brief Complete machine state, breakpoints and watchpoints belong to the
+ * session and are kept as they are on load
+ *
+ */
+void Debugger::SaveSnapshot(Snapshot& snapshot) {
+  snapshot.Clear();
+  snapshot.PutString(proc.device->name);
+  mem.Save(snapshot);
+  proc.Save(snapshot);
+  for (auto peripheral : peripherals) {
+    peripheral->Save(snapshot);
+  }
+}
+
+void Debugger::LoadSnapshot(Snapshot& snapshot) {
+  snapshot.Rewind();
+  auto device = snapshot.GetString();
+  if (device != proc.device->name) {
+    throw SnapshotException("snapshot is of a " + device + ", not a " +
+                            proc.device->name);
+  }
+  mem.Load(snapshot);
+  proc.Load(snapshot);
+  for (auto peripheral : peripherals) {
+    peripheral->Load(snapshot);
+  }
 }
 
 MemAddr Debugger::GetPC() { return *proc.PC; }
@@ -18,8 +205,8 @@ MemAddr Debugger::GetResetAddress() {
 }
 
 void Debugger::DisplayRegisters() {
+  int counter = 0;
   for (auto reg : proc.register_map) {
-    static int counter = 0;
     std::cout << "R" << std::setw(2) << std::left << counter << ": ";
     printf("0x%04x", *reg.second);
     if (reg.first == 0) {
@@ -40,9 +227,11 @@ void Debugger::DisplayInstruction(MemAddr addr) {
   proc.DisplayInstruction(addr);
 }
 
-uint8_t Debugger::GetMemory(uint8_t addr) { return proc.mem->GetUint8(addr); }
+uint8_t Debugger::GetMemoryByte(MemAddr addr) {
+  return proc.mem->GetUint8(addr);
+}
 
-uint16_t Debugger::GetMemory(uint16_t addr) {
+uint16_t Debugger::GetMemory(MemAddr addr) {
   return proc.mem->GetUint16(addr);
 }
 
@@ -57,3 +246,371 @@ void Debugger::Step() {
   std::cout<<std::endl;
   proc.step = false;
 }
+
+void Debugger::SetBreakpoint(MemAddr addr) {
+  if (!breakpoints[addr]) {
+    breakpoints[addr] = true;
+    breakpoint_count++;
+  }
+  if (has_action[addr]) {
+    has_action[addr] = false;
+    actions.erase(addr);
+  }
+}
+
+/**
+ * @brief Stop at addr only when the condition holds, it's compiled here
+ * and evaluated each time the PC gets there
+ *
+ */
+void Debugger::SetBreakpoint(MemAddr addr, const std::string& condition) {
+  BreakpointAction action{Compile(condition), false, {}};
+  SetBreakpoint(addr);
+  actions.insert_or_assign(addr, std::move(action));
+  has_action[addr] = true;
+}
+
+/**
+ * @brief Log the values of the collect expressions each time the PC gets
+ * to addr and the condition, if there is one, holds, without stopping
+ *
+ */
+void Debugger::SetTracepoint(MemAddr addr,
+                             const std::vector<std::string>& collect,
+                             const std::string& condition) {
+  BreakpointAction action{std::nullopt, true, {}};
+  if (!condition.empty()) {
+    action.condition = Compile(condition);
+  }
+  for (auto& text : collect) {
+    action.collect.push_back(Compile(text));
+  }
+  SetBreakpoint(addr);
+  actions.insert_or_assign(addr, std::move(action));
+  has_action[addr] = true;
+}
+
+void Debugger::ClearBreakpoint(MemAddr addr) {
+  if (breakpoints[addr]) {
+    breakpoints[addr] = false;
+    breakpoint_count--;
+  }
+  if (has_action[addr]) {
+    has_action[addr] = false;
+    actions.erase(addr);
+  }
+}
+
+void Debugger::ClearBreakpoints() {
+  breakpoints.reset();
+  breakpoint_count = 0;
+  has_action.reset();
+  actions.clear();
+}
+
+/**
+ * @brief Whether a breakpoint with an action stops, tracepoints never do.
+ * Replayed hits were logged the first time through.
+ *
+ */
+bool Debugger::Triggered(MemAddr pc) {
+  auto& action = actions.at(pc);
+  if (action.condition && !action.condition->IsTrue()) {
+    return false;
+  }
+  if (!action.trace) {
+    return true;
+  }
+  if (!inputs.IsReplaying()) {
+    TraceHit hit{pc, proc.cycles, {}};
+    for (auto& expression : action.collect) {
+      hit.values.push_back(expression.Evaluate());
+    }
+    trace_hits.push_back(std::move(hit));
+  }
+  return false;
+}
+
+/**
+ * @brief Stop when an access of the given type touches the size bytes from
+ * addr, CHANGE only stops on writes that change them. Returns an id for
+ * RemoveWatchpoint().
+ *
+ */
+int Debugger::AddWatchpoint(MemAddr addr, uint32_t size, WATCH type) {
+  if (size == 0 || addr + size > Memory::MEM_SIZE) {
+    throw MemoryException("watchpoint out of range");
+  }
+  watchpoints[next_watchpoint] = {addr, size, type};
+  UpdateWatches();
+  return next_watchpoint++;
+}
+
+void Debugger::RemoveWatchpoint(int id) {
+  watchpoints.erase(id);
+  UpdateWatches();
+}
+
+void Debugger::ClearWatchpoints() {
+  watchpoints.clear();
+  UpdateWatches();
+}
+
+/**
+ * @brief Only watched addresses leave the plain memory path
+ *
+ */
+void Debugger::UpdateWatches() {
+  mem.ClearWatches();
+  for (auto& entry : watchpoints) {
+    auto& watch = entry.second;
+    bool read = (watch.type == WATCH::READ || watch.type == WATCH::ACCESS);
+    bool write = (watch.type != WATCH::READ);
+    mem.Watch(watch.addr, watch.size, read, write);
+  }
+}
+
+void Debugger::Watched(MemAddr addr, uint16_t old_val, uint16_t val,
+                       bool byte, bool write) {
+  if (watch_triggered) {
+    return;
+  }
+  for (auto& entry : watchpoints) {
+    auto& watch = entry.second;
+    // Bytes of the access inside the watched range
+    uint16_t mask = 0;
+    for (int x = 0; x < (byte ? 1 : 2); x++) {
+      uint32_t byte_addr = static_cast<MemAddr>(addr + x);
+      if (byte_addr >= watch.addr && byte_addr < watch.addr + watch.size) {
+        mask |= 0x00FF << (8 * x);
+      }
+    }
+    if (mask == 0) {
+      continue;
+    }
+
+    bool hit = false;
+    switch (watch.type) {
+      case WATCH::READ:
+        hit = !write;
+        break;
+      case WATCH::WRITE:
+        hit = write;
+        break;
+      case WATCH::ACCESS:
+        hit = true;
+        break;
+      case WATCH::CHANGE:
+        hit = write && ((old_val ^ val) & mask);
+        break;
+    }
+    if (hit) {
+      watch_hit = {GetPC(), addr, old_val, val, byte, write};
+      watch_triggered = true;
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Run at full speed until the PC reaches a breakpoint, a watchpoint
+ * is hit or the given number of steps (instructions, interrupt entries or
+ * low power mode skips) have been taken. A breakpoint at the current PC
+ * doesn't stop it again.
+ *
+ */
+STOP_REASON Debugger::Continue(uint64_t steps) {
+  if (recorder.IsRecording()) {
+    return Record(steps);
+  }
+  return Dispatch(steps);
+}
+
+STOP_REASON Debugger::Dispatch(uint64_t steps) {
+  watch_triggered = false;
+  // Picked once per call, the loop with nothing to stop for has no checks
+  if (breakpoint_count == 0 && watchpoints.empty()) {
+    return Run<false>(steps);
+  }
+  return Run<true>(steps);
+}
+
+/**
+ * @brief Continue in runs that end at the next checkpoint, replaying inputs
+ * up to the end of the recording and recording them after it
+ *
+ */
+STOP_REASON Debugger::Record(uint64_t steps) {
+  auto target = (steps > UINT64_MAX - position) ? UINT64_MAX : position + steps;
+  while (position < target) {
+    recorder.Extend(position);
+    uint64_t limit = recorder.GetEnd();
+    if (position == limit) {
+      inputs.SetMode(INPUT_MODE::RECORD);
+      if (recorder.GetNextCheckpoint() <= position) {
+        SaveSnapshot(recorder.Add(position, inputs.GetSize()));
+      }
+      limit = recorder.GetNextCheckpoint();
+    }
+
+    auto start = position;
+    auto begin = std::chrono::steady_clock::now();
+    auto reason = Dispatch(std::min(target, limit) - position);
+    recorder.Pace(position - start,
+                  std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - begin)
+                      .count());
+    if (reason != STOP_REASON::STEP_LIMIT) {
+      CatchUp();
+      return reason;
+    }
+  }
+  CatchUp();
+  return STOP_REASON::STEP_LIMIT;
+}
+
+/**
+ * @brief Back at the end of the recording, inputs are taken live and
+ * recorded again
+ *
+ */
+void Debugger::CatchUp() {
+  recorder.Extend(position);
+  if (position == recorder.GetEnd()) {
+    inputs.SetMode(INPUT_MODE::RECORD);
+  }
+}
+
+/**
+ * @brief Record from here on, every Continue() after this can be stepped
+ * back through
+ *
+ */
+void Debugger::StartRecording(double latency) {
+  recorder.Start(latency);
+  inputs.Clear();
+  inputs.SetMode(INPUT_MODE::RECORD);
+  SaveSnapshot(recorder.Add(position, inputs.GetSize()));
+}
+
+/**
+ * @brief Drop the recording, stepped back into it the machine carries on
+ * from where it is
+ *
+ */
+void Debugger::StopRecording() {
+  recorder.Stop();
+  inputs.SetMode(INPUT_MODE::LIVE);
+  inputs.Clear();
+}
+
+/**
+ * @brief Go back a number of steps, or to the start of the recording if
+ * that's nearer
+ *
+ */
+STOP_REASON Debugger::ReverseStep(uint64_t steps) {
+  if (!recorder.IsRecording()) {
+    return STOP_REASON::HISTORY_START;
+  }
+  recorder.Extend(position);
+  auto start = recorder.GetStart();
+  if (position - start < steps) {
+    Seek(start);
+    return STOP_REASON::HISTORY_START;
+  }
+  Seek(position - steps);
+  return STOP_REASON::STEP_LIMIT;
+}
+
+/**
+ * @brief Go back to the last breakpoint or watchpoint hit before the
+ * current position, looking through one checkpoint interval at a time
+ *
+ */
+STOP_REASON Debugger::ReverseContinue() {
+  if (!recorder.IsRecording()) {
+    return STOP_REASON::HISTORY_START;
+  }
+  recorder.Extend(position);
+  auto current = position;
+  auto start = recorder.GetStart();
+  if (current == start) {
+    return STOP_REASON::HISTORY_START;
+  }
+
+  auto index = recorder.Find(current - 1);
+  auto end = current;
+  while (true) {
+    Restore(index);
+    bool found = false;
+    uint64_t found_position = 0;
+    STOP_REASON found_reason{};
+    WatchHit found_hit{};
+    while (position < end) {
+      auto reason = Dispatch(end - position);
+      if (reason != STOP_REASON::STEP_LIMIT && position < current) {
+        found = true;
+        found_position = position;
+        found_reason = reason;
+        found_hit = watch_hit;
+      }
+    }
+    if (found) {
+      Seek(found_position);
+      watch_hit = found_hit;
+      return found_reason;
+    }
+    if (index == 0) {
+      Seek(start);
+      return STOP_REASON::HISTORY_START;
+    }
+    end = recorder.Get(index).position;
+    index--;
+  }
+}
+
+/**
+ * @brief Get to a recorded position by replaying from the checkpoint
+ * before it, without stopping
+ *
+ */
+void Debugger::Seek(uint64_t target) {
+  Restore(recorder.Find(target));
+  Run<false>(target - position);
+  watch_triggered = false;
+  CatchUp();
+}
+
+void Debugger::Restore(size_t checkpoint) {
+  auto& saved = recorder.Get(checkpoint);
+  LoadSnapshot(saved.snapshot);
+  position = saved.position;
+  inputs.Seek(saved.inputs);
+}
+
+template <bool CHECK_STOPS>
+STOP_REASON Debugger::Run(uint64_t steps) {
+  for (uint64_t step = 0; step < steps; step++) {
+    if constexpr (CHECK_STOPS) {
+      MemAddr pc = *proc.PC;
+      proc.Step();
+      position++;
+      if (watch_triggered) {
+        watch_triggered = false;
+        watch_hit.pc = pc;
+        return STOP_REASON::WATCHPOINT;
+      }
+      // The PC doesn't move while the CPU is off, so it only counts as
+      // reaching a breakpoint when an instruction or interrupt took it there
+      if (breakpoints[*proc.PC] && !proc.SR->cpu_off &&
+          (!has_action[*proc.PC] || Triggered(*proc.PC))) {
+        return STOP_REASON::BREAKPOINT;
+      }
+    } else {
+      proc.Step();
+      position++;
+    }
+  }
+  return STOP_REASON::STEP_LIMIT;
+}
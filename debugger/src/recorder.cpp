@@ -0,0 +1,68 @@
+#include "recorder.h"
+
+#include <algorithm>
+
+void Recorder::Start(double latency) {
+  checkpoints.clear();
+  recording = true;
+  this->latency = latency;
+  interval = MIN_INTERVAL;
+  end = 0;
+  steps_per_second = 0;
+}
+
+void Recorder::Stop() {
+  checkpoints.clear();
+  recording = false;
+}
+
+/**
+ * @brief Make room for a checkpoint at the end of the recording, the
+ * caller saves the state into the snapshot returned
+ *
+ */
+Snapshot& Recorder::Add(uint64_t position, size_t inputs) {
+  if (checkpoints.size() >= MAX_CHECKPOINTS) {
+    // The first one is where the recording starts and always stays
+    size_t kept = 1;
+    for (size_t x = 2; x < checkpoints.size(); x += 2) {
+      checkpoints[kept++] = std::move(checkpoints[x]);
+    }
+    checkpoints.resize(kept);
+  }
+  end = std::max(end, position);
+  checkpoints.push_back({position, inputs, Snapshot()});
+  return checkpoints.back().snapshot;
+}
+
+/**
+ * @brief Index of the last checkpoint at or before a position
+ *
+ */
+size_t Recorder::Find(uint64_t position) {
+  auto after = std::upper_bound(
+      checkpoints.begin(), checkpoints.end(), position,
+      [](uint64_t val, const Checkpoint& checkpoint) {
+        return val < checkpoint.position;
+      });
+  return (after == checkpoints.begin()) ? 0 : after - checkpoints.begin() - 1;
+}
+
+void Recorder::Extend(uint64_t position) { end = std::max(end, position); }
+
+/**
+ * @brief Update the speed estimate from a run of steps and space the
+ * following checkpoints to match
+ *
+ */
+void Recorder::Pace(uint64_t steps, double seconds) {
+  if (steps < MIN_INTERVAL || seconds <= 0) {
+    return;
+  }
+  auto speed = steps / seconds;
+  steps_per_second = (steps_per_second == 0)
+                         ? speed
+                         : 0.75 * steps_per_second + 0.25 * speed;
+  interval = std::max(MIN_INTERVAL,
+                      static_cast<uint64_t>(steps_per_second * latency));
+}
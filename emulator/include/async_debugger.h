@@ -0,0 +1,103 @@
+#ifndef async_debugger_h
+#define async_debugger_h
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "debugger.h"
+#include "ring_buffer.h"
+
+enum class COMMAND {
+  RESUME,
+  PAUSE,
+  SET_BREAKPOINT,
+  CLEAR_BREAKPOINT,
+  CALL,
+  QUIT
+};
+
+enum class EVENT { STOPPED, PAUSED, FAULT };
+
+struct DebugCommand {
+  COMMAND type;
+  uint64_t arg;
+  std::function<void(Debugger& debug)> call;
+};
+
+/**
+ * @brief Why the target stopped running, reason is only set for STOPPED
+ * and error only for FAULT
+ *
+ */
+struct DebugEvent {
+  EVENT type;
+  STOP_REASON reason;
+  MemAddr pc;
+  uint64_t cycles;
+  std::string error;
+};
+
+/**
+ * @brief Runs a Debugger on a thread of its own, controlled from another
+ * one through a pair of single producer, single consumer queues
+ *
+ * The emulation thread runs BLOCK_STEPS at a time at full speed and only
+ * looks at the command queue between blocks, a single load when it's
+ * empty. Anything not covered by a command is done with Call(), which runs
+ * the function on the emulation thread between blocks and hands back its
+ * result. Events are dropped if the front end doesn't keep up with them.
+ */
+class AsyncDebugger {
+ public:
+  AsyncDebugger(Debugger& debug) : debug(debug){};
+  ~AsyncDebugger();
+
+  void Start();
+  void Stop();
+  void Resume(uint64_t steps = UINT64_MAX);
+  void Pause();
+  void SetBreakpoint(MemAddr addr);
+  void ClearBreakpoint(MemAddr addr);
+  // As of the last command the emulation thread has handled
+  bool IsRunning() { return running.load(std::memory_order_acquire); }
+  bool PollEvent(DebugEvent& event) { return events.Pop(event); }
+  bool WaitEvent(DebugEvent& event, std::chrono::milliseconds timeout);
+
+  template <typename F>
+  auto Call(F function)
+      -> std::future<decltype(function(std::declval<Debugger&>()))> {
+    typedef decltype(function(std::declval<Debugger&>())) Result;
+    auto task =
+        std::make_shared<std::packaged_task<Result(Debugger&)>>(function);
+    auto result = task->get_future();
+    Send({COMMAND::CALL, 0, [task](Debugger& debug) { (*task)(debug); }});
+    return result;
+  }
+
+  static constexpr uint64_t BLOCK_STEPS = 4096;
+  static constexpr size_t QUEUE_SIZE = 64;
+  // Sleep between looks at the queue while paused
+  static constexpr std::chrono::milliseconds INTERVAL{1};
+
+ private:
+  void Send(const DebugCommand& command);
+  void Loop();
+  bool Execute(DebugCommand& command);
+  void Post(EVENT type, STOP_REASON reason, const std::string& error = "");
+
+  Debugger& debug;
+  std::thread thread;
+  RingBuffer<DebugCommand, QUEUE_SIZE> commands;
+  RingBuffer<DebugEvent, QUEUE_SIZE> events;
+  std::atomic<bool> active{false};
+  std::atomic<bool> running{false};
+  // Steps left before stopping, only used on the emulation thread
+  uint64_t remaining{0};
+};
+
+#endif
@@ -2,21 +2,68 @@
 #define emulator_h
 
 #include <iostream>
+#include <optional>
+#include <vector>
 
 #include "debugger.h"
 #include "memory.h"
+#include "pacer.h"
 #include "processor.h"
 
+enum class EXIT_REASON {
+  CYCLE_LIMIT,
+  INSTRUCTION_LIMIT,
+  PC_REACHED,
+  SENTINEL_WRITE,
+  KILLED,
+  FAULT
+};
+
+/**
+ * @brief Conditions that end Emulator::Run(), limits are counted from the
+ * start of the run
+ *
+ */
+struct StopConditions {
+  uint64_t max_cycles{UINT64_MAX};
+  uint64_t max_instructions{UINT64_MAX};
+  std::optional<MemAddr> pc;
+  std::optional<MemAddr> sentinel;
+};
+
 class Emulator {
  public:
-  Emulator(){};
+  explicit Emulator(const Device& device = Device::G2553) : debug(device){};
   Emulator(std::string filepath);
   ~Emulator(){};
   void Cycle();
+  EXIT_REASON Run(uint64_t cycles = UINT64_MAX);
+  EXIT_REASON Run(const StopConditions& stop);
+  void SetPacing(PACING mode, double scale = 1.0);
+  void SetOutput(std::ostream* output);
+  void SetTrace(int level);
+  uint64_t GetCycles();
+  uint64_t GetInstructions();
+  Debugger& GetDebugger() { return debug; }
+  std::vector<uint8_t> Capture();
+  void Restore(const std::vector<uint8_t>& image);
+  void SaveSnapshot(Snapshot& snapshot) { debug.SaveSnapshot(snapshot); }
+  void LoadSnapshot(Snapshot& snapshot) { debug.LoadSnapshot(snapshot); }
+
+  static std::string GetExitReasonString(EXIT_REASON reason);
+
+  // Trace levels, each includes the ones below it
+  static constexpr int TRACE_NONE = 0;
+  static constexpr int TRACE_PC = 1;
+  static constexpr int TRACE_INSTRUCTIONS = 2;
 
  private:
   Debugger debug;
+  Pacer pacer;
   std::string filepath;
+  std::ostream* output{&std::cout};
+  int trace{TRACE_NONE};
+  bool sentinel_hit{false};
 };
 
-#endif
\ No newline at end of file
+#endif
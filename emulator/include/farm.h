@@ -0,0 +1,95 @@
+#ifndef farm_h
+#define farm_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "emulator.h"
+
+struct FarmJob {
+  std::string filepath;
+  uint64_t max_cycles{UINT64_MAX};
+  // Called on the loaded instance before it first runs
+  std::function<void(Emulator& emulator)> setup;
+};
+
+struct FarmResult {
+  size_t id{};
+  std::string filepath;
+  EXIT_REASON exit_reason{EXIT_REASON::CYCLE_LIMIT};
+  uint64_t cycles{};
+  std::string output;
+  std::string error;
+  unsigned slices{};
+  // Workers that ran a slice of the job
+  std::set<size_t> workers;
+};
+
+/**
+ * @brief Runs independent emulator instances across a pool of worker threads
+ *
+ * Every worker owns a deque of jobs. A worker runs the job at the front of
+ * its deque for one time slice and requeues it at the back if it isn't done,
+ * so long jobs can't starve short ones. Idle workers steal from the back of
+ * the other deques.
+ */
+class Farm {
+ public:
+  Farm(unsigned workers = std::thread::hardware_concurrency());
+  ~Farm();
+
+  size_t Submit(FarmJob job);
+  std::vector<FarmResult> Wait();
+  unsigned GetWorkers() { return static_cast<unsigned>(threads.size()); }
+
+  static constexpr uint64_t SLICE_CYCLES = 200000;
+
+ private:
+  struct Task {
+    size_t id;
+    FarmJob job;
+    std::unique_ptr<Emulator> emulator;
+    std::ostringstream output;
+    unsigned slices{0};
+    std::set<size_t> workers;
+  };
+
+  struct Worker {
+    std::mutex lock;
+    std::deque<Task*> tasks;
+  };
+
+  void WorkerLoop(size_t index);
+  void Push(size_t index, Task* task);
+  Task* Pop(size_t index);
+  Task* Steal(size_t index);
+  bool RunSlice(size_t index, Task* task, FarmResult& result);
+  void Finish(Task* task, FarmResult result);
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  std::mutex idle_lock;
+  std::condition_variable idle;
+  std::atomic<size_t> queued{0};
+  std::atomic<unsigned> sleeping{0};
+  std::atomic<bool> shutdown{false};
+
+  std::mutex results_lock;
+  std::condition_variable done;
+  std::vector<FarmResult> results;
+  size_t submitted{0};
+  size_t next_worker{0};
+};
+
+#endif
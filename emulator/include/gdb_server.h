@@ -0,0 +1,79 @@
+#ifndef gdb_server_h
+#define gdb_server_h
+
+#include <exception>
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "debugger.h"
+
+/**
+ * @brief GDB remote serial protocol stub for a Debugger
+ *
+ * Listens on a TCP port on the loopback interface, or on a Unix domain
+ * socket when given a path, and serves one client at a time:
+ *
+ *   g G p P           registers from R0, 32 bit little endian like
+ *                     msp430-elf-gdb expects
+ *   m M X             memory, read and written without side effects
+ *   Z0-Z1 z0-z1       breakpoints
+ *   Z2-Z4 z2-z4       write, read and access watchpoints
+ *   c s               continue and step, optionally from an address
+ *   bc bs             continue and step backwards while recording
+ *   ? k D             stop reason, kill and detach
+ *   qRcmd             monitor commands: history, dump ADDR [SIZE]
+ *
+ * Continue runs the full speed loop POLL_STEPS instructions at a time and
+ * checks the connection for an interrupt (0x03) in between.
+ */
+class GdbServer {
+ public:
+  GdbServer(Debugger& debug) : debug(debug){};
+  ~GdbServer();
+
+  void Listen(const std::string& address);
+  int Accept();
+  bool Serve(int fd);
+  std::string Handle(const std::string& packet);
+
+  static constexpr uint64_t POLL_STEPS = 4096;
+  static constexpr size_t PACKET_SIZE = 4096;
+  static constexpr int REGISTERS = 16;
+  static constexpr size_t REGISTER_SIZE = 4;
+
+ private:
+  bool ReadPacket(std::string& packet);
+  bool SendPacket(const std::string& data);
+  bool Interrupted();
+  std::string Resume(const std::string& args, bool step);
+  std::string Reverse(bool step);
+  std::string StopReply(STOP_REASON reason);
+  std::string ReadMemory(const std::string& args);
+  std::string WriteMemory(const std::string& args, bool binary);
+  std::string SetStop(const std::string& args, bool insert);
+  std::string Monitor(const std::string& args);
+  void Modified();
+
+  Debugger& debug;
+  std::string path;
+  int listen_fd{-1};
+  int client_fd{-1};
+  std::string pending;
+  bool ack{true};
+  bool attached{false};
+  bool killed{false};
+  // Watchpoint ids by type, address and length
+  std::map<std::tuple<char, MemAddr, uint32_t>, int> watch_ids;
+};
+
+class GdbException : public std::exception {
+  std::string _msg;
+
+ public:
+  GdbException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
+};
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef json_h
+#define json_h
+
+#include <string>
+
+std::string JsonString(const std::string& val);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef pacer_h
+#define pacer_h
+
+#include <chrono>
+#include <cstdint>
+
+enum class PACING { MAX_SPEED, REAL_TIME, SCALED };
+
+/**
+ * @brief Ties virtual CPU cycles to the wall clock
+ *
+ * The run loop compares the cycle counter against NextPace() and calls Pace()
+ * once per batch. Sleeps target an absolute deadline computed from the anchor
+ * point, so oversleeping in one batch is paid back in the next one.
+ */
+class Pacer {
+ public:
+  typedef std::chrono::steady_clock clock_type;
+
+  Pacer(){};
+  ~Pacer(){};
+
+  void SetMode(PACING mode, double scale = 1.0);
+  PACING GetMode() { return mode; }
+  double GetScale() { return scale; }
+  void Start(uint64_t cycles, uint32_t frequency);
+  void Pace(uint64_t cycles, uint32_t frequency);
+  uint64_t NextPace() { return next_pace; }
+
+  // Virtual time covered by one batch of cycles
+  static constexpr std::chrono::milliseconds BATCH{1};
+  // Falling further behind than this re-anchors instead of catching up
+  static constexpr std::chrono::milliseconds MAX_DRIFT{100};
+
+ private:
+  PACING mode{PACING::MAX_SPEED};
+  double scale{1.0};
+  uint32_t frequency{};
+  uint64_t anchor_cycles{};
+  clock_type::time_point anchor_time{};
+  double ns_per_cycle{};
+  uint64_t batch_cycles{};
+  uint64_t next_pace{UINT64_MAX};
+};
+
+#endif
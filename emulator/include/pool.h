@@ -0,0 +1,64 @@
+#ifndef pool_h
+#define pool_h
+
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+
+struct PoolInstance {
+  Emulator emulator;
+  std::ostringstream output;
+};
+
+/**
+ * @brief Keeps loaded, reset emulator instances per firmware image
+ *
+ * Each firmware is parsed once, the memory image after loading is kept and
+ * instances are recycled by restoring that image rather than reconstructing
+ * and reloading them. At most MAX_IDLE instances are kept idle across all
+ * firmware, Load() refuses to go past it and Release() drops the rest.
+ */
+class Pool {
+ public:
+  Pool(){};
+  ~Pool(){};
+
+  void Load(const std::string& filepath, size_t count);
+  std::unique_ptr<PoolInstance> Acquire(const std::string& filepath);
+  void Release(const std::string& filepath,
+               std::unique_ptr<PoolInstance> instance);
+  size_t GetIdle(const std::string& filepath);
+
+  static constexpr size_t MAX_IDLE = 256;
+
+ private:
+  struct Image {
+    std::vector<uint8_t> memory;
+    std::vector<std::unique_ptr<PoolInstance>> idle;
+  };
+
+  Image* GetImage(const std::string& filepath);
+  std::unique_ptr<PoolInstance> Create(const Image* image);
+
+  std::mutex lock;
+  std::map<std::string, std::unique_ptr<Image>> images;
+  size_t idle_count{0};
+};
+
+class PoolException : public std::exception {
+  std::string _msg;
+
+ public:
+  PoolException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef serial_h
+#define serial_h
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "uart.h"
+
+/**
+ * @brief Host end of the UART, moves bytes between the ring buffers and a
+ * file descriptor on its own thread
+ *
+ * The emulation thread never makes a syscall for serial I/O. Output is
+ * written in batches of whatever has built up since the last pass, input
+ * is read as far as the rx ring buffer has room.
+ */
+class SerialHost {
+ public:
+  SerialHost(Uart* uart) : uart(uart){};
+  ~SerialHost();
+
+  void Open(const std::string& spec);
+  void Start();
+  void Stop();
+  bool Flush();
+  std::string GetPtyName() { return pty_name; }
+
+  // Sleep between passes that found nothing to move
+  static constexpr std::chrono::milliseconds INTERVAL{1};
+
+ private:
+  void Close();
+  void WriteAll(const uint8_t* data, size_t size);
+
+  Uart* uart;
+  int out_fd{-1};
+  int in_fd{-1};
+  bool own_fd{false};
+  std::string pty_name;
+  std::thread thread;
+  std::atomic<bool> running{false};
+};
+
+class SerialException : public std::exception {
+  std::string _msg;
+
+ public:
+  SerialException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef server_h
+#define server_h
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pool.h"
+
+/**
+ * @brief Serves emulator jobs from a Pool over a local Unix domain socket
+ *
+ * Requests and responses are one line each, responses are JSON objects.
+ *
+ *   ping
+ *   load <firmware> [count]
+ *   run <firmware> [cycles=N] [instructions=N] [pc=ADDR] [write=ADDR]
+ *                  [set=ADDR:BYTE]... [read=ADDR:LEN]...
+ *
+ * A run takes an instance from the pool, applies the set= inputs, runs until
+ * a stop condition, reports the registers, output and read= ranges and then
+ * hands the instance back to be reset.
+ */
+class PoolServer {
+ public:
+  PoolServer(Pool& pool) : pool(pool){};
+  ~PoolServer();
+
+  void Listen(const std::string& path);
+  void Serve();
+  void Interrupt();
+  void Stop();
+  std::string Handle(const std::string& request);
+
+ private:
+  void Connection(int fd);
+  std::string Run(const std::vector<std::string>& args);
+
+  Pool& pool;
+  std::string path;
+  int listen_fd{-1};
+  std::atomic<bool> stopping{false};
+  std::mutex clients_lock;
+  std::vector<int> clients;
+  std::vector<std::thread> threads;
+  // Connection threads that have returned and can be joined
+  std::vector<std::thread::id> done;
+};
+
+class ServerException : public std::exception {
+  std::string _msg;
+
+ public:
+  ServerException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "async_debugger.h"
+
+AsyncDebugger::~AsyncDebugger() { Stop(); }
+
+/**
+ * @brief Start the emulation thread, paused
+ *
+ */
+void AsyncDebugger::Start() {
+  if (active.exchange(true)) {
+    return;
+  }
+  thread = std::thread([this]() { Loop(); });
+}
+
+/**
+ * @brief End the emulation thread once it has worked through the commands
+ * sent before this
+ *
+ */
+void AsyncDebugger::Stop() {
+  if (!active.exchange(false)) {
+    return;
+  }
+  Send({COMMAND::QUIT, 0, nullptr});
+  thread.join();
+  running.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Run until a breakpoint or watchpoint, a fault, a pause or the given
+ * number of steps
+ *
+ */
+void AsyncDebugger::Resume(uint64_t steps) {
+  Send({COMMAND::RESUME, steps, nullptr});
+}
+
+void AsyncDebugger::Pause() { Send({COMMAND::PAUSE, 0, nullptr}); }
+
+void AsyncDebugger::SetBreakpoint(MemAddr addr) {
+  Send({COMMAND::SET_BREAKPOINT, addr, nullptr});
+}
+
+void AsyncDebugger::ClearBreakpoint(MemAddr addr) {
+  Send({COMMAND::CLEAR_BREAKPOINT, addr, nullptr});
+}
+
+bool AsyncDebugger::WaitEvent(DebugEvent& event,
+                              std::chrono::milliseconds timeout) {
+  auto end = std::chrono::steady_clock::now() + timeout;
+  while (!events.Pop(event)) {
+    if (std::chrono::steady_clock::now() >= end) {
+      return false;
+    }
+    std::this_thread::sleep_for(INTERVAL);
+  }
+  return true;
+}
+
+/**
+ * @brief Queue a command, waiting for room if the emulation thread is
+ * behind
+ *
+ */
+void AsyncDebugger::Send(const DebugCommand& command) {
+  while (!commands.Push(command)) {
+    std::this_thread::yield();
+  }
+}
+
+void AsyncDebugger::Loop() {
+  DebugCommand command;
+  while (true) {
+    while (commands.Pop(command)) {
+      if (!Execute(command)) {
+        return;
+      }
+    }
+    if (remaining == 0) {
+      std::this_thread::sleep_for(INTERVAL);
+      continue;
+    }
+
+    auto steps = std::min(remaining, BLOCK_STEPS);
+    try {
+      auto reason = debug.Continue(steps);
+      if (reason != STOP_REASON::STEP_LIMIT) {
+        remaining = 0;
+        Post(EVENT::STOPPED, reason);
+      } else if (remaining != UINT64_MAX && (remaining -= steps) == 0) {
+        Post(EVENT::STOPPED, reason);
+      }
+    } catch (std::exception& e) {
+      remaining = 0;
+      Post(EVENT::FAULT, STOP_REASON::STEP_LIMIT, e.what());
+    }
+  }
+}
+
+/**
+ * @brief Carry out a command on the emulation thread, false for QUIT
+ *
+ */
+bool AsyncDebugger::Execute(DebugCommand& command) {
+  switch (command.type) {
+    case COMMAND::RESUME:
+      remaining = command.arg;
+      running.store(remaining != 0, std::memory_order_release);
+      break;
+    case COMMAND::PAUSE:
+      if (remaining != 0) {
+        remaining = 0;
+        Post(EVENT::PAUSED, STOP_REASON::STEP_LIMIT);
+      }
+      break;
+    case COMMAND::SET_BREAKPOINT:
+      debug.SetBreakpoint(command.arg);
+      break;
+    case COMMAND::CLEAR_BREAKPOINT:
+      debug.ClearBreakpoint(command.arg);
+      break;
+    case COMMAND::CALL:
+      command.call(debug);
+      break;
+    case COMMAND::QUIT:
+      return false;
+  }
+  return true;
+}
+
+void AsyncDebugger::Post(EVENT type, STOP_REASON reason,
+                         const std::string& error) {
+  running.store(false, std::memory_order_release);
+  events.Push({type, reason, debug.GetPC(), debug.proc.cycles, error});
+}
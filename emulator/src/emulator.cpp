@@ -7,18 +7,157 @@ Emulator::Emulator(std::string filepath) {
   this->debug.LoadMem(this->filepath);
 }
 
-int main() {
-  try {
-    Emulator emulator(
-        "/home/dovetailz/workspace_v12/Blinker/Debug/Blinker.out");
+void Emulator::SetPacing(PACING mode, double scale) {
+  pacer.SetMode(mode, scale);
+}
+
+void Emulator::SetOutput(std::ostream* output) {
+  this->output = output;
+  debug.p1.SetOutput(output);
+  debug.p2.SetOutput(output);
+  debug.proc.trace = output;
+}
+
+void Emulator::SetTrace(int level) {
+  trace = level;
+  debug.proc.step = (level >= TRACE_INSTRUCTIONS);
+}
+
+uint64_t Emulator::GetCycles() { return debug.proc.cycles; }
+
+uint64_t Emulator::GetInstructions() { return debug.proc.instructions; }
+
+/**
+ * @brief Copy of the whole address space, for a later Restore()
+ *
+ */
+std::vector<uint8_t> Emulator::Capture() {
+  std::vector<uint8_t> image(Memory::MEM_SIZE);
+  debug.mem.ReadBlock(0, image.data(), image.size());
+  return image;
+}
+
+/**
+ * @brief Put the instance back into its power-on state with the given memory
+ * image, much cheaper than constructing and loading a new one
+ *
+ */
+void Emulator::Restore(const std::vector<uint8_t>& image) {
+  debug.mem.WriteBlock(0, image.data(), image.size());
+  for (auto& reg : debug.proc.register_map) {
+    *reg.second = 0;
+  }
+  debug.proc.current_instruction = 0;
+  debug.proc.cycles = 0;
+  debug.proc.instructions = 0;
+  debug.proc.history.Clear();
+  debug.clock.ResetTime();
+  debug.uart.GetTxBuffer().Clear();
+  debug.uart.GetRxBuffer().Clear();
+  debug.Reset();
+}
+
+std::string Emulator::GetExitReasonString(EXIT_REASON reason) {
+  switch (reason) {
+    case EXIT_REASON::CYCLE_LIMIT:
+      return "cycle_limit";
+    case EXIT_REASON::INSTRUCTION_LIMIT:
+      return "instruction_limit";
+    case EXIT_REASON::PC_REACHED:
+      return "pc_reached";
+    case EXIT_REASON::SENTINEL_WRITE:
+      return "sentinel_write";
+    case EXIT_REASON::KILLED:
+      return "killed";
+    case EXIT_REASON::FAULT:
+      return "fault";
+  }
+  return "unknown";
+}
+
+static uint64_t Deadline(uint64_t now, uint64_t budget) {
+  return (budget > UINT64_MAX - now) ? UINT64_MAX : now + budget;
+}
+
+/**
+ * @brief Run without stopping for input until at least the given number of
+ * cycles have elapsed, paced according to the pacing mode
+ *
+ */
+EXIT_REASON Emulator::Run(uint64_t cycles) {
+  StopConditions stop;
+  stop.max_cycles = cycles;
+  return Run(stop);
+}
+
+/**
+ * @brief Run until one of the stop conditions is met. Faults are thrown as
+ * exceptions.
+ *
+ */
+EXIT_REASON Emulator::Run(const StopConditions& stop) {
+  constexpr uint32_t NO_PC = 0x10000;
 
+  auto& proc = debug.proc;
+  auto cycle_end = Deadline(proc.cycles, stop.max_cycles);
+  auto instruction_end = Deadline(proc.instructions, stop.max_instructions);
+  uint32_t stop_pc = stop.pc.has_value() ? stop.pc.value() : NO_PC;
+
+  // The sentinel goes in front of any hook already on the address, which is
+  // put back however the run ends
+  sentinel_hit = false;
+  WriteHook previous;
+  if (stop.sentinel.has_value()) {
+    previous = debug.mem.GetWriteHook(stop.sentinel.value());
+    debug.mem.SetWriteHook(stop.sentinel.value(),
+                           [this, previous](MemAddr addr, uint8_t val) {
+                             if (previous) {
+                               previous(addr, val);
+                             }
+                             sentinel_hit = true;
+                           });
+  }
+
+  auto reason = EXIT_REASON::CYCLE_LIMIT;
+  pacer.Start(proc.cycles, debug.clock.GetFrequency(CLOCK::MCLK));
+  try {
     while (true) {
-      emulator.Cycle();
+      if (proc.cycles >= cycle_end) {
+        reason = EXIT_REASON::CYCLE_LIMIT;
+        break;
+      }
+      if (proc.instructions >= instruction_end) {
+        reason = EXIT_REASON::INSTRUCTION_LIMIT;
+        break;
+      }
+      if (trace != TRACE_NONE) {
+        *output << "PC: 0x" << std::hex << std::setfill('0') << std::setw(4)
+                << *proc.PC << std::dec << std::endl;
+      }
+
+      proc.Step();
+
+      if (*proc.PC == stop_pc) {
+        reason = EXIT_REASON::PC_REACHED;
+        break;
+      }
+      if (sentinel_hit) {
+        reason = EXIT_REASON::SENTINEL_WRITE;
+        break;
+      }
+      if (proc.cycles >= pacer.NextPace()) {
+        pacer.Pace(proc.cycles, debug.clock.GetFrequency(CLOCK::MCLK));
+      }
     }
-  } catch (std::exception& e) {
-    // Handle standard exceptions
-    std::cerr << "Standard exception: " << e.what() << std::endl;
+  } catch (...) {
+    if (stop.sentinel.has_value()) {
+      debug.mem.SetWriteHook(stop.sentinel.value(), previous);
+    }
+    throw;
   }
 
-  return 0;
-}
\ No newline at end of file
+  if (stop.sentinel.has_value()) {
+    debug.mem.SetWriteHook(stop.sentinel.value(), previous);
+  }
+  return reason;
+}
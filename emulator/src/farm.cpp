@@ -0,0 +1,187 @@
+#include "farm.h"
+
+#include <algorithm>
+
+Farm::Farm(unsigned workers) {
+  if (workers == 0) {
+    workers = 1;
+  }
+  for (unsigned x = 0; x < workers; x++) {
+    this->workers.push_back(std::make_unique<Worker>());
+  }
+  for (unsigned x = 0; x < workers; x++) {
+    threads.emplace_back(&Farm::WorkerLoop, this, x);
+  }
+}
+
+Farm::~Farm() {
+  {
+    std::lock_guard<std::mutex> lock(idle_lock);
+    shutdown = true;
+  }
+  idle.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& worker : workers) {
+    for (auto task : worker->tasks) {
+      delete task;
+    }
+  }
+}
+
+size_t Farm::Submit(FarmJob job) {
+  size_t id;
+  size_t index;
+  {
+    std::lock_guard<std::mutex> lock(results_lock);
+    id = submitted++;
+    index = next_worker++ % workers.size();
+  }
+
+  auto task = new Task();
+  task->id = id;
+  task->job = std::move(job);
+  Push(index, task);
+  return id;
+}
+
+/**
+ * @brief Block until every submitted job has finished and hand back the
+ * results ordered by job id
+ *
+ */
+std::vector<FarmResult> Farm::Wait() {
+  std::unique_lock<std::mutex> lock(results_lock);
+  done.wait(lock, [this] { return results.size() == submitted; });
+
+  std::vector<FarmResult> finished;
+  finished.swap(results);
+  submitted = 0;
+  std::sort(finished.begin(), finished.end(),
+            [](const FarmResult& a, const FarmResult& b) { return a.id < b.id; });
+  return finished;
+}
+
+void Farm::Push(size_t index, Task* task) {
+  {
+    std::lock_guard<std::mutex> lock(workers[index]->lock);
+    workers[index]->tasks.push_back(task);
+  }
+  queued++;
+
+  if (sleeping > 0) {
+    { std::lock_guard<std::mutex> lock(idle_lock); }
+    idle.notify_one();
+  }
+}
+
+Farm::Task* Farm::Pop(size_t index) {
+  std::lock_guard<std::mutex> lock(workers[index]->lock);
+  auto& tasks = workers[index]->tasks;
+  if (tasks.empty()) {
+    return nullptr;
+  }
+  auto task = tasks.front();
+  tasks.pop_front();
+  queued--;
+  return task;
+}
+
+Farm::Task* Farm::Steal(size_t index) {
+  for (size_t x = 1; x < workers.size(); x++) {
+    auto& victim = *workers[(index + x) % workers.size()];
+    std::lock_guard<std::mutex> lock(victim.lock);
+    if (victim.tasks.empty()) {
+      continue;
+    }
+    auto task = victim.tasks.back();
+    victim.tasks.pop_back();
+    queued--;
+    return task;
+  }
+  return nullptr;
+}
+
+void Farm::WorkerLoop(size_t index) {
+  while (!shutdown) {
+    auto task = Pop(index);
+    if (task == nullptr) {
+      task = Steal(index);
+    }
+
+    if (task == nullptr) {
+      std::unique_lock<std::mutex> lock(idle_lock);
+      if (shutdown) {
+        return;
+      }
+      sleeping++;
+      idle.wait(lock, [this] { return shutdown || queued > 0; });
+      sleeping--;
+      continue;
+    }
+
+    FarmResult result;
+    if (shutdown) {
+      Push(index, task);
+      return;
+    }
+    if (RunSlice(index, task, result)) {
+      Finish(task, std::move(result));
+    } else {
+      Push(index, task);
+    }
+  }
+}
+
+/**
+ * @brief Run a job for one time slice on worker index
+ *
+ * @return true if the job is finished and result has been filled in
+ */
+bool Farm::RunSlice(size_t index, Task* task, FarmResult& result) {
+  result.id = task->id;
+  result.filepath = task->job.filepath;
+  task->slices++;
+  task->workers.insert(index);
+
+  try {
+    if (!task->emulator) {
+      task->emulator = std::make_unique<Emulator>(task->job.filepath);
+      task->emulator->SetOutput(&task->output);
+      if (task->job.setup) {
+        task->job.setup(*task->emulator);
+      }
+    }
+
+    auto emulator = task->emulator.get();
+    auto remaining = task->job.max_cycles - emulator->GetCycles();
+    emulator->Run(std::min(remaining, SLICE_CYCLES));
+
+    if (emulator->GetCycles() < task->job.max_cycles) {
+      return false;
+    }
+    result.exit_reason = EXIT_REASON::CYCLE_LIMIT;
+  } catch (std::exception& e) {
+    result.exit_reason = EXIT_REASON::FAULT;
+    result.error = e.what();
+  }
+
+  if (task->emulator) {
+    result.cycles = task->emulator->GetCycles();
+  }
+  result.output = task->output.str();
+  result.slices = task->slices;
+  result.workers = task->workers;
+  return true;
+}
+
+void Farm::Finish(Task* task, FarmResult result) {
+  delete task;
+
+  std::lock_guard<std::mutex> lock(results_lock);
+  results.push_back(std::move(result));
+  if (results.size() == submitted) {
+    done.notify_all();
+  }
+}
@@ -0,0 +1,627 @@
+#include "gdb_server.h"
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+constexpr char INTERRUPT = 0x03;
+constexpr char ESCAPE = 0x7d;
+
+int HexDigit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  throw GdbException(std::string("invalid hex digit: ") + c);
+}
+
+uint32_t ParseHex(const std::string& val) {
+  if (val.empty() || val.size() > 8) {
+    throw GdbException("invalid hex number: " + val);
+  }
+  uint32_t number = 0;
+  for (auto c : val) {
+    number = (number << 4) | HexDigit(c);
+  }
+  return number;
+}
+
+MemAddr ParseAddress(const std::string& val) {
+  auto addr = ParseHex(val);
+  if (addr >= Memory::MEM_SIZE) {
+    throw GdbException("address out of range: " + val);
+  }
+  return static_cast<MemAddr>(addr);
+}
+
+void AppendHex(std::string& out, uint8_t val) {
+  out += HEX_DIGITS[val >> 4];
+  out += HEX_DIGITS[val & 0xF];
+}
+
+// msp430-elf-gdb's raw registers are 32 bits wide for the MSP430X, the
+// upper half is always zero here and ignored when written
+void AppendRegister(std::string& out, uint16_t val) {
+  AppendHex(out, val & 0xFF);
+  AppendHex(out, val >> 8);
+  AppendHex(out, 0);
+  AppendHex(out, 0);
+}
+
+std::vector<uint8_t> DecodeHex(const std::string& hex) {
+  if (hex.size() % 2) {
+    throw GdbException("odd length hex data");
+  }
+  std::vector<uint8_t> data(hex.size() / 2);
+  for (size_t x = 0; x < data.size(); x++) {
+    data[x] = (HexDigit(hex[2 * x]) << 4) | HexDigit(hex[2 * x + 1]);
+  }
+  return data;
+}
+
+std::vector<uint8_t> DecodeBinary(const std::string& binary) {
+  std::vector<uint8_t> data;
+  data.reserve(binary.size());
+  for (size_t x = 0; x < binary.size(); x++) {
+    if (binary[x] == ESCAPE && x + 1 < binary.size()) {
+      data.push_back(binary[++x] ^ 0x20);
+    } else {
+      data.push_back(binary[x]);
+    }
+  }
+  return data;
+}
+
+/**
+ * @brief Split "ADDR,LEN" into an address and a length that stays within
+ * memory
+ *
+ */
+std::pair<MemAddr, uint32_t> ParseRange(const std::string& val) {
+  auto comma = val.find(',');
+  if (comma == std::string::npos) {
+    throw GdbException("expected ADDR,LEN: " + val);
+  }
+  auto addr = ParseAddress(val.substr(0, comma));
+  auto size = ParseHex(val.substr(comma + 1));
+  return {addr, std::min<uint32_t>(size, Memory::MEM_SIZE - addr)};
+}
+
+bool SendAll(int fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    auto count =
+        send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    sent += count;
+  }
+  return true;
+}
+
+}  // namespace
+
+GdbServer::~GdbServer() {
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    if (!path.empty()) {
+      unlink(path.c_str());
+    }
+  }
+}
+
+/**
+ * @brief Listen on a TCP port given as "PORT" or ":PORT", anything else is
+ * the path of a Unix domain socket
+ *
+ */
+void GdbServer::Listen(const std::string& address) {
+  auto port = (address.rfind(':', 0) == 0) ? address.substr(1) : address;
+  bool tcp =
+      !port.empty() && std::all_of(port.begin(), port.end(), ::isdigit);
+
+  sockaddr_storage storage{};
+  socklen_t size;
+  if (tcp) {
+    auto number = std::stoul(port);
+    if (number > 0xFFFF) {
+      throw GdbException("invalid port: " + address);
+    }
+    auto addr = reinterpret_cast<sockaddr_in*>(&storage);
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(number);
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    size = sizeof(sockaddr_in);
+  } else {
+    auto addr = reinterpret_cast<sockaddr_un*>(&storage);
+    if (address.size() >= sizeof(addr->sun_path)) {
+      throw GdbException("socket path too long: " + address);
+    }
+    addr->sun_family = AF_UNIX;
+    std::copy(address.begin(), address.end(), addr->sun_path);
+    size = sizeof(sockaddr_un);
+    unlink(address.c_str());
+  }
+
+  listen_fd = socket(storage.ss_family, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    throw GdbException(std::string("socket: ") + strerror(errno));
+  }
+  int reuse = 1;
+  if (tcp) {
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  }
+  if (bind(listen_fd, reinterpret_cast<sockaddr*>(&storage), size) < 0 ||
+      listen(listen_fd, 1) < 0) {
+    auto error = std::string("bind: ") + strerror(errno);
+    close(listen_fd);
+    listen_fd = -1;
+    throw GdbException(error);
+  }
+  if (!tcp) {
+    path = address;
+  }
+}
+
+/**
+ * @brief Wait for a debugger to connect
+ *
+ */
+int GdbServer::Accept() {
+  while (true) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd >= 0) {
+      return fd;
+    }
+    if (errno != EINTR) {
+      throw GdbException(std::string("accept: ") + strerror(errno));
+    }
+  }
+}
+
+/**
+ * @brief Serve packets on a connection until the client detaches, kills the
+ * target or goes away. Returns false if the target was killed.
+ *
+ */
+bool GdbServer::Serve(int fd) {
+  client_fd = fd;
+  pending.clear();
+  ack = true;
+  attached = true;
+  killed = false;
+
+  std::string packet;
+  while (attached && ReadPacket(packet)) {
+    auto reply = Handle(packet);
+    if (killed) {
+      break;
+    }
+    if (!SendPacket(reply)) {
+      break;
+    }
+  }
+
+  close(fd);
+  client_fd = -1;
+  return !killed;
+}
+
+/**
+ * @brief Next packet from the client with the framing and checksum removed,
+ * an interrupt is returned as a packet of its own
+ *
+ */
+bool GdbServer::ReadPacket(std::string& packet) {
+  char buffer[PACKET_SIZE];
+  while (true) {
+    while (!pending.empty()) {
+      auto c = pending[0];
+      if (c == INTERRUPT) {
+        pending.erase(0, 1);
+        packet.assign(1, INTERRUPT);
+        return true;
+      }
+      if (c != '$') {
+        // Acks and line noise
+        pending.erase(0, 1);
+        continue;
+      }
+      auto hash = pending.find('#');
+      if (hash == std::string::npos || pending.size() < hash + 3) {
+        break;
+      }
+
+      auto body = pending.substr(1, hash - 1);
+      auto checksum = pending.substr(hash + 1, 2);
+      pending.erase(0, hash + 3);
+      uint8_t sum = 0;
+      for (auto c : body) {
+        sum += c;
+      }
+      bool valid = isxdigit(checksum[0]) && isxdigit(checksum[1]) &&
+                   ParseHex(checksum) == sum;
+      if (ack && !SendAll(client_fd, valid ? "+" : "-")) {
+        return false;
+      }
+      if (valid || !ack) {
+        packet = body;
+        return true;
+      }
+    }
+
+    auto count = recv(client_fd, buffer, sizeof(buffer), 0);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    pending.append(buffer, count);
+  }
+}
+
+bool GdbServer::SendPacket(const std::string& data) {
+  std::string packet;
+  packet.reserve(data.size() + 4);
+  packet += '$';
+  uint8_t sum = 0;
+  for (auto c : data) {
+    packet += c;
+    sum += c;
+  }
+  packet += '#';
+  AppendHex(packet, sum);
+  return SendAll(client_fd, packet);
+}
+
+/**
+ * @brief Check the connection for an interrupt without blocking, a client
+ * that went away interrupts as well
+ *
+ */
+bool GdbServer::Interrupted() {
+  if (client_fd < 0) {
+    return false;
+  }
+  pollfd poll_fd{client_fd, POLLIN, 0};
+  while (poll(&poll_fd, 1, 0) > 0) {
+    char buffer[PACKET_SIZE];
+    auto count = recv(client_fd, buffer, sizeof(buffer), 0);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return true;
+    }
+    pending.append(buffer, count);
+  }
+
+  auto interrupt = pending.find(INTERRUPT);
+  if (interrupt == std::string::npos) {
+    return false;
+  }
+  pending.erase(interrupt, 1);
+  return true;
+}
+
+/**
+ * @brief Execute a single packet and build its reply, unsupported packets
+ * get the empty reply
+ *
+ */
+std::string GdbServer::Handle(const std::string& packet) {
+  if (packet.empty()) {
+    return "";
+  }
+  auto args = packet.substr(1);
+  try {
+    switch (packet[0]) {
+      case INTERRUPT:
+      case '?':
+        return "S05";
+      case 'g': {
+        std::string reply;
+        for (uint16_t reg = 0; reg < REGISTERS; reg++) {
+          AppendRegister(reply, debug.GetRegister(reg));
+        }
+        return reply;
+      }
+      case 'G': {
+        auto data = DecodeHex(args);
+        if (data.size() != REGISTER_SIZE * REGISTERS) {
+          return "E01";
+        }
+        for (uint16_t reg = 0; reg < REGISTERS; reg++) {
+          auto val = &data[REGISTER_SIZE * reg];
+          debug.proc.WriteToRegister(reg, val[0] | (val[1] << 8), false);
+        }
+        Modified();
+        return "OK";
+      }
+      case 'p': {
+        auto reg = ParseHex(args);
+        if (reg >= REGISTERS) {
+          return "E01";
+        }
+        std::string reply;
+        AppendRegister(reply, debug.GetRegister(reg));
+        return reply;
+      }
+      case 'P': {
+        auto equals = args.find('=');
+        if (equals == std::string::npos) {
+          return "E01";
+        }
+        auto reg = ParseHex(args.substr(0, equals));
+        auto data = DecodeHex(args.substr(equals + 1));
+        if (reg >= REGISTERS || data.size() != REGISTER_SIZE) {
+          return "E01";
+        }
+        debug.proc.WriteToRegister(reg, data[0] | (data[1] << 8), false);
+        Modified();
+        return "OK";
+      }
+      case 'm':
+        return ReadMemory(args);
+      case 'M':
+        return WriteMemory(args, false);
+      case 'X':
+        return WriteMemory(args, true);
+      case 'c':
+        return Resume(args, false);
+      case 's':
+        return Resume(args, true);
+      case 'b':
+        if (args == "s" || args == "c") {
+          return Reverse(args == "s");
+        }
+        return "";
+      case 'Z':
+        return SetStop(args, true);
+      case 'z':
+        return SetStop(args, false);
+      case 'H':
+        return "OK";
+      case 'k':
+        killed = true;
+        attached = false;
+        return "OK";
+      case 'D':
+        attached = false;
+        return "OK";
+      case 'q':
+        if (args.rfind("Supported", 0) == 0) {
+          char reply[80];
+          snprintf(reply, sizeof(reply),
+                   "PacketSize=%zx;QStartNoAckMode+;ReverseStep+;"
+                   "ReverseContinue+",
+                   PACKET_SIZE);
+          return reply;
+        }
+        if (args == "Attached") {
+          return "1";
+        }
+        if (args == "C") {
+          return "QC1";
+        }
+        if (args.rfind("Rcmd,", 0) == 0) {
+          return Monitor(args.substr(5));
+        }
+        return "";
+      case 'Q':
+        if (args == "StartNoAckMode") {
+          ack = false;
+          return "OK";
+        }
+        return "";
+    }
+  } catch (GdbException& e) {
+    return "E01";
+  } catch (MemoryException& e) {
+    return "E14";
+  }
+  return "";
+}
+
+/**
+ * @brief Continue or step, from an address if one is given, and report why
+ * execution stopped
+ *
+ */
+std::string GdbServer::Resume(const std::string& args, bool step) {
+  if (!args.empty()) {
+    debug.proc.WriteToRegister(0, ParseAddress(args), false);
+    Modified();
+  }
+
+  STOP_REASON reason;
+  try {
+    if (step) {
+      reason = debug.Continue(1);
+    } else {
+      // Full speed in between looking for an interrupt
+      while ((reason = debug.Continue(POLL_STEPS)) ==
+             STOP_REASON::STEP_LIMIT) {
+        if (Interrupted()) {
+          return "S02";
+        }
+      }
+    }
+  } catch (std::exception& e) {
+    // Undefined instructions and other faults
+    return "S04";
+  }
+  return StopReply(reason);
+}
+
+/**
+ * @brief Step or continue backwards through the debugger's recording
+ *
+ */
+std::string GdbServer::Reverse(bool step) {
+  if (!debug.IsRecording()) {
+    return "E01";
+  }
+  return StopReply(step ? debug.ReverseStep() : debug.ReverseContinue());
+}
+
+std::string GdbServer::StopReply(STOP_REASON reason) {
+  if (reason == STOP_REASON::HISTORY_START) {
+    return "T05replaylog:begin;";
+  }
+  if (reason != STOP_REASON::WATCHPOINT) {
+    return "S05";
+  }
+  auto& hit = debug.GetWatchHit();
+  std::string kind = hit.write ? "watch" : "rwatch";
+  for (auto& [key, id] : watch_ids) {
+    auto& [type, addr, size] = key;
+    if (type == '4' && hit.addr >= addr && hit.addr < addr + size) {
+      kind = "awatch";
+    }
+  }
+  std::string reply = "T05" + kind + ":";
+  AppendHex(reply, hit.addr >> 8);
+  AppendHex(reply, hit.addr & 0xFF);
+  return reply + ";";
+}
+
+/**
+ * @brief Hex dump of a range, copied out of memory in one go
+ *
+ */
+std::string GdbServer::ReadMemory(const std::string& args) {
+  auto [addr, size] = ParseRange(args);
+  size = std::min<uint32_t>(size, (PACKET_SIZE - 4) / 2);
+  std::vector<uint8_t> data(size);
+  debug.mem.ReadBlock(addr, data.data(), size);
+
+  std::string reply;
+  reply.reserve(2 * size);
+  for (auto val : data) {
+    AppendHex(reply, val);
+  }
+  return reply;
+}
+
+std::string GdbServer::WriteMemory(const std::string& args, bool binary) {
+  auto colon = args.find(':');
+  if (colon == std::string::npos) {
+    return "E01";
+  }
+  auto [addr, size] = ParseRange(args.substr(0, colon));
+  auto payload = args.substr(colon + 1);
+  auto data = binary ? DecodeBinary(payload) : DecodeHex(payload);
+  if (data.size() != size) {
+    return "E01";
+  }
+  debug.mem.WriteBlock(addr, data.data(), size);
+  Modified();
+  return "OK";
+}
+
+/**
+ * @brief "monitor" commands, the hex encoded command in and its output
+ * back the same way
+ *
+ */
+std::string GdbServer::Monitor(const std::string& args) {
+  auto data = DecodeHex(args);
+  std::string command(data.begin(), data.end());
+  std::ostringstream output;
+  std::istringstream words(command);
+  std::string name, addr, size;
+  words >> name >> addr >> size;
+  if (command == "history") {
+    debug.DumpHistory(output);
+  } else if (name == "dump" && !addr.empty()) {
+    try {
+      output << debug.DumpMemory(std::stoul(addr, nullptr, 0),
+                                 size.empty() ? Memory::DUMP_LINE
+                                              : std::stoul(size, nullptr, 0));
+    } catch (std::exception& e) {
+      output << "dump: " << e.what() << "\n";
+    }
+  } else {
+    output << "unknown command: " << command << "\n"
+           << "commands: history, dump ADDR [SIZE]\n";
+  }
+
+  std::string reply;
+  for (auto c : output.str()) {
+    AppendHex(reply, c);
+  }
+  return reply;
+}
+
+/**
+ * @brief A recording can't replay past a change made from outside, history
+ * starts over from the changed state
+ *
+ */
+void GdbServer::Modified() {
+  if (debug.IsRecording()) {
+    debug.StartRecording();
+  }
+}
+
+/**
+ * @brief Insert or remove a breakpoint or watchpoint, "TYPE,ADDR,KIND"
+ *
+ */
+std::string GdbServer::SetStop(const std::string& args, bool insert) {
+  auto fields = args.substr(0, args.find(';'));
+  if (fields.size() < 2 || fields[1] != ',') {
+    return "E01";
+  }
+  auto type = fields[0];
+  auto [addr, size] = ParseRange(fields.substr(2));
+
+  if (type == '0' || type == '1') {
+    if (insert) {
+      debug.SetBreakpoint(addr);
+    } else {
+      debug.ClearBreakpoint(addr);
+    }
+    return "OK";
+  }
+  if (type < '2' || type > '4') {
+    return "";
+  }
+
+  auto key = std::make_tuple(type, addr, size);
+  auto existing = watch_ids.find(key);
+  if (insert && existing == watch_ids.end()) {
+    auto watch = (type == '2') ? WATCH::WRITE
+                 : (type == '3') ? WATCH::READ
+                                 : WATCH::ACCESS;
+    watch_ids[key] = debug.AddWatchpoint(addr, size, watch);
+  } else if (!insert && existing != watch_ids.end()) {
+    debug.RemoveWatchpoint(existing->second);
+    watch_ids.erase(existing);
+  }
+  return "OK";
+}
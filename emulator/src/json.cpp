@@ -0,0 +1,24 @@
+#include "json.h"
+
+#include <cstdio>
+
+/**
+ * @brief Quote and escape a string for use as a JSON value
+ *
+ */
+std::string JsonString(const std::string& val) {
+  std::string escaped = "\"";
+  for (auto ch : val) {
+    if (ch == '"' || ch == '\\') {
+      escaped += '\\';
+      escaped += ch;
+    } else if (static_cast<unsigned char>(ch) < 0x20) {
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+      escaped += buffer;
+    } else {
+      escaped += ch;
+    }
+  }
+  return escaped + "\"";
+}
@@ -0,0 +1,363 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "gdb_server.h"
+#include "json.h"
+#include "read_elf.h"
+#include "serial.h"
+#include "stimulus.h"
+#include "vcd.h"
+
+namespace {
+
+const char* USAGE =
+    "usage: emulator <firmware> [options]\n"
+    "  --cycles N           stop after N cycles\n"
+    "  --instructions N     stop after N instructions\n"
+    "  --until-pc ADDR      stop when the PC reaches ADDR\n"
+    "  --until-symbol NAME  stop when the PC reaches symbol NAME\n"
+    "  --until-write ADDR   stop after a write to ADDR\n"
+    "  --trace LEVEL        0 none, 1 PC, 2 instructions\n"
+    "  --trace-file FILE    write port output and traces to FILE instead of\n"
+    "                       stderr, stdout only carries the summary\n"
+    "  --format FORMAT      json (default) or text\n"
+    "  --pacing MODE        max (default), realtime or a speed multiplier\n"
+    "  --serial PORT        connect the UART to stdio, a new pty or a file,\n"
+    "                       with stdio the summary goes to stderr\n"
+    "  --stimulus FILE      drive port pins from timed changes in FILE\n"
+    "  --vcd FILE           write port pin levels to a VCD file\n"
+    "  --adc CH:HZ:FILE     feed ADC10 channel CH from 16 bit samples at HZ\n"
+    "  --flash FILE         keep flash in FILE across runs\n"
+    "  --device NAME        G2231, G2452 or G2553 (default)\n"
+    "  --snapshot FILE      save the machine state to FILE when the run ends\n"
+    "  --gdb PORT|PATH      wait for GDB on a TCP port or a Unix socket,\n"
+    "                       recording so it can step backwards, then run\n"
+    "                       on after it detaches\n";
+
+class UsageException : public std::exception {
+  std::string _msg;
+
+ public:
+  UsageException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
+};
+
+struct AdcStream {
+  uint8_t channel;
+  uint32_t rate;
+  std::string path;
+};
+
+struct Options {
+  std::string firmware;
+  StopConditions stop;
+  std::string symbol;
+  int trace{Emulator::TRACE_NONE};
+  bool json{true};
+  PACING pacing{PACING::MAX_SPEED};
+  double scale{1.0};
+  std::string serial;
+  std::string stimulus;
+  std::string vcd;
+  std::string trace_file;
+  std::vector<AdcStream> adc;
+  std::string flash;
+  std::string gdb;
+  std::string snapshot;
+  const Device* device{&Device::G2553};
+};
+
+uint64_t ParseNumber(const std::string& option, const std::string& val) {
+  try {
+    size_t end;
+    auto number = std::stoull(val, &end, 0);
+    if (end == val.size()) {
+      return number;
+    }
+  } catch (std::exception&) {
+  }
+  throw UsageException("invalid value for " + option + ": " + val);
+}
+
+MemAddr ParseAddress(const std::string& option, const std::string& val) {
+  auto addr = ParseNumber(option, val);
+  if (addr >= Memory::MEM_SIZE) {
+    throw UsageException("address out of range for " + option + ": " + val);
+  }
+  return static_cast<MemAddr>(addr);
+}
+
+AdcStream ParseAdcStream(const std::string& option, const std::string& val) {
+  auto first = val.find(':');
+  auto second = val.find(':', first + 1);
+  if (first == std::string::npos || second == std::string::npos) {
+    throw UsageException("invalid value for " + option + ": " + val);
+  }
+  auto channel = ParseNumber(option, val.substr(0, first));
+  auto rate = ParseNumber(option, val.substr(first + 1, second - first - 1));
+  if (channel >= Adc10::CHANNELS || rate == 0 || rate > UINT32_MAX) {
+    throw UsageException("invalid value for " + option + ": " + val);
+  }
+  return {static_cast<uint8_t>(channel), static_cast<uint32_t>(rate),
+          val.substr(second + 1)};
+}
+
+Options ParseOptions(const std::vector<std::string>& args) {
+  Options options;
+  for (size_t x = 0; x < args.size(); x++) {
+    auto& arg = args[x];
+    if (arg.rfind("--", 0) != 0) {
+      if (!options.firmware.empty()) {
+        throw UsageException("unexpected argument: " + arg);
+      }
+      options.firmware = arg;
+      continue;
+    }
+    if (x + 1 >= args.size()) {
+      throw UsageException("missing value for " + arg);
+    }
+    auto& val = args[++x];
+
+    if (arg == "--cycles") {
+      options.stop.max_cycles = ParseNumber(arg, val);
+    } else if (arg == "--instructions") {
+      options.stop.max_instructions = ParseNumber(arg, val);
+    } else if (arg == "--until-pc") {
+      options.stop.pc = ParseAddress(arg, val);
+    } else if (arg == "--until-symbol") {
+      options.symbol = val;
+    } else if (arg == "--until-write") {
+      options.stop.sentinel = ParseAddress(arg, val);
+    } else if (arg == "--trace") {
+      options.trace = static_cast<int>(ParseNumber(arg, val));
+    } else if (arg == "--trace-file") {
+      options.trace_file = val;
+    } else if (arg == "--format") {
+      if (val != "json" && val != "text") {
+        throw UsageException("unknown format: " + val);
+      }
+      options.json = (val == "json");
+    } else if (arg == "--pacing") {
+      if (val == "max") {
+        options.pacing = PACING::MAX_SPEED;
+      } else if (val == "realtime") {
+        options.pacing = PACING::REAL_TIME;
+      } else {
+        try {
+          options.scale = std::stod(val);
+        } catch (std::exception&) {
+          throw UsageException("unknown pacing: " + val);
+        }
+        options.pacing = PACING::SCALED;
+      }
+    } else if (arg == "--serial") {
+      options.serial = val;
+    } else if (arg == "--stimulus") {
+      options.stimulus = val;
+    } else if (arg == "--vcd") {
+      options.vcd = val;
+    } else if (arg == "--adc") {
+      options.adc.push_back(ParseAdcStream(arg, val));
+    } else if (arg == "--flash") {
+      options.flash = val;
+    } else if (arg == "--gdb") {
+      options.gdb = val;
+    } else if (arg == "--snapshot") {
+      options.snapshot = val;
+    } else if (arg == "--device") {
+      options.device = Device::Find(val);
+      if (options.device == nullptr) {
+        throw UsageException("unknown device: " + val);
+      }
+    } else {
+      throw UsageException("unknown option: " + arg);
+    }
+  }
+
+  if (options.firmware.empty()) {
+    throw UsageException("no firmware given");
+  }
+  return options;
+}
+
+MemAddr LookupSymbol(const std::string& firmware, const std::string& name) {
+  ElfReader elf_reader(firmware);
+  auto symbols = elf_reader.GetSymbols();
+  if (!symbols.has_value() || symbols.value().count(name) == 0) {
+    throw UsageException("symbol not found: " + name);
+  }
+  return static_cast<MemAddr>(symbols.value().at(name).st_value);
+}
+
+struct Summary {
+  EXIT_REASON reason;
+  std::string error;
+  uint64_t cycles;
+  uint64_t instructions;
+  double seconds;
+  uint16_t registers[16];
+
+  double GetMips() {
+    return (seconds > 0) ? static_cast<double>(instructions) / seconds / 1e6
+                         : 0;
+  }
+};
+
+void PrintJson(const Options& options, Summary& summary, std::ostream& out) {
+  std::ostringstream json;
+  json << "{\"firmware\":" << JsonString(options.firmware)
+       << ",\"exit_reason\":"
+       << JsonString(Emulator::GetExitReasonString(summary.reason))
+       << ",\"error\":"
+       << (summary.error.empty() ? "null" : JsonString(summary.error))
+       << ",\"cycles\":" << summary.cycles
+       << ",\"instructions\":" << summary.instructions
+       << ",\"seconds\":" << summary.seconds
+       << ",\"mips\":" << summary.GetMips() << ",\"registers\":{";
+  for (int reg = 0; reg < 16; reg++) {
+    json << (reg ? "," : "") << "\"r" << reg
+         << "\":" << summary.registers[reg];
+  }
+  json << "}}";
+  out << json.str() << std::endl;
+}
+
+void PrintText(const Options& options, Summary& summary, FILE* out) {
+  fprintf(out, "firmware:     %s\n", options.firmware.c_str());
+  fprintf(out, "exit reason:  %s\n",
+          Emulator::GetExitReasonString(summary.reason).c_str());
+  if (!summary.error.empty()) {
+    fprintf(out, "error:        %s\n", summary.error.c_str());
+  }
+  fprintf(out, "cycles:       %llu\n",
+          static_cast<unsigned long long>(summary.cycles));
+  fprintf(out, "instructions: %llu\n",
+          static_cast<unsigned long long>(summary.instructions));
+  fprintf(out, "seconds:      %f\n", summary.seconds);
+  fprintf(out, "mips:         %f\n", summary.GetMips());
+  for (int reg = 0; reg < 16; reg++) {
+    fprintf(out, "R%-2i: 0x%04x\n", reg, summary.registers[reg]);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = ParseOptions(std::vector<std::string>(argv + 1, argv + argc));
+    if (!options.symbol.empty()) {
+      options.stop.pc = LookupSymbol(options.firmware, options.symbol);
+    }
+  } catch (std::exception& e) {
+    std::cerr << "emulator: " << e.what() << std::endl << USAGE;
+    return 2;
+  }
+
+  Summary summary{};
+  Emulator emulator(*options.device);
+  auto& debug = emulator.GetDebugger();
+  SerialHost serial(&debug.uart);
+  // Only there when used, so plain runs leave snapshots any Debugger loads
+  std::optional<Stimulus> stimulus;
+  VcdWriter vcd;
+  std::ofstream trace_file;
+  emulator.SetOutput(&std::cerr);
+  auto start = std::chrono::steady_clock::now();
+  try {
+    if (!options.trace_file.empty()) {
+      trace_file.open(options.trace_file);
+      if (!trace_file) {
+        throw std::runtime_error("could not open " + options.trace_file);
+      }
+      emulator.SetOutput(&trace_file);
+    }
+    debug.LoadMem(options.firmware);
+    if (!options.flash.empty()) {
+      debug.flash.SetBacking(options.flash);
+    }
+    if (!options.stimulus.empty()) {
+      stimulus.emplace(&debug.proc);
+      stimulus->AddPort(&debug.p1);
+      stimulus->AddPort(&debug.p2);
+      stimulus->Load(options.stimulus);
+    }
+    for (auto& adc : options.adc) {
+      debug.adc.SetStream(adc.channel, std::make_shared<SampleStream>(
+                                           adc.path, adc.rate));
+    }
+    if (!options.vcd.empty()) {
+      vcd.Open(options.vcd);
+      debug.p1.SetTrace(&vcd);
+      debug.p2.SetTrace(&vcd);
+    }
+    emulator.SetPacing(options.pacing, options.scale);
+    emulator.SetTrace(options.trace);
+    if (!options.serial.empty()) {
+      serial.Open(options.serial);
+      if (!serial.GetPtyName().empty()) {
+        std::cerr << "serial: " << serial.GetPtyName() << std::endl;
+      }
+      serial.Start();
+    }
+    start = std::chrono::steady_clock::now();
+    bool resume = true;
+    if (!options.gdb.empty()) {
+      GdbServer gdb(debug);
+      gdb.Listen(options.gdb);
+      std::cerr << "gdb: listening on " << options.gdb << std::endl;
+      debug.StartRecording();
+      resume = gdb.Serve(gdb.Accept());
+      debug.StopRecording();
+    }
+    summary.reason = resume ? emulator.Run(options.stop) : EXIT_REASON::KILLED;
+  } catch (std::exception& e) {
+    summary.reason = EXIT_REASON::FAULT;
+    summary.error = e.what();
+    if (debug.proc.history.GetCount() > 0) {
+      std::cerr << "emulator: " << summary.error << ", ";
+      debug.DumpHistory(std::cerr);
+    }
+  }
+  // Faults included, the state they left is what's worth comparing
+  if (!options.snapshot.empty()) {
+    try {
+      Snapshot snapshot;
+      emulator.SaveSnapshot(snapshot);
+      snapshot.Write(options.snapshot);
+    } catch (std::exception& e) {
+      std::cerr << "emulator: " << e.what() << std::endl;
+    }
+  }
+  serial.Stop();
+  vcd.Close();
+  summary.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+  summary.cycles = emulator.GetCycles();
+  summary.instructions = emulator.GetInstructions();
+  for (uint16_t reg = 0; reg < 16; reg++) {
+    summary.registers[reg] = debug.GetRegister(reg);
+  }
+
+  // Serial output on stdout would corrupt the summary, JSON especially
+  bool serial_stdout = (options.serial == "stdio");
+  if (options.json) {
+    PrintJson(options, summary, serial_stdout ? std::cerr : std::cout);
+  } else {
+    PrintText(options, summary, serial_stdout ? stderr : stdout);
+  }
+
+  return (summary.reason == EXIT_REASON::FAULT) ? 1 : 0;
+}
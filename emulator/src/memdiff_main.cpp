@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "debugger.h"
+#include "memory_diff.h"
+#include "snapshot.h"
+
+namespace {
+
+const char* USAGE =
+    "usage: memdiff <snapshot> <snapshot> [options]\n"
+    "  --elf FILE       name changed ranges with the symbols in FILE\n"
+    "  --gap N          merge ranges at most N equal bytes apart\n"
+    "  --kernel NAME    scalar, sse2, avx2 or best (default)\n"
+    "exits 0 when memory is the same, 1 when it differs and 2 on errors\n";
+
+// Bytes of a range shown before it's cut short
+constexpr uint32_t SHOW_BYTES = 16;
+
+/**
+ * @brief The machine in a snapshot file, on the device it was taken on
+ *
+ */
+std::unique_ptr<Debugger> Open(const std::string& path,
+                               const std::string& elf) {
+  Snapshot snapshot;
+  snapshot.Read(path);
+  auto name = snapshot.GetString();
+  auto device = Device::Find(name);
+  if (device == nullptr) {
+    throw SnapshotException("unknown device " + name + ": " + path);
+  }
+  auto debug = std::make_unique<Debugger>(*device);
+  if (!elf.empty()) {
+    debug->LoadMem(elf);
+  }
+  debug->LoadSnapshot(snapshot);
+  return debug;
+}
+
+void PrintBytes(const char* side, const uint8_t* image, DiffRange range) {
+  printf("  %s", side);
+  for (uint32_t x = 0; x < std::min(range.size, SHOW_BYTES); x++) {
+    printf(" %02x", image[range.addr + x]);
+  }
+  printf("%s\n", range.size > SHOW_BYTES ? " ..." : "");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::vector<std::string> paths;
+  std::string elf;
+  size_t gap = 0;
+  auto kernel = DIFF_KERNEL::BEST;
+
+  try {
+    for (size_t x = 0; x < args.size(); x++) {
+      auto& arg = args[x];
+      if (arg.rfind("--", 0) != 0) {
+        paths.push_back(arg);
+        continue;
+      }
+      if (x + 1 >= args.size()) {
+        throw std::invalid_argument("missing value for " + arg);
+      }
+      auto& val = args[++x];
+      if (arg == "--elf") {
+        elf = val;
+      } else if (arg == "--gap") {
+        gap = std::stoul(val);
+      } else if (arg == "--kernel") {
+        if (val == "scalar") {
+          kernel = DIFF_KERNEL::SCALAR;
+        } else if (val == "sse2") {
+          kernel = DIFF_KERNEL::SSE2;
+        } else if (val == "avx2") {
+          kernel = DIFF_KERNEL::AVX2;
+        } else if (val != "best") {
+          throw std::invalid_argument("unknown kernel: " + val);
+        }
+        if (!IsSupported(kernel)) {
+          throw std::invalid_argument("kernel not supported here: " + val);
+        }
+      } else {
+        throw std::invalid_argument("unknown option: " + arg);
+      }
+    }
+    if (paths.size() != 2) {
+      throw std::invalid_argument("expected two snapshots");
+    }
+  } catch (std::exception& e) {
+    std::cerr << "memdiff: " << e.what() << std::endl << USAGE;
+    return 2;
+  }
+
+  std::unique_ptr<Debugger> machines[2];
+  std::vector<uint8_t> images[2];
+  try {
+    for (int x = 0; x < 2; x++) {
+      machines[x] = Open(paths[x], elf);
+      images[x].resize(Memory::MEM_SIZE);
+      machines[x]->mem.ReadBlock(0, images[x].data(), Memory::MEM_SIZE);
+      printf("%s %s: %s at %llu cycles\n", x ? "+++" : "---",
+             paths[x].c_str(), machines[x]->proc.device->name,
+             static_cast<unsigned long long>(machines[x]->proc.cycles));
+    }
+  } catch (std::exception& e) {
+    std::cerr << "memdiff: " << e.what() << std::endl;
+    return 2;
+  }
+  if (machines[0]->proc.cycles != machines[1]->proc.cycles) {
+    std::cerr << "memdiff: the snapshots were taken at different cycle counts"
+              << std::endl;
+  }
+
+  auto ranges = DiffMemory(images[0].data(), images[1].data(),
+                           Memory::MEM_SIZE, gap, kernel);
+  uint32_t total = 0;
+  for (auto& range : ranges) {
+    auto& debug = *machines[1];
+    auto name = debug.Symbolize(range.addr, true);
+    if (name.empty()) {
+      name = debug.Symbolize(range.addr);
+    }
+    printf("0x%04x +%u  %s\n", range.addr, range.size, name.c_str());
+    PrintBytes("-", images[0].data(), range);
+    PrintBytes("+", images[1].data(), range);
+    total += range.size;
+  }
+  printf("%zu ranges, %u bytes\n", ranges.size(), total);
+  return ranges.empty() ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#include "pacer.h"
+
+#include <thread>
+
+void Pacer::SetMode(PACING mode, double scale) {
+  this->mode = mode;
+  this->scale = (mode == PACING::SCALED) ? scale : 1.0;
+  frequency = 0;
+  next_pace = (mode == PACING::MAX_SPEED) ? UINT64_MAX : 0;
+}
+
+void Pacer::Start(uint64_t cycles, uint32_t frequency) {
+  if (mode == PACING::MAX_SPEED || frequency == 0) {
+    next_pace = UINT64_MAX;
+    return;
+  }
+
+  this->frequency = frequency;
+  anchor_cycles = cycles;
+  anchor_time = clock_type::now();
+
+  auto rate = static_cast<double>(frequency) * scale;
+  ns_per_cycle = 1e9 / rate;
+  batch_cycles = static_cast<uint64_t>(
+      rate * std::chrono::duration<double>(BATCH).count());
+  if (batch_cycles == 0) {
+    batch_cycles = 1;
+  }
+  next_pace = cycles + batch_cycles;
+}
+
+void Pacer::Pace(uint64_t cycles, uint32_t frequency) {
+  if (mode == PACING::MAX_SPEED) {
+    next_pace = UINT64_MAX;
+    return;
+  }
+
+  // Clock switch, the old anchor no longer maps cycles to time
+  if (frequency != this->frequency) {
+    Start(cycles, frequency);
+    return;
+  }
+
+  auto elapsed = std::chrono::nanoseconds(static_cast<int64_t>(
+      static_cast<double>(cycles - anchor_cycles) * ns_per_cycle));
+  auto target = anchor_time + elapsed;
+  auto now = clock_type::now();
+
+  if (target > now) {
+    std::this_thread::sleep_until(target);
+  } else if (now - target > MAX_DRIFT) {
+    // Host can't keep up, drop the backlog rather than burst to catch up
+    Start(cycles, frequency);
+    return;
+  }
+
+  next_pace = cycles + batch_cycles;
+}
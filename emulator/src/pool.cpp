@@ -0,0 +1,99 @@
+#include "pool.h"
+
+/**
+ * @brief Find the image for a firmware, loading it on first use. Must be
+ * called with the lock held.
+ *
+ */
+Pool::Image* Pool::GetImage(const std::string& filepath) {
+  auto found = images.find(filepath);
+  if (found != images.end()) {
+    return found->second.get();
+  }
+
+  auto instance = std::make_unique<PoolInstance>();
+  instance->emulator.SetOutput(&instance->output);
+  instance->emulator.GetDebugger().LoadMem(filepath);
+
+  auto image = std::make_unique<Image>();
+  image->memory = instance->emulator.Capture();
+  if (idle_count < MAX_IDLE) {
+    image->idle.push_back(std::move(instance));
+    idle_count++;
+  }
+  return images.emplace(filepath, std::move(image)).first->second.get();
+}
+
+std::unique_ptr<PoolInstance> Pool::Create(const Image* image) {
+  auto instance = std::make_unique<PoolInstance>();
+  instance->emulator.SetOutput(&instance->output);
+  instance->emulator.Restore(image->memory);
+  return instance;
+}
+
+/**
+ * @brief Make sure at least count idle instances of a firmware are ready
+ *
+ */
+void Pool::Load(const std::string& filepath, size_t count) {
+  std::lock_guard<std::mutex> guard(lock);
+  auto image = GetImage(filepath);
+  auto missing = (count > image->idle.size()) ? count - image->idle.size() : 0;
+  if (count > MAX_IDLE || idle_count + missing > MAX_IDLE) {
+    throw PoolException("can't keep more than " + std::to_string(MAX_IDLE) +
+                        " idle instances, " + std::to_string(idle_count) +
+                        " already are");
+  }
+  while (image->idle.size() < count) {
+    image->idle.push_back(Create(image));
+    idle_count++;
+  }
+}
+
+std::unique_ptr<PoolInstance> Pool::Acquire(const std::string& filepath) {
+  const Image* image;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = GetImage(filepath);
+    if (!found->idle.empty()) {
+      auto instance = std::move(found->idle.back());
+      found->idle.pop_back();
+      idle_count--;
+      return instance;
+    }
+    image = found;
+  }
+  // Images are never removed so this is safe outside of the lock
+  return Create(image);
+}
+
+/**
+ * @brief Reset an instance and hand it back for reuse
+ *
+ */
+void Pool::Release(const std::string& filepath,
+                   std::unique_ptr<PoolInstance> instance) {
+  Image* image;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    image = GetImage(filepath);
+  }
+
+  instance->output.str("");
+  instance->output.clear();
+  instance->emulator.SetTrace(Emulator::TRACE_NONE);
+  instance->emulator.SetPacing(PACING::MAX_SPEED);
+  instance->emulator.Restore(image->memory);
+
+  std::lock_guard<std::mutex> guard(lock);
+  if (idle_count < MAX_IDLE) {
+    image->idle.push_back(std::move(instance));
+    idle_count++;
+  }
+}
+
+size_t Pool::GetIdle(const std::string& filepath) {
+  std::lock_guard<std::mutex> guard(lock);
+  auto found = images.find(filepath);
+  return (found == images.end()) ? 0 : found->second->idle.size();
+}
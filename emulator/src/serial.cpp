@@ -0,0 +1,134 @@
+#include "serial.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+SerialHost::~SerialHost() {
+  Stop();
+  Close();
+}
+
+/**
+ * @brief Connect to "stdio", a new "pty" or an output file path
+ *
+ */
+void SerialHost::Open(const std::string& spec) {
+  Close();
+  if (spec == "stdio") {
+    out_fd = STDOUT_FILENO;
+    in_fd = STDIN_FILENO;
+    return;
+  }
+
+  own_fd = true;
+  if (spec == "pty") {
+    out_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (out_fd < 0 || grantpt(out_fd) || unlockpt(out_fd)) {
+      throw SerialException("could not open a pty: " +
+                            std::string(strerror(errno)));
+    }
+    pty_name = ptsname(out_fd);
+
+    // Raw bytes, nobody may be listening so never block on the pty
+    termios attributes;
+    if (tcgetattr(out_fd, &attributes) == 0) {
+      cfmakeraw(&attributes);
+      tcsetattr(out_fd, TCSANOW, &attributes);
+    }
+    fcntl(out_fd, F_SETFL, fcntl(out_fd, F_GETFL) | O_NONBLOCK);
+    in_fd = out_fd;
+    return;
+  }
+
+  out_fd = open(spec.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0) {
+    throw SerialException("could not open " + spec + ": " +
+                          std::string(strerror(errno)));
+  }
+}
+
+void SerialHost::Close() {
+  if (own_fd && out_fd >= 0) {
+    close(out_fd);
+  }
+  out_fd = -1;
+  in_fd = -1;
+  own_fd = false;
+  pty_name.clear();
+}
+
+void SerialHost::Start() {
+  if (running.exchange(true)) {
+    return;
+  }
+  thread = std::thread([this]() {
+    while (running.load(std::memory_order_relaxed)) {
+      if (!Flush()) {
+        std::this_thread::sleep_for(INTERVAL);
+      }
+    }
+  });
+}
+
+/**
+ * @brief Stop the thread, anything transmitted so far is written out
+ *
+ */
+void SerialHost::Stop() {
+  if (running.exchange(false)) {
+    thread.join();
+  }
+  Flush();
+}
+
+/**
+ * @brief One pass in each direction, returns whether any bytes moved
+ *
+ */
+bool SerialHost::Flush() {
+  uint8_t buffer[4096];
+  bool moved = false;
+
+  auto& tx = uart->GetTxBuffer();
+  while (auto count = tx.Read(buffer, sizeof(buffer))) {
+    WriteAll(buffer, count);
+    moved = true;
+  }
+
+  auto& rx = uart->GetRxBuffer();
+  auto room = std::min(sizeof(buffer), SerialBuffer::MASK + 1 - rx.Size());
+  pollfd input{in_fd, POLLIN, 0};
+  if (in_fd >= 0 && room && poll(&input, 1, 0) > 0) {
+    auto count = read(in_fd, buffer, room);
+    if (count > 0) {
+      rx.Write(buffer, count);
+      moved = true;
+    } else if (count == 0 || (errno != EAGAIN && errno != EIO)) {
+      // End of input, EIO is a pty with nothing attached yet
+      in_fd = -1;
+    }
+  }
+  return moved;
+}
+
+void SerialHost::WriteAll(const uint8_t* data, size_t size) {
+  while (size && out_fd >= 0) {
+    auto count = write(out_fd, data, size);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // Nothing reading the pty, the bytes are lost as on a real line
+      return;
+    }
+    data += count;
+    size -= count;
+  }
+}
@@ -0,0 +1,322 @@
+#include "server.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+#include "json.h"
+
+namespace {
+
+std::vector<std::string> Split(const std::string& line) {
+  std::vector<std::string> args;
+  std::istringstream stream(line);
+  std::string arg;
+  while (stream >> arg) {
+    args.push_back(arg);
+  }
+  return args;
+}
+
+uint64_t ParseNumber(const std::string& val) {
+  size_t end;
+  auto number = std::stoull(val, &end, 0);
+  if (end != val.size()) {
+    throw ServerException("invalid number: " + val);
+  }
+  return number;
+}
+
+MemAddr ParseAddress(const std::string& val) {
+  auto addr = ParseNumber(val);
+  if (addr >= Memory::MEM_SIZE) {
+    throw ServerException("address out of range: " + val);
+  }
+  return static_cast<MemAddr>(addr);
+}
+
+std::pair<MemAddr, uint64_t> ParsePair(const std::string& val) {
+  auto colon = val.find(':');
+  if (colon == std::string::npos) {
+    throw ServerException("expected ADDR:VALUE: " + val);
+  }
+  return {ParseAddress(val.substr(0, colon)),
+          ParseNumber(val.substr(colon + 1))};
+}
+
+std::string Hex(const uint8_t* data, size_t size) {
+  std::string hex;
+  char buffer[3];
+  for (size_t x = 0; x < size; x++) {
+    snprintf(buffer, sizeof(buffer), "%02x", data[x]);
+    hex += buffer;
+  }
+  return hex;
+}
+
+bool SendAll(int fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    auto count =
+        send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    sent += count;
+  }
+  return true;
+}
+
+}  // namespace
+
+PoolServer::~PoolServer() { Stop(); }
+
+void PoolServer::Listen(const std::string& path) {
+  sockaddr_un addr{};
+  if (path.size() >= sizeof(addr.sun_path)) {
+    throw ServerException("socket path too long: " + path);
+  }
+  addr.sun_family = AF_UNIX;
+  std::copy(path.begin(), path.end(), addr.sun_path);
+
+  listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    throw ServerException(std::string("socket: ") + strerror(errno));
+  }
+  unlink(path.c_str());
+  if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(listen_fd, SOMAXCONN) < 0) {
+    auto error = std::string("bind: ") + strerror(errno);
+    close(listen_fd);
+    listen_fd = -1;
+    throw ServerException(error);
+  }
+  this->path = path;
+}
+
+/**
+ * @brief Accept connections until Stop(), each one is served on its own
+ * thread and threads of closed connections are joined on the next accept
+ *
+ */
+void PoolServer::Serve() {
+  while (!stopping) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    std::vector<std::thread> finished;
+    {
+      std::lock_guard<std::mutex> guard(clients_lock);
+      if (stopping) {
+        close(fd);
+        break;
+      }
+      for (auto thread = threads.begin(); thread != threads.end();) {
+        if (std::find(done.begin(), done.end(), thread->get_id()) !=
+            done.end()) {
+          finished.push_back(std::move(*thread));
+          thread = threads.erase(thread);
+        } else {
+          thread++;
+        }
+      }
+      done.clear();
+      clients.push_back(fd);
+      threads.emplace_back(&PoolServer::Connection, this, fd);
+    }
+    for (auto& thread : finished) {
+      thread.join();
+    }
+  }
+}
+
+/**
+ * @brief Make Serve() return, only async-signal-safe calls so this can be used
+ * from a signal handler
+ *
+ */
+void PoolServer::Interrupt() {
+  stopping = true;
+  if (listen_fd >= 0) {
+    shutdown(listen_fd, SHUT_RDWR);
+  }
+}
+
+/**
+ * @brief Stop serving, close every connection and wait for their threads
+ *
+ */
+void PoolServer::Stop() {
+  Interrupt();
+
+  std::vector<std::thread> finished;
+  {
+    std::lock_guard<std::mutex> guard(clients_lock);
+    for (auto fd : clients) {
+      shutdown(fd, SHUT_RDWR);
+    }
+    finished.swap(threads);
+    done.clear();
+  }
+  for (auto& thread : finished) {
+    thread.join();
+  }
+
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(path.c_str());
+  }
+}
+
+void PoolServer::Connection(int fd) {
+  std::string pending;
+  char buffer[4096];
+  while (true) {
+    auto count = recv(fd, buffer, sizeof(buffer), 0);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+    pending.append(buffer, count);
+
+    size_t newline;
+    bool open = true;
+    while (open && (newline = pending.find('\n')) != std::string::npos) {
+      auto request = pending.substr(0, newline);
+      pending.erase(0, newline + 1);
+      open = SendAll(fd, Handle(request) + "\n");
+    }
+    if (!open) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(clients_lock);
+  clients.erase(std::find(clients.begin(), clients.end(), fd));
+  close(fd);
+  done.push_back(std::this_thread::get_id());
+}
+
+/**
+ * @brief Execute a single request line and build its response
+ *
+ */
+std::string PoolServer::Handle(const std::string& request) {
+  try {
+    auto args = Split(request);
+    if (args.empty()) {
+      throw ServerException("empty request");
+    }
+
+    if (args[0] == "ping") {
+      return "{\"ok\":true}";
+    }
+    if (args[0] == "load" && (args.size() == 2 || args.size() == 3)) {
+      auto count = (args.size() == 3) ? ParseNumber(args[2]) : 1;
+      pool.Load(args[1], count);
+      return "{\"ok\":true,\"idle\":" + std::to_string(pool.GetIdle(args[1])) +
+             "}";
+    }
+    if (args[0] == "run" && args.size() >= 2) {
+      return Run(args);
+    }
+    throw ServerException("unknown request: " + request);
+  } catch (std::exception& e) {
+    return "{\"ok\":false,\"error\":" + JsonString(e.what()) + "}";
+  }
+}
+
+std::string PoolServer::Run(const std::vector<std::string>& args) {
+  StopConditions stop;
+  std::vector<std::pair<MemAddr, uint8_t>> inputs;
+  std::vector<std::pair<MemAddr, uint64_t>> reads;
+  for (size_t x = 2; x < args.size(); x++) {
+    auto equals = args[x].find('=');
+    if (equals == std::string::npos) {
+      throw ServerException("expected KEY=VALUE: " + args[x]);
+    }
+    auto key = args[x].substr(0, equals);
+    auto val = args[x].substr(equals + 1);
+
+    if (key == "cycles") {
+      stop.max_cycles = ParseNumber(val);
+    } else if (key == "instructions") {
+      stop.max_instructions = ParseNumber(val);
+    } else if (key == "pc") {
+      stop.pc = ParseAddress(val);
+    } else if (key == "write") {
+      stop.sentinel = ParseAddress(val);
+    } else if (key == "set") {
+      auto input = ParsePair(val);
+      if (input.second > 0xff) {
+        throw ServerException("byte out of range: " + val);
+      }
+      inputs.emplace_back(input.first, static_cast<uint8_t>(input.second));
+    } else if (key == "read") {
+      auto range = ParsePair(val);
+      if (range.first + range.second > Memory::MEM_SIZE) {
+        throw ServerException("range out of bounds: " + val);
+      }
+      reads.push_back(range);
+    } else {
+      throw ServerException("unknown key: " + key);
+    }
+  }
+
+  auto instance = pool.Acquire(args[1]);
+  auto& emulator = instance->emulator;
+  auto& debug = emulator.GetDebugger();
+
+  std::string error;
+  auto reason = EXIT_REASON::FAULT;
+  try {
+    for (auto& input : inputs) {
+      debug.mem.SetUint8(input.first, input.second);
+    }
+    reason = emulator.Run(stop);
+  } catch (std::exception& e) {
+    reason = EXIT_REASON::FAULT;
+    error = e.what();
+  }
+
+  std::ostringstream json;
+  json << "{\"ok\":true,\"exit_reason\":"
+       << JsonString(Emulator::GetExitReasonString(reason)) << ",\"error\":"
+       << (error.empty() ? "null" : JsonString(error))
+       << ",\"cycles\":" << emulator.GetCycles()
+       << ",\"instructions\":" << emulator.GetInstructions()
+       << ",\"registers\":{";
+  for (uint16_t reg = 0; reg < 16; reg++) {
+    json << (reg ? "," : "") << "\"r" << reg
+         << "\":" << debug.GetRegister(reg);
+  }
+  json << "},\"output\":" << JsonString(instance->output.str())
+       << ",\"memory\":{";
+  for (size_t x = 0; x < reads.size(); x++) {
+    std::vector<uint8_t> data(reads[x].second);
+    debug.mem.ReadBlock(reads[x].first, data.data(), data.size());
+    json << (x ? "," : "") << "\"" << reads[x].first
+         << "\":" << JsonString(Hex(data.data(), data.size()));
+  }
+  json << "}}";
+
+  pool.Release(args[1], std::move(instance));
+  return json.str();
+}
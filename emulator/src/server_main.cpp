@@ -0,0 +1,70 @@
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "server.h"
+
+namespace {
+
+const char* USAGE =
+    "usage: emulator_server <socket> [--warm N] [firmware...]\n"
+    "  --warm N  instances to keep loaded per firmware (default 4)\n";
+
+PoolServer* server{nullptr};
+
+void Shutdown(int) {
+  // Serve() returns and main() cleans up
+  if (server != nullptr) {
+    server->Interrupt();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::vector<std::string> firmware;
+  std::string socket_path;
+  size_t warm = 4;
+
+  try {
+    for (size_t x = 0; x < args.size(); x++) {
+      if (args[x] == "--warm" && x + 1 < args.size()) {
+        warm = std::stoul(args[++x]);
+      } else if (args[x].rfind("--", 0) == 0) {
+        throw std::invalid_argument("unknown option: " + args[x]);
+      } else if (socket_path.empty()) {
+        socket_path = args[x];
+      } else {
+        firmware.push_back(args[x]);
+      }
+    }
+    if (socket_path.empty()) {
+      throw std::invalid_argument("no socket given");
+    }
+  } catch (std::exception& e) {
+    std::cerr << "emulator_server: " << e.what() << std::endl << USAGE;
+    return 2;
+  }
+
+  Pool pool;
+  PoolServer pool_server(pool);
+  try {
+    for (auto& path : firmware) {
+      pool.Load(path, warm);
+    }
+    pool_server.Listen(socket_path);
+  } catch (std::exception& e) {
+    std::cerr << "emulator_server: " << e.what() << std::endl;
+    return 1;
+  }
+
+  server = &pool_server;
+  std::signal(SIGINT, Shutdown);
+  std::signal(SIGTERM, Shutdown);
+  pool_server.Serve();
+  server = nullptr;
+  pool_server.Stop();
+  return 0;
+}
@@ -1,16 +1,44 @@
 #ifndef memory_h
 #define memory_h
 
+#include <bitset>
 #include <cstdint>
 #include <exception>
+#include <functional>
 #include <iomanip>
+#include <iostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "snapshot.h"
 
 typedef uint16_t MemAddr;
+typedef std::function<uint8_t(MemAddr addr)> ReadHook;
+typedef std::function<void(MemAddr addr, uint8_t val)> WriteHook;
+typedef std::function<void(MemAddr addr, uint16_t old_val, uint16_t val,
+                           bool byte, bool write)>
+    WatchHook;
+
+/**
+ * @brief Memory mapped registers with side effects, see Memory::MapIo()
+ *
+ * index is the value given to MapIo(), addr is the byte or the even address
+ * of a word access. Values are in CPU order.
+ */
+class IoDevice {
+ public:
+  virtual ~IoDevice(){};
+  virtual uint16_t IoRead(uint16_t index, MemAddr addr, bool byte) = 0;
+  virtual void IoWrite(uint16_t index, MemAddr addr, uint16_t val,
+                       bool byte) = 0;
+};
 
 class Memory {
  public:
   constexpr static uint32_t MEM_SIZE = 0x10000;
+  constexpr static uint32_t IO_SIZE = 0x0200;
+  constexpr static uint32_t DUMP_LINE = 16;
   Memory();
   ~Memory();
   uint8_t GetUint8(MemAddr addr);
@@ -19,11 +47,66 @@ class Memory {
   void SetUint16(MemAddr addr, uint16_t val);
   void SetUint16BSwap(MemAddr addr, uint16_t val);
   void LoadFile(std::string filepath);
-  void DisplayMem();
+  void LoadElf(std::istream& elf_file);
+  void LoadImage(MemAddr addr, const uint8_t* data, size_t size);
+  void ReadBlock(MemAddr addr, uint8_t* data, size_t size);
+  void WriteBlock(MemAddr addr, const uint8_t* data, size_t size);
+  void Save(Snapshot& snapshot);
+  void Load(Snapshot& snapshot);
+  uint16_t ReadRaw(MemAddr addr, bool byte);
+  void WriteRaw(MemAddr addr, uint16_t val, bool byte);
+  std::string Dump(MemAddr addr, uint32_t size);
+  void DisplayMem(MemAddr addr = 0, uint32_t size = MEM_SIZE);
+  void SetReadHook(MemAddr addr, ReadHook hook);
+  void SetWriteHook(MemAddr addr, WriteHook hook);
+  WriteHook GetWriteHook(MemAddr addr);
+  void MapIo(MemAddr addr, uint8_t width, IoDevice* device, uint16_t index,
+             bool read, bool write);
+  void MapWrites(MemAddr addr, uint32_t size, IoDevice* device,
+                 uint16_t index);
+  void Watch(MemAddr addr, uint32_t size, bool read, bool write);
+  void ClearWatches();
+  void SetWatchHook(WatchHook hook) { watch_hook = hook; }
 
  private:
-  uint8_t mem[MEM_SIZE];
+  struct IoSlot {
+    IoDevice* device{nullptr};
+    uint16_t index{};
+    MemAddr addr{};
+    uint8_t width{};
+    bool read{false};
+    bool write{false};
+  };
+
+  uint8_t mem[MEM_SIZE]{};
+  // Set for any address that needs more than a plain array access
+  std::bitset<MEM_SIZE> read_hooked;
+  std::bitset<MEM_SIZE> write_hooked;
+  std::unordered_map<MemAddr, ReadHook> read_hooks;
+  std::unordered_map<MemAddr, WriteHook> write_hooks;
+  IoSlot io[IO_SIZE]{};
+  // Ranges above the peripherals whose writes go to a device, like flash
+  struct IoRange {
+    MemAddr addr;
+    uint32_t size;
+    IoDevice* device;
+    uint16_t index;
+  };
+  std::vector<IoRange> write_ranges;
+  // Watched addresses are also hooked, so plain accesses never look here
+  std::bitset<MEM_SIZE> read_watched;
+  std::bitset<MEM_SIZE> write_watched;
+  WatchHook watch_hook;
   void CheckBounds(MemAddr addr);
+  void CheckRange(MemAddr addr, size_t size);
+  uint8_t Read(MemAddr addr);
+  void Write(MemAddr addr, uint8_t val);
+  uint16_t ReadWord(MemAddr addr);
+  void WriteWord(MemAddr addr, uint16_t val);
+  void WriteHooks(MemAddr addr, uint8_t val);
+  bool IoWord(MemAddr addr, bool read);
+  const IoRange* FindRange(MemAddr addr);
+  void UpdateHooked(MemAddr addr);
 };
 
 class MemoryException : public std::exception {
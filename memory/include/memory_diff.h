@@ -0,0 +1,35 @@
+#ifndef memory_diff_h
+#define memory_diff_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class DIFF_KERNEL { SCALAR, SSE2, AVX2, BEST };
+
+/**
+ * @brief Bytes from addr on that differ, addr is a plain offset so a full
+ * 64 KB image's last range can end at 0x10000
+ *
+ */
+struct DiffRange {
+  uint32_t addr;
+  uint32_t size;
+};
+
+/**
+ * @brief Compare two memory images and return the ranges that differ, in
+ * order
+ *
+ * Equal stretches are skipped a vector at a time and a difference is found
+ * from the compare mask without going back over the bytes. Ranges with at
+ * most gap equal bytes between them are merged into one. BEST picks the
+ * widest kernel the CPU supports.
+ */
+std::vector<DiffRange> DiffMemory(const uint8_t* a, const uint8_t* b,
+                                  size_t size, size_t gap = 0,
+                                  DIFF_KERNEL kernel = DIFF_KERNEL::BEST);
+
+bool IsSupported(DIFF_KERNEL kernel);
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef snapshot_h
+#define snapshot_h
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class SnapshotException : public std::exception {
+  std::string _msg;
+
+ public:
+  SnapshotException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
+};
+
+/**
+ * @brief Machine state serialized into a flat buffer
+ *
+ * Every part of the machine appends its state with Put() and reads it back
+ * in the same order with Get(), so there are no tags or lengths to parse.
+ * Clear() keeps the allocation, a snapshot that is saved over and over only
+ * costs the copies. Write() and Read() keep one in a versioned file.
+ */
+class Snapshot {
+ public:
+  Snapshot(){};
+  ~Snapshot(){};
+
+  template <typename T>
+  void Put(const T& val) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only plain values can be put in a snapshot");
+    PutBlock(&val, sizeof(val));
+  }
+
+  template <typename T>
+  void Get(T& val) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only plain values can be read from a snapshot");
+    GetBlock(&val, sizeof(val));
+  }
+
+  void PutBlock(const void* block, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(block);
+    data.insert(data.end(), bytes, bytes + size);
+  }
+
+  void GetBlock(void* block, size_t size) {
+    if (size > data.size() - position) {
+      throw SnapshotException("snapshot is truncated");
+    }
+    std::memcpy(block, data.data() + position, size);
+    position += size;
+  }
+
+  void PutString(const std::string& val);
+  std::string GetString();
+  void Clear();
+  void Rewind() { position = 0; }
+  size_t GetSize() { return data.size(); }
+  void Write(const std::string& path);
+  void Read(const std::string& path);
+
+  // Bumped whenever the layout of any part changes
+  static constexpr uint32_t VERSION = 1;
+  static constexpr char MAGIC[8] = {'M', 'S', 'P', '4', '3', '0', 'S', 'S'};
+
+ private:
+  std::vector<uint8_t> data;
+  size_t position{0};
+};
+
+#endif
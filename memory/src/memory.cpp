@@ -6,9 +6,6 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include<chrono>
-#include<thread>
-
 
 #include "read_elf.h"
 
@@ -20,37 +17,303 @@ Memory::Memory() {
 
 Memory::~Memory() {}
 
-uint8_t Memory::GetUint8(MemAddr addr) { return mem[addr]; }
+uint8_t Memory::GetUint8(MemAddr addr) {
+  if (read_hooked[addr]) {
+    auto val = Read(addr);
+    if (read_watched[addr]) {
+      watch_hook(addr, val, val, true, false);
+    }
+    return val;
+  }
+  return mem[addr];
+}
 
 uint16_t Memory::GetUint16(MemAddr addr) {
+  auto next = static_cast<MemAddr>(addr + 1);
+  if (read_hooked[addr] || read_hooked[next]) {
+    auto val = ReadWord(addr);
+    if (read_watched[addr] || read_watched[next]) {
+      watch_hook(addr, val, val, false, false);
+    }
+    return val;
+  }
   uint16_t val = static_cast<uint16_t>(mem[addr]) << 8;
-  val = val | static_cast<uint16_t>(mem[addr + 1]);
+  val = val | static_cast<uint16_t>(mem[next]);
   return __bswap_16(val);
 }
 
 void Memory::SetUint8(MemAddr addr, uint8_t val) {
-  mem[addr] = val;
-  if (addr == 0x21) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    std::cout << "P1OUT: 0x" << std::hex << +val << std::endl;
+  if (write_hooked[addr]) {
+    uint8_t old_val = mem[addr];
+    Write(addr, val);
+    if (write_watched[addr]) {
+      watch_hook(addr, old_val, mem[addr], true, true);
+    }
+    return;
   }
+  mem[addr] = val;
 }
 
 void Memory::SetUint16(MemAddr addr, uint16_t val) {
   CheckBounds(addr);
-  auto msb = val >> 8;
-  auto lsb = val & 0x00FF;
-  mem[addr] = msb;
-  mem[addr + 1] = lsb;
+  auto next = static_cast<MemAddr>(addr + 1);
+  if (!write_hooked[addr] && !write_hooked[next]) {
+    mem[addr] = val >> 8;
+    mem[next] = val & 0x00FF;
+    return;
+  }
+  if (!write_watched[addr] && !write_watched[next]) {
+    WriteWord(addr, val);
+    return;
+  }
+  auto old_val = ReadRaw(addr, false);
+  WriteWord(addr, val);
+  watch_hook(addr, old_val, ReadRaw(addr, false), false, true);
 }
 
 void Memory::SetUint16BSwap(MemAddr addr, uint16_t val) {
-  val = __bswap_16(val);
-  CheckBounds(addr);
+  SetUint16(addr, __bswap_16(val));
+}
+
+/**
+ * @brief Word read that needs more than a plain array access
+ *
+ */
+uint16_t Memory::ReadWord(MemAddr addr) {
+  auto next = static_cast<MemAddr>(addr + 1);
+  if (IoWord(addr, true) && !read_hooks.count(addr) &&
+      !read_hooks.count(next)) {
+    auto& slot = io[addr];
+    return slot.device->IoRead(slot.index, addr, false);
+  }
+  return Read(addr) | (Read(next) << 8);
+}
+
+/**
+ * @brief Word write in memory order, devices get the whole word
+ *
+ */
+void Memory::WriteWord(MemAddr addr, uint16_t val) {
   auto msb = val >> 8;
   auto lsb = val & 0x00FF;
-  mem[addr] = msb;
-  mem[addr + 1] = lsb;
+  if (IoWord(addr, false)) {
+    auto& slot = io[addr];
+    slot.device->IoWrite(slot.index, addr, __bswap_16(val), false);
+    WriteHooks(addr, msb);
+    WriteHooks(addr + 1, lsb);
+    return;
+  }
+  if (write_hooked[addr] && !(addr & 1)) {
+    auto range = FindRange(addr);
+    if (range != nullptr) {
+      range->device->IoWrite(range->index, addr, __bswap_16(val), false);
+      WriteHooks(addr, msb);
+      WriteHooks(addr + 1, lsb);
+      return;
+    }
+  }
+  Write(addr, msb);
+  Write(addr + 1, lsb);
+}
+
+/**
+ * @brief Value in CPU order, bypassing hooks and peripherals
+ *
+ */
+uint16_t Memory::ReadRaw(MemAddr addr, bool byte) {
+  if (byte) {
+    return mem[addr];
+  }
+  return mem[addr] | (mem[static_cast<MemAddr>(addr + 1)] << 8);
+}
+
+/**
+ * @brief Store a value in CPU order, bypassing hooks and peripherals
+ *
+ */
+void Memory::WriteRaw(MemAddr addr, uint16_t val, bool byte) {
+  mem[addr] = val & 0x00FF;
+  if (!byte) {
+    mem[static_cast<MemAddr>(addr + 1)] = val >> 8;
+  }
+}
+
+uint8_t Memory::Read(MemAddr addr) {
+  if (!read_hooked[addr]) {
+    return mem[addr];
+  }
+  if (!read_hooks.empty()) {
+    auto hook = read_hooks.find(addr);
+    if (hook != read_hooks.end()) {
+      return hook->second(addr);
+    }
+  }
+  if (addr < IO_SIZE && io[addr].read) {
+    auto& slot = io[addr];
+    return slot.device->IoRead(slot.index, addr, true);
+  }
+  return mem[addr];
+}
+
+void Memory::Write(MemAddr addr, uint8_t val) {
+  if (!write_hooked[addr]) {
+    mem[addr] = val;
+    return;
+  }
+  if (addr < IO_SIZE && io[addr].write) {
+    auto& slot = io[addr];
+    slot.device->IoWrite(slot.index, addr, val, true);
+  } else if (auto range = FindRange(addr)) {
+    range->device->IoWrite(range->index, addr, val, true);
+  } else {
+    mem[addr] = val;
+  }
+  WriteHooks(addr, val);
+}
+
+void Memory::WriteHooks(MemAddr addr, uint8_t val) {
+  if (write_hooks.empty()) {
+    return;
+  }
+  auto hook = write_hooks.find(addr);
+  if (hook != write_hooks.end()) {
+    hook->second(addr, val);
+  }
+}
+
+/**
+ * @brief True if addr starts a word register mapped for the access
+ *
+ */
+bool Memory::IoWord(MemAddr addr, bool read) {
+  if (addr >= IO_SIZE) {
+    return false;
+  }
+  auto& slot = io[addr];
+  return slot.width == 2 && slot.addr == addr &&
+         (read ? slot.read : slot.write);
+}
+
+/**
+ * @brief Call hook instead of reading memory at addr, an empty hook removes
+ * it again
+ *
+ */
+void Memory::SetReadHook(MemAddr addr, ReadHook hook) {
+  if (hook) {
+    read_hooks[addr] = hook;
+  } else {
+    read_hooks.erase(addr);
+  }
+  UpdateHooked(addr);
+}
+
+/**
+ * @brief Call hook after every write to addr, an empty hook removes it again
+ *
+ */
+void Memory::SetWriteHook(MemAddr addr, WriteHook hook) {
+  if (hook) {
+    write_hooks[addr] = hook;
+  } else {
+    write_hooks.erase(addr);
+  }
+  UpdateHooked(addr);
+}
+
+WriteHook Memory::GetWriteHook(MemAddr addr) {
+  auto hook = write_hooks.find(addr);
+  return (hook != write_hooks.end()) ? hook->second : WriteHook();
+}
+
+/**
+ * @brief Route accesses to a peripheral register through device. Addresses
+ * that aren't mapped stay plain memory, a null device unmaps the register.
+ *
+ */
+void Memory::MapIo(MemAddr addr, uint8_t width, IoDevice* device,
+                   uint16_t index, bool read, bool write) {
+  if (addr + width > IO_SIZE || (width != 1 && width != 2)) {
+    std::string error = std::to_string(addr) + " + " + std::to_string(width);
+    error += " is not a peripheral register";
+    throw MemoryException(error);
+  }
+
+  IoSlot slot{device, index, addr, width, read && device, write && device};
+  for (MemAddr a = addr; a < addr + width; a++) {
+    io[a] = slot;
+    UpdateHooked(a);
+  }
+}
+
+/**
+ * @brief Route every write to the size bytes from addr through device, reads
+ * stay plain memory. Words are passed on whole.
+ *
+ */
+void Memory::MapWrites(MemAddr addr, uint32_t size, IoDevice* device,
+                       uint16_t index) {
+  if (addr < IO_SIZE || addr + size > MEM_SIZE) {
+    std::string error = std::to_string(addr) + " + " + std::to_string(size);
+    error += " can't be mapped";
+    throw MemoryException(error);
+  }
+  write_ranges.push_back({addr, size, device, index});
+  for (uint32_t a = addr; a < addr + size; a++) {
+    write_hooked[a] = true;
+  }
+}
+
+/**
+ * @brief Report accesses to the size bytes from addr to the watch hook,
+ * with the contents before and after. Word accesses are reported once.
+ *
+ */
+void Memory::Watch(MemAddr addr, uint32_t size, bool read, bool write) {
+  if (!watch_hook) {
+    throw MemoryException("no watch hook set");
+  }
+  if (addr + size > MEM_SIZE) {
+    std::string error = std::to_string(addr) + " + " + std::to_string(size);
+    error += " is out of range";
+    throw MemoryException(error);
+  }
+  for (uint32_t a = addr; a < addr + size; a++) {
+    read_watched[a] = read_watched[a] || read;
+    write_watched[a] = write_watched[a] || write;
+    UpdateHooked(a);
+  }
+}
+
+void Memory::ClearWatches() {
+  auto watched = read_watched | write_watched;
+  read_watched.reset();
+  write_watched.reset();
+  for (uint32_t a = 0; a < MEM_SIZE; a++) {
+    if (watched[a]) {
+      UpdateHooked(a);
+    }
+  }
+}
+
+const Memory::IoRange* Memory::FindRange(MemAddr addr) {
+  for (auto& range : write_ranges) {
+    if (addr >= range.addr && addr < range.addr + range.size) {
+      return &range;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Work out whether addr can still be accessed as plain memory
+ *
+ */
+void Memory::UpdateHooked(MemAddr addr) {
+  read_hooked[addr] = read_watched[addr] || read_hooks.count(addr) ||
+                      (addr < IO_SIZE && io[addr].read);
+  write_hooked[addr] = write_watched[addr] || write_hooks.count(addr) ||
+                       (addr < IO_SIZE && io[addr].write) || FindRange(addr);
 }
 
 void Memory::CheckBounds(MemAddr addr) {
@@ -62,8 +325,25 @@ void Memory::CheckBounds(MemAddr addr) {
   throw MemoryException(error);
 }
 
+void Memory::CheckRange(MemAddr addr, size_t size) {
+  if (addr + size <= MEM_SIZE) {
+    return;
+  }
+  std::string error = std::to_string(addr) + " + " + std::to_string(size);
+  error += " is out of range";
+  throw MemoryException(error);
+}
+
 void Memory::LoadFile(std::string filepath) {
-  ElfReader elf_reader(filepath);
+  if (!std::filesystem::exists(filepath)) {
+    throw(ElfReaderException("File does not exist"));
+  }
+  std::ifstream elf_file(filepath, std::ios::binary);
+  LoadElf(elf_file);
+}
+
+void Memory::LoadElf(std::istream& elf_file) {
+  ElfReader elf_reader(elf_file);
   auto segments = elf_reader.GetLoadableSegments();
   if (!segments.has_value()) {
     throw(ElfReaderException("No loadable segments found in file"));
@@ -71,44 +351,104 @@ void Memory::LoadFile(std::string filepath) {
   for (auto segment : segments.value()) {
     // std::cout << "Loading segment into memory" << std::endl;
 
-    std::ifstream elf_file(filepath, std::ios::binary | std::ios::ate);
-    std::streamsize size = elf_file.tellg();
     auto mem_addr = segment.p_offset;
     auto mem_size = segment.p_memsz;
-    elf_file.seekg(mem_addr, std::ios::beg);
-    char* buffer = new char[mem_size];
-    elf_file.read(buffer, mem_size);
-    for (int x = 0; x < mem_size; x++) {
-      mem[x + segment.p_paddr] = buffer[x];
+    // Checked at full width, CheckRange() would see the address truncated
+    if (static_cast<uint64_t>(segment.p_paddr) + mem_size > MEM_SIZE) {
+      throw MemoryException("segment at " + std::to_string(segment.p_paddr) +
+                            " + " + std::to_string(mem_size) +
+                            " is out of range");
     }
+    if (segment.p_filesz > mem_size) {
+      throw MemoryException("segment at " + std::to_string(segment.p_paddr) +
+                            " has more file data than memory");
+    }
+
+    // Anything past the file contents (.bss, .stack) is zero filled
+    auto data = &mem[segment.p_paddr];
+    std::fill(data, data + mem_size, 0);
+    elf_file.clear();
+    elf_file.seekg(mem_addr, std::ios::beg);
+    elf_file.read(reinterpret_cast<char*>(data), segment.p_filesz);
   }
   // DisplayMem();
 }
 
-void Memory::DisplayMem() {
-  for (int x = 0; x < MEM_SIZE; x += 16) {
-    std::cout << std::hex << std::setfill('0') << std::setw(8) << std::right
-              << x << "  ";
-    std::cout << std::hex << std::setfill('0') << std::setw(2) << std::right
-              << +mem[x];
-    for (int z = 1; z < 16; z++) {
-      if (z == 8) {
-        std::cout << " ";
-      }
-      std::cout << " " << std::hex << std::setfill('0') << std::setw(2)
-                << std::right << +mem[x + z];
-    }
+/**
+ * @brief Copy a raw binary image into memory at addr
+ *
+ */
+void Memory::LoadImage(MemAddr addr, const uint8_t* data, size_t size) {
+  CheckRange(addr, size);
+  std::copy(data, data + size, &mem[addr]);
+}
+
+/**
+ * @brief The whole address space, hooks and watches are set up by the
+ * owners and aren't part of it
+ *
+ */
+void Memory::Save(Snapshot& snapshot) { snapshot.PutBlock(mem, MEM_SIZE); }
+
+void Memory::Load(Snapshot& snapshot) { snapshot.GetBlock(mem, MEM_SIZE); }
 
-    std::cout << "  |";
-    for (int z = 0; z < 16; z++) {
-      if (isprint(mem[x + z])) {
-        std::cout << static_cast<char>(mem[x + z]);
-      } else {
-        std::cout << ".";
-      }
+/**
+ * @brief Bulk copy out of memory, bypassing read hooks
+ *
+ */
+void Memory::ReadBlock(MemAddr addr, uint8_t* data, size_t size) {
+  CheckRange(addr, size);
+  std::copy(&mem[addr], &mem[addr] + size, data);
+}
+
+/**
+ * @brief Bulk copy into memory, bypassing write hooks
+ *
+ */
+void Memory::WriteBlock(MemAddr addr, const uint8_t* data, size_t size) {
+  CheckRange(addr, size);
+  std::copy(data, data + size, &mem[addr]);
+}
+
+/**
+ * @brief Hex and ASCII listing of a range, DUMP_LINE bytes a line, written
+ * straight into one buffer sized for the whole range
+ *
+ */
+std::string Memory::Dump(MemAddr addr, uint32_t size) {
+  static constexpr char HEX[] = "0123456789abcdef";
+  // "00000000  " address, 16 bytes with a gap after 8, "  |" and the ASCII
+  static constexpr size_t BYTES_AT = 10;
+  static constexpr size_t ASCII_AT = BYTES_AT + DUMP_LINE * 3 + 3;
+  CheckRange(addr, size);
+
+  std::string out((size + DUMP_LINE - 1) / DUMP_LINE *
+                      (ASCII_AT + DUMP_LINE + 2),
+                  ' ');
+  char* line = &out[0];
+  for (uint32_t offset = 0; offset < size; offset += DUMP_LINE) {
+    uint32_t start = addr + offset;
+    for (int x = 0; x < 8; x++) {
+      line[x] = HEX[(start >> (28 - 4 * x)) & 0xF];
+    }
+    auto count = std::min(DUMP_LINE, size - offset);
+    auto ascii = line + ASCII_AT;
+    for (uint32_t x = 0; x < count; x++) {
+      auto val = mem[start + x];
+      auto hex = line + BYTES_AT + x * 3 + (x >= DUMP_LINE / 2);
+      hex[0] = HEX[val >> 4];
+      hex[1] = HEX[val & 0xF];
+      ascii[x] = (val >= 0x20 && val < 0x7F) ? val : '.';
     }
-    std::cout << "|";
-    std::cout << std::endl;
-    ;
+    ascii[-1] = '|';
+    ascii[count] = '|';
+    ascii[count + 1] = '\n';
+    line = ascii + count + 2;
   }
-}
\ No newline at end of file
+  out.resize(line - out.data());
+  return out;
+}
+
+void Memory::DisplayMem(MemAddr addr, uint32_t size) {
+  std::cout << Dump(addr, size) << std::flush;
+}
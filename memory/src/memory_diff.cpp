@@ -0,0 +1,121 @@
+#include "memory_diff.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DIFF_X86
+#endif
+
+namespace {
+
+// Index of the first byte from pos on where the images are equal (SAME) or
+// differ (!SAME), size if there is none
+typedef size_t (*Find)(const uint8_t* a, const uint8_t* b, size_t pos,
+                       size_t size, bool same);
+
+size_t FindScalar(const uint8_t* a, const uint8_t* b, size_t pos,
+                  size_t size, bool same) {
+  // Whole words while looking for a difference
+  if (!same) {
+    for (; pos + 8 <= size; pos += 8) {
+      uint64_t x, y;
+      memcpy(&x, a + pos, 8);
+      memcpy(&y, b + pos, 8);
+      if (x != y) {
+        break;
+      }
+    }
+  }
+  while (pos < size && (a[pos] == b[pos]) != same) {
+    pos++;
+  }
+  return pos;
+}
+
+#ifdef DIFF_X86
+size_t FindSse2(const uint8_t* a, const uint8_t* b, size_t pos, size_t size,
+                bool same) {
+  // Bits of the compare mask that end the search
+  uint32_t stop = same ? 0x0000 : 0xFFFF;
+  for (; pos + 16 <= size; pos += 16) {
+    auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + pos));
+    auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + pos));
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ stop;
+    if (mask) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return FindScalar(a, b, pos, size, same);
+}
+
+__attribute__((target("avx2"))) size_t FindAvx2(const uint8_t* a,
+                                                const uint8_t* b, size_t pos,
+                                                size_t size, bool same) {
+  uint32_t stop = same ? 0x00000000 : 0xFFFFFFFF;
+  for (; pos + 32 <= size; pos += 32) {
+    auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + pos));
+    auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + pos));
+    uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) ^ stop;
+    if (mask) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return FindSse2(a, b, pos, size, same);
+}
+#endif
+
+Find GetFind(DIFF_KERNEL kernel) {
+  if (kernel == DIFF_KERNEL::BEST) {
+    kernel = IsSupported(DIFF_KERNEL::AVX2)   ? DIFF_KERNEL::AVX2
+             : IsSupported(DIFF_KERNEL::SSE2) ? DIFF_KERNEL::SSE2
+                                              : DIFF_KERNEL::SCALAR;
+  }
+#ifdef DIFF_X86
+  if (kernel == DIFF_KERNEL::AVX2 && IsSupported(kernel)) {
+    return FindAvx2;
+  }
+  if (kernel == DIFF_KERNEL::SSE2 && IsSupported(kernel)) {
+    return FindSse2;
+  }
+#endif
+  return FindScalar;
+}
+
+}  // namespace
+
+bool IsSupported(DIFF_KERNEL kernel) {
+  switch (kernel) {
+#ifdef DIFF_X86
+    case DIFF_KERNEL::AVX2:
+      return __builtin_cpu_supports("avx2");
+    case DIFF_KERNEL::SSE2:
+      return __builtin_cpu_supports("sse2");
+#endif
+    case DIFF_KERNEL::SCALAR:
+    case DIFF_KERNEL::BEST:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::vector<DiffRange> DiffMemory(const uint8_t* a, const uint8_t* b,
+                                  size_t size, size_t gap,
+                                  DIFF_KERNEL kernel) {
+  auto find = GetFind(kernel);
+  std::vector<DiffRange> ranges;
+  size_t pos = find(a, b, 0, size, false);
+  while (pos < size) {
+    auto end = find(a, b, pos, size, true);
+    if (!ranges.empty() &&
+        pos - (ranges.back().addr + ranges.back().size) <= gap) {
+      ranges.back().size = end - ranges.back().addr;
+    } else {
+      ranges.push_back(
+          {static_cast<uint32_t>(pos), static_cast<uint32_t>(end - pos)});
+    }
+    pos = find(a, b, end, size, false);
+  }
+  return ranges;
+}
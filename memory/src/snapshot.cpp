@@ -0,0 +1,85 @@
+#include "snapshot.h"
+
+#include <algorithm>
+#include <fstream>
+
+void Snapshot::PutString(const std::string& val) {
+  Put(static_cast<uint32_t>(val.size()));
+  PutBlock(val.data(), val.size());
+}
+
+std::string Snapshot::GetString() {
+  uint32_t size;
+  Get(size);
+  if (size > data.size() - position) {
+    throw SnapshotException("snapshot is truncated");
+  }
+  std::string val(reinterpret_cast<const char*>(data.data() + position), size);
+  position += size;
+  return val;
+}
+
+/**
+ * @brief Empty the snapshot for saving into again, the buffer is kept
+ *
+ */
+void Snapshot::Clear() {
+  data.clear();
+  position = 0;
+}
+
+/**
+ * @brief Store the snapshot in a file, behind a magic number and the layout
+ * version
+ *
+ */
+void Snapshot::Write(const std::string& path) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw SnapshotException("failed to create " + path);
+  }
+  uint32_t version = VERSION;
+  uint64_t size = data.size();
+  file.write(MAGIC, sizeof(MAGIC));
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.write(reinterpret_cast<const char*>(data.data()), data.size());
+  if (!file) {
+    throw SnapshotException("failed to write " + path);
+  }
+}
+
+void Snapshot::Read(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw SnapshotException("failed to open " + path);
+  }
+  char magic[sizeof(MAGIC)];
+  uint32_t version;
+  uint64_t size;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&size), sizeof(size));
+  if (!file || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+    throw SnapshotException("not a snapshot: " + path);
+  }
+  if (version != VERSION) {
+    throw SnapshotException("unsupported snapshot version " +
+                            std::to_string(version) + ": " + path);
+  }
+
+  auto start = file.tellg();
+  file.seekg(0, std::ios::end);
+  auto remaining = static_cast<uint64_t>(file.tellg() - start);
+  file.seekg(start);
+  if (!file || size > remaining) {
+    throw SnapshotException("snapshot is truncated: " + path);
+  }
+
+  data.resize(size);
+  file.read(reinterpret_cast<char*>(data.data()), size);
+  if (!file) {
+    throw SnapshotException("snapshot is truncated: " + path);
+  }
+  position = 0;
+}
@@ -0,0 +1,88 @@
+#ifndef msp430emu_h
+#define msp430emu_h
+
+/*
+ * C interface to the emulator for test harnesses that drive instances
+ * in-process. Every call taking an instance is safe to use from one thread
+ * per instance. Functions returning int return MSP430EMU_OK on success, the
+ * message for the last failure is available from msp430emu_last_error().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define MSP430EMU_API __attribute__((visibility("default")))
+#else
+#define MSP430EMU_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSP430EMU_VERSION 2
+#define MSP430EMU_REGISTERS 16
+
+enum {
+  MSP430EMU_OK = 0,
+  MSP430EMU_ERROR = -1,     // Bad arguments or image could not be loaded
+  MSP430EMU_FAULT = -2,     // CPU fault while running
+  MSP430EMU_BREAKPOINT = 1  // Stopped at a breakpoint
+};
+
+typedef struct msp430emu msp430emu;
+
+typedef uint8_t (*msp430emu_read_callback)(void* user, uint16_t addr);
+typedef void (*msp430emu_write_callback)(void* user, uint16_t addr,
+                                         uint8_t val);
+
+MSP430EMU_API int msp430emu_version(void);
+
+MSP430EMU_API msp430emu* msp430emu_create(void);
+MSP430EMU_API void msp430emu_destroy(msp430emu* emu);
+MSP430EMU_API const char* msp430emu_last_error(msp430emu* emu);
+
+/* Loading an ELF image resets the processor, raw images need a reset */
+MSP430EMU_API int msp430emu_load_file(msp430emu* emu, const char* path);
+MSP430EMU_API int msp430emu_load_elf(msp430emu* emu, const uint8_t* data,
+                                     size_t size);
+MSP430EMU_API int msp430emu_load_image(msp430emu* emu, uint16_t addr,
+                                       const uint8_t* data, size_t size);
+MSP430EMU_API int msp430emu_reset(msp430emu* emu);
+
+MSP430EMU_API int msp430emu_run(msp430emu* emu, uint64_t cycles);
+MSP430EMU_API uint64_t msp430emu_cycles(msp430emu* emu);
+
+/* Run for up to steps instructions, returns MSP430EMU_BREAKPOINT if the PC
+ * reached a breakpoint first */
+MSP430EMU_API int msp430emu_set_breakpoint(msp430emu* emu, uint16_t addr,
+                                           int enabled);
+MSP430EMU_API int msp430emu_continue(msp430emu* emu, uint64_t steps);
+
+/* Registers are R0 (PC) through R15 */
+MSP430EMU_API int msp430emu_read_registers(msp430emu* emu, uint16_t* regs,
+                                           size_t count);
+MSP430EMU_API int msp430emu_write_registers(msp430emu* emu,
+                                            const uint16_t* regs,
+                                            size_t count);
+
+/* Bulk memory access, no peripheral side effects */
+MSP430EMU_API int msp430emu_read_memory(msp430emu* emu, uint16_t addr,
+                                        uint8_t* data, size_t size);
+MSP430EMU_API int msp430emu_write_memory(msp430emu* emu, uint16_t addr,
+                                         const uint8_t* data, size_t size);
+
+/* Passing a NULL callback removes it */
+MSP430EMU_API int msp430emu_set_read_callback(msp430emu* emu, uint16_t addr,
+                                              msp430emu_read_callback callback,
+                                              void* user);
+MSP430EMU_API int msp430emu_set_write_callback(
+    msp430emu* emu, uint16_t addr, msp430emu_write_callback callback,
+    void* user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
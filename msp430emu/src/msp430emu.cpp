@@ -0,0 +1,171 @@
+#include "msp430emu.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "emulator.h"
+
+struct msp430emu {
+  Emulator emulator;
+  std::ostringstream output;
+  std::string error;
+};
+
+namespace {
+
+/**
+ * @brief Run func, turning exceptions into a status code so none cross the C
+ * boundary
+ *
+ */
+template <typename Func>
+int Guard(msp430emu* emu, int failure, Func func) {
+  if (emu == nullptr) {
+    return MSP430EMU_ERROR;
+  }
+  try {
+    func(emu->emulator.GetDebugger());
+    return MSP430EMU_OK;
+  } catch (std::exception& e) {
+    emu->error = e.what();
+  }
+  return failure;
+}
+
+void CheckRegisters(size_t count) {
+  if (count > MSP430EMU_REGISTERS) {
+    throw std::out_of_range("register count " + std::to_string(count) +
+                            " is out of range");
+  }
+}
+
+}  // namespace
+
+int msp430emu_version(void) { return MSP430EMU_VERSION; }
+
+msp430emu* msp430emu_create(void) {
+  try {
+    auto emu = new msp430emu();
+    emu->emulator.SetOutput(&emu->output);
+    return emu;
+  } catch (std::exception&) {
+    return nullptr;
+  }
+}
+
+void msp430emu_destroy(msp430emu* emu) { delete emu; }
+
+const char* msp430emu_last_error(msp430emu* emu) {
+  return (emu == nullptr) ? "NULL instance" : emu->error.c_str();
+}
+
+int msp430emu_load_file(msp430emu* emu, const char* path) {
+  return Guard(emu, MSP430EMU_ERROR,
+               [&](Debugger& debug) { debug.LoadMem(path); });
+}
+
+int msp430emu_load_elf(msp430emu* emu, const uint8_t* data, size_t size) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) {
+    std::istringstream elf_file(
+        std::string(reinterpret_cast<const char*>(data), size));
+    debug.LoadElf(elf_file);
+  });
+}
+
+int msp430emu_load_image(msp430emu* emu, uint16_t addr, const uint8_t* data,
+                         size_t size) {
+  return Guard(emu, MSP430EMU_ERROR,
+               [&](Debugger& debug) { debug.LoadImage(addr, data, size); });
+}
+
+int msp430emu_reset(msp430emu* emu) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) { debug.Reset(); });
+}
+
+int msp430emu_run(msp430emu* emu, uint64_t cycles) {
+  return Guard(emu, MSP430EMU_FAULT,
+               [&](Debugger&) { emu->emulator.Run(cycles); });
+}
+
+uint64_t msp430emu_cycles(msp430emu* emu) {
+  return (emu == nullptr) ? 0 : emu->emulator.GetCycles();
+}
+
+int msp430emu_set_breakpoint(msp430emu* emu, uint16_t addr, int enabled) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) {
+    if (enabled) {
+      debug.SetBreakpoint(addr);
+    } else {
+      debug.ClearBreakpoint(addr);
+    }
+  });
+}
+
+int msp430emu_continue(msp430emu* emu, uint64_t steps) {
+  auto reason = STOP_REASON::STEP_LIMIT;
+  auto status = Guard(emu, MSP430EMU_FAULT, [&](Debugger& debug) {
+    reason = debug.Continue(steps);
+  });
+  if (status == MSP430EMU_OK && reason == STOP_REASON::BREAKPOINT) {
+    return MSP430EMU_BREAKPOINT;
+  }
+  return status;
+}
+
+int msp430emu_read_registers(msp430emu* emu, uint16_t* regs, size_t count) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) {
+    CheckRegisters(count);
+    for (size_t x = 0; x < count; x++) {
+      regs[x] = debug.GetRegister(x);
+    }
+  });
+}
+
+int msp430emu_write_registers(msp430emu* emu, const uint16_t* regs,
+                              size_t count) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) {
+    CheckRegisters(count);
+    for (size_t x = 0; x < count; x++) {
+      *debug.proc.register_map[x] = regs[x];
+    }
+  });
+}
+
+int msp430emu_read_memory(msp430emu* emu, uint16_t addr, uint8_t* data,
+                          size_t size) {
+  return Guard(emu, MSP430EMU_ERROR,
+               [&](Debugger& debug) { debug.mem.ReadBlock(addr, data, size); });
+}
+
+int msp430emu_write_memory(msp430emu* emu, uint16_t addr, const uint8_t* data,
+                           size_t size) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) {
+    debug.mem.WriteBlock(addr, data, size);
+  });
+}
+
+int msp430emu_set_read_callback(msp430emu* emu, uint16_t addr,
+                                msp430emu_read_callback callback, void* user) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) {
+    ReadHook hook;
+    if (callback != nullptr) {
+      hook = [callback, user](MemAddr addr) { return callback(user, addr); };
+    }
+    debug.mem.SetReadHook(addr, hook);
+  });
+}
+
+int msp430emu_set_write_callback(msp430emu* emu, uint16_t addr,
+                                 msp430emu_write_callback callback,
+                                 void* user) {
+  return Guard(emu, MSP430EMU_ERROR, [&](Debugger& debug) {
+    WriteHook hook;
+    if (callback != nullptr) {
+      hook = [callback, user](MemAddr addr, uint8_t val) {
+        callback(user, addr, val);
+      };
+    }
+    debug.mem.SetWriteHook(addr, hook);
+  });
+}
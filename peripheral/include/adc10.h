@@ -0,0 +1,125 @@
+#ifndef adc10_h
+#define adc10_h
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "clock.h"
+#include "peripheral.h"
+#include "processor.h"
+#include "sample_stream.h"
+
+union ADC10CTL0_Union {
+  struct {
+    uint8_t ADC10SC : 1;
+    uint8_t ENC : 1;
+    uint8_t ADC10IFG : 1;
+    uint8_t ADC10IE : 1;
+    uint8_t ADC10ON : 1;
+    uint8_t REFON : 1;
+    uint8_t REF2_5V : 1;
+    uint8_t MSC : 1;
+    uint8_t REFBURST : 1;
+    uint8_t REFOUT : 1;
+    uint8_t ADC10SR : 1;
+    uint8_t ADC10SHTx : 2;
+    uint8_t SREFx : 3;
+  };
+  uint16_t val;
+};
+
+union ADC10CTL1_Union {
+  struct {
+    uint8_t ADC10BUSY : 1;
+    uint8_t CONSEQx : 2;
+    uint8_t ADC10SSELx : 2;
+    uint8_t ADC10DIVx : 3;
+    uint8_t ISSH : 1;
+    uint8_t ADC10DF : 1;
+    uint8_t SHSx : 2;
+    uint8_t INCHx : 4;
+  };
+  uint16_t val;
+};
+
+/**
+ * @brief ADC10 with the data transfer controller
+ *
+ * Each conversion is one scheduler event at the end of its sample and
+ * conversion time. Channels read a fixed value or a SampleStream looked up
+ * by the virtual time of the conversion. Only ADC10SC starts conversions,
+ * the timer triggers of SHSx aren't connected.
+ */
+class Adc10 : public Peripheral {
+ public:
+  Adc10(Clock* clock, Processor* proc);
+  ~Adc10() override{};
+
+  void Reset() override;
+  void Save(Snapshot& snapshot) override;
+  void Load(Snapshot& snapshot) override;
+  void SetInput(uint8_t channel, uint16_t val);
+  void SetStream(uint8_t channel, std::shared_ptr<SampleStream> stream);
+  uint64_t GetConversionCycles(uint64_t cycle);
+
+  static constexpr int CHANNELS = 16;
+  static constexpr uint32_t ADC10OSC_HZ = 5000000;
+
+  static constexpr MemAddr ADC10DTC0_ADDR = 0x0048;
+  static constexpr MemAddr ADC10DTC1_ADDR = 0x0049;
+  static constexpr MemAddr ADC10AE0_ADDR = 0x004A;
+  static constexpr MemAddr ADC10CTL0_ADDR = 0x01B0;
+  static constexpr MemAddr ADC10CTL1_ADDR = 0x01B2;
+  static constexpr MemAddr ADC10MEM_ADDR = 0x01B4;
+  static constexpr MemAddr ADC10SA_ADDR = 0x01BC;
+
+  // ADC10DTC0 bits
+  static constexpr uint8_t ADC10FETCH = 0x01;
+  static constexpr uint8_t ADC10B1 = 0x02;
+  static constexpr uint8_t ADC10CT = 0x04;
+  static constexpr uint8_t ADC10TB = 0x08;
+
+ protected:
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override;
+
+ private:
+  void Start(uint64_t cycle);
+  void Stop();
+  void Event(uint64_t cycle);
+  uint16_t Sample(uint64_t cycle);
+  void Store(uint16_t val);
+  void SetBusy(bool busy);
+  void SetFlag();
+  void UpdateInterrupts();
+
+  Clock* clock;
+  Scheduler* scheduler;
+  InterruptController* irq;
+  const uint64_t* cycles;
+  size_t event_id;
+
+  uint16_t dtc0_index;
+  uint16_t dtc1_index;
+  uint16_t ctl0_index;
+  uint16_t ctl1_index;
+  uint16_t mem_index;
+  uint16_t sa_index;
+
+  std::array<uint16_t, CHANNELS> inputs{};
+  std::array<std::shared_ptr<SampleStream>, CHANNELS> streams;
+
+  // A sequence is active between the first ADC10SC and its last result,
+  // converting while a conversion is scheduled
+  bool active{false};
+  bool converting{false};
+  bool stopping{false};
+  uint8_t channel{0};
+
+  // Words moved by the DTC into the current block
+  uint16_t transfers{0};
+  bool dtc_done{false};
+};
+
+#endif
@@ -1,14 +1,57 @@
 #ifndef clock_h
 #define clock_h
 
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <vector>
 
 #include "peripheral.h"
 
 typedef std::pair<uint16_t, uint8_t> F_DCO;
 typedef std::map<F_DCO, uint32_t> FrequencyMap;
 
+enum class CLOCK { MCLK, SMCLK, ACLK };
+
+namespace dco {
+
+constexpr int RSEL_STEPS = 16;
+constexpr int DCO_STEPS = 8;
+
+// Datasheet f(DCO) in MHz for DCOx = 3 at each RSELx
+constexpr double DCO3_MHZ[RSEL_STEPS] = {0.12, 0.15, 0.21, 0.30, 0.41, 0.58,
+                                         0.80, 1.2,  1.6,  2.3,  3.4,  4.25,
+                                         6.0,  7.8,  12,   15.25};
+
+// Ratio between neighbouring DCOx taps
+constexpr double S_DCO = 1.08;
+
+/**
+ * @brief f(DCO) in Hz for every RSELx/DCOx pair, indexed RSELx * 8 + DCOx
+ *
+ */
+constexpr std::array<uint32_t, RSEL_STEPS * DCO_STEPS> MakeTable() {
+  std::array<uint32_t, RSEL_STEPS * DCO_STEPS> table{};
+  for (int rsel = 0; rsel < RSEL_STEPS; rsel++) {
+    for (int tap = 0; tap < DCO_STEPS; tap++) {
+      double freq = DCO3_MHZ[rsel] * 1e6;
+      for (int step = 3; step < tap; step++) {
+        freq *= S_DCO;
+      }
+      for (int step = tap; step < 3; step++) {
+        freq /= S_DCO;
+      }
+      table[rsel * DCO_STEPS + tap] = static_cast<uint32_t>(freq + 0.5);
+    }
+  }
+  return table;
+}
+
+constexpr std::array<uint32_t, RSEL_STEPS * DCO_STEPS> TABLE = MakeTable();
+
+}  // namespace dco
+
 union DCOControlUnion {
   struct {
     uint8_t MODx : 5;
@@ -52,18 +95,61 @@ union BCSCTL3_Union {
 class Clock : public Peripheral {
  public:
   Clock();
-  ~Clock(){};
+  ~Clock() override{};
 
   F_DCO MakePair(int a, int b);
   uint32_t MHZ(double val);
   uint32_t MHZ(int val);
   uint32_t GetDCO();
+  uint32_t GetFrequency(CLOCK clock);
+  uint64_t GetTicks(CLOCK clock, uint64_t cycle);
+  uint64_t GetCycle(CLOCK clock, uint64_t ticks);
+  uint64_t GetNanoseconds(uint64_t cycle);
+  void SetCycleCounter(const uint64_t* cycles);
+  void AddListener(std::function<void()> listener);
+  void ResetTime() { time_epoch = {}; }
+  void Reset() override;
+  void Save(Snapshot& snapshot) override;
+  void Load(Snapshot& snapshot) override;
 
   FrequencyMap frequency_map;
   DCOControlUnion DCO;
   BCSCTL1_Union BCSCTL1;
   BCSCTL2_Union BCSCTL2;
   BCSCTL3_Union BCSCTL3;
+
+  static constexpr MemAddr BCSCTL3_ADDR = 0x53;
+  static constexpr MemAddr DCOCTL_ADDR = 0x56;
+  static constexpr MemAddr BCSCTL1_ADDR = 0x57;
+  static constexpr MemAddr BCSCTL2_ADDR = 0x58;
+
+  // Watch crystal on LFXT1 and the typical VLO frequency
+  static constexpr uint32_t LFXT1_HZ = 32768;
+  static constexpr uint32_t VLO_HZ = 12000;
+
+ protected:
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override;
+
+ private:
+  struct Epoch {
+    uint64_t cycle;
+    uint64_t ticks;
+  };
+
+  void Update();
+  uint32_t GetLFXT1();
+
+  const uint64_t* cycles{nullptr};
+  std::vector<std::function<void()>> listeners;
+  std::array<uint32_t, 3> frequency{};
+  std::array<Epoch, 3> epoch{};
+  // Virtual time in nanoseconds, kept across PUCs
+  Epoch time_epoch{};
+  uint16_t dcoctl_index;
+  uint16_t bcsctl1_index;
+  uint16_t bcsctl2_index;
+  uint16_t bcsctl3_index;
 };
 
 #endif
\ No newline at end of file
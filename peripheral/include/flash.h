@@ -0,0 +1,143 @@
+#ifndef flash_h
+#define flash_h
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "clock.h"
+#include "peripheral.h"
+#include "processor.h"
+
+union FCTL1_Union {
+  struct {
+    uint8_t : 1;
+    uint8_t ERASE : 1;
+    uint8_t MERAS : 1;
+    uint8_t : 3;
+    uint8_t WRT : 1;
+    uint8_t BLKWRT : 1;
+    uint8_t FWKEY : 8;
+  };
+  uint16_t val;
+};
+
+union FCTL2_Union {
+  struct {
+    uint8_t FNx : 6;
+    uint8_t FSSELx : 2;
+    uint8_t FWKEY : 8;
+  };
+  uint16_t val;
+};
+
+union FCTL3_Union {
+  struct {
+    uint8_t BUSY : 1;
+    uint8_t KEYV : 1;
+    uint8_t ACCVIFG : 1;
+    uint8_t WAIT : 1;
+    uint8_t LOCK : 1;
+    uint8_t EMEX : 1;
+    uint8_t LOCKA : 1;
+    uint8_t FAIL : 1;
+    uint8_t FWKEY : 8;
+  };
+  uint16_t val;
+};
+
+enum class FLASH_OP { NONE, PROGRAM, ERASE, BLOCK, BLOCK_END };
+
+/**
+ * @brief Flash controller with segment and mass erase, byte, word and block
+ * writes, and the lock bits
+ *
+ * Writes to the device's information and main memory are routed through
+ * the controller and only change flash when it's been set up for it. Erase
+ * and program times come from the timing generator clock. Running from
+ * flash the CPU is held until the operation is done, running from RAM BUSY
+ * is set and cleared by a scheduled event. Contents can be kept in a file
+ * that persists across runs.
+ */
+class Flash : public Peripheral {
+ public:
+  Flash(Clock* clock, Processor* proc);
+  ~Flash() override;
+
+  void Attach(Memory* mem) override;
+  void Reset() override;
+  void Save(Snapshot& snapshot) override;
+  void Load(Snapshot& snapshot) override;
+  void SetPuc(std::function<void()> puc);
+  void SetBacking(const std::string& path);
+  void IoWrite(uint16_t index, MemAddr addr, uint16_t val,
+               bool byte) override;
+  // ACCVIE is in IE1, which the watchdog owns, call this when it changes
+  void UpdateInterrupts();
+
+  static constexpr MemAddr IE1_ADDR = 0x0000;
+  static constexpr MemAddr FCTL1_ADDR = 0x0128;
+  static constexpr MemAddr FCTL2_ADDR = 0x012A;
+  static constexpr MemAddr FCTL3_ADDR = 0x012C;
+
+  static constexpr MemAddr SEGMENT_A = 0x10C0;
+  static constexpr uint32_t INFO_SEGMENT = 64;
+  static constexpr uint32_t MAIN_SEGMENT = 512;
+  static constexpr uint32_t BLOCK_SIZE = 64;
+
+  static constexpr uint8_t PASSWORD = 0xA5;
+  static constexpr uint8_t READ_PASSWORD = 0x96;
+  static constexpr uint8_t ACCVIE = 0x20;
+
+  // Timing generator clocks per operation
+  static constexpr uint32_t WORD_TICKS = 30;
+  static constexpr uint32_t BLOCK_FIRST_TICKS = 20;
+  static constexpr uint32_t BLOCK_NEXT_TICKS = 8;
+  static constexpr uint32_t BLOCK_END_TICKS = 6;
+  static constexpr uint32_t SEGMENT_ERASE_TICKS = 4819;
+  static constexpr uint32_t MASS_ERASE_TICKS = 10593;
+
+ protected:
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override;
+
+ private:
+  static constexpr uint16_t FLASH_INDEX = 0xFFFF;
+
+  void WriteFlash(MemAddr addr, uint16_t val, bool byte);
+  void Erase(MemAddr addr, FCTL1_Union ctl);
+  void EraseRange(MemAddr addr, uint32_t size);
+  void Program(MemAddr addr, uint16_t val, bool byte);
+  bool IsProtected(MemAddr addr);
+  uint64_t GetCycles(uint32_t ticks);
+  void Start(FLASH_OP op, uint32_t ticks);
+  void Event(uint64_t cycle);
+  void Finish();
+  void AccessViolation();
+  void Puc();
+  void Store(MemAddr addr, uint32_t size);
+
+  Clock* clock;
+  Processor* proc;
+  const Device* device;
+  Scheduler* scheduler;
+  InterruptController* irq;
+  std::function<void()> puc;
+  size_t event_id;
+  size_t puc_id;
+
+  uint16_t ctl1_index;
+  uint16_t ctl2_index;
+  uint16_t ctl3_index;
+
+  FLASH_OP op{FLASH_OP::NONE};
+  // The last write filled up the 64 byte block
+  bool block_full{false};
+
+  // KEYV survives the PUC it caused
+  bool key_violation{false};
+
+  uint8_t* backing{nullptr};
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef input_log_h
+#define input_log_h
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "processor.h"
+
+enum class INPUT : uint8_t { PORT, ADC, UART };
+
+enum class INPUT_MODE { LIVE, RECORD, REPLAY };
+
+/**
+ * @brief Input from outside the machine, unit and index pick the port and
+ * pin or the ADC channel
+ *
+ */
+struct InputEvent {
+  uint64_t cycle;
+  INPUT source;
+  uint8_t unit;
+  uint8_t index;
+  uint16_t val;
+};
+
+/**
+ * @brief The machine's only non-deterministic inputs, kept so a run can be
+ * repeated exactly
+ *
+ * Everything else, interrupt timing included, follows from the state and
+ * the cycle count. Driven inputs are pin and analog levels set from outside
+ * at any time, received inputs are taken by a peripheral at a scheduled
+ * cycle, like a byte arriving at the UART. While replaying, live inputs are
+ * ignored, driven ones are applied again at the cycle they came in and
+ * received ones are handed back at the cycle they were taken. Outputs were
+ * already passed on the first time and are held back.
+ */
+class InputLog {
+ public:
+  typedef std::function<void(const InputEvent& event)> Apply;
+
+  InputLog(Processor* proc);
+  ~InputLog(){};
+
+  void SetApply(Apply apply) { this->apply = apply; }
+  void SetMode(INPUT_MODE mode);
+  INPUT_MODE GetMode() { return mode; }
+  bool IsReplaying() { return mode == INPUT_MODE::REPLAY; }
+  bool Drive(INPUT source, uint8_t unit, uint8_t index, uint16_t val);
+  void Received(INPUT source, uint64_t cycle, uint16_t val);
+  bool Replay(INPUT source, uint64_t cycle, uint16_t& val);
+  void Seek(size_t index);
+  void Clear();
+  size_t GetSize() { return events.size(); }
+  const std::vector<InputEvent>& GetEvents() { return events; }
+
+ private:
+  bool IsDriven(const InputEvent& event) {
+    return event.source != INPUT::UART;
+  }
+  void Event(uint64_t cycle);
+  void Schedule();
+
+  Scheduler* scheduler;
+  const uint64_t* cycles;
+  size_t event_id;
+  Apply apply;
+  INPUT_MODE mode{INPUT_MODE::LIVE};
+  bool applying{false};
+
+  std::vector<InputEvent> events;
+  // Next driven and next received event to replay
+  size_t driven{0};
+  size_t received{0};
+};
+
+#endif
@@ -1,15 +0,0 @@
-#ifndef p1_h
-#define p1_h
-
-#include <cstdint>
-#include <map>
-
-#include "peripheral.h"
-
-class P1 : public Peripheral {
- public:
-  P1();
-  ~P1(){};
-};
-
-#endif
\ No newline at end of file
@@ -1,18 +1,81 @@
 #ifndef peripheral_h
 #define peripheral_h
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
-class Peripheral {
-protected:
- std::vector<int16_t> memory_mapped_io;
+#include "memory.h"
 
+class InputLog;
+
+enum class HOOK : uint8_t { NONE = 0, READ = 1, WRITE = 2, READ_WRITE = 3 };
+
+/**
+ * @brief Describes one memory mapped peripheral register
+ *
+ * Bits outside of read_mask read back as zero, bits outside of write_mask
+ * keep their value on writes. The hooks select which of ReadCallback() and
+ * WriteCallback() get called.
+ */
+struct RegisterDescriptor {
+  std::string name;
+  MemAddr addr;
+  uint8_t width;
+  uint16_t reset{0};
+  uint16_t read_mask{0xFFFF};
+  uint16_t write_mask{0xFFFF};
+  HOOK hooks{HOOK::NONE};
+
+  bool HasHook(HOOK hook) const {
+    return static_cast<uint8_t>(hooks) & static_cast<uint8_t>(hook);
+  }
+  bool IsPlain() const;
+};
+
+/**
+ * @brief Base class for peripherals, registers live in memory and only
+ * registers with side effects are routed through the peripheral
+ *
+ */
+class Peripheral : public IoDevice {
  public:
   Peripheral(){};
-  ~Peripheral(){};
-  void ReadCallback();
-  void WriteCallback();
+  virtual ~Peripheral(){};
+
+  virtual void Attach(Memory* mem);
+  virtual void Reset();
+  // Registers live in memory, only state kept outside of it is saved
+  virtual void Save(Snapshot& snapshot){};
+  virtual void Load(Snapshot& snapshot){};
+  const std::vector<RegisterDescriptor>& GetRegisters() { return registers; }
+  void SetInputLog(InputLog* input_log) { this->input_log = input_log; }
+
+  uint16_t IoRead(uint16_t index, MemAddr addr, bool byte) override;
+  void IoWrite(uint16_t index, MemAddr addr, uint16_t val, bool byte) override;
+
+ protected:
+  virtual uint16_t ReadCallback(const RegisterDescriptor& reg, uint16_t val);
+  virtual void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                             uint16_t val);
+
+  uint16_t AddRegister(RegisterDescriptor reg);
+  uint16_t GetValue(uint16_t index);
+  void SetValue(uint16_t index, uint16_t val);
+
+  Memory* mem{nullptr};
+  std::vector<RegisterDescriptor> registers;
+  // Inputs from outside go through it when set, for record and replay
+  InputLog* input_log{nullptr};
+};
+
+class PeripheralException : public std::exception {
+  std::string _msg;
+
+ public:
+  PeripheralException(const std::string& msg) : _msg(msg) {}
+
+  virtual const char* what() const noexcept override { return _msg.c_str(); }
 };
 
-#endif
\ No newline at end of file
+#endif
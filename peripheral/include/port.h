@@ -0,0 +1,80 @@
+#ifndef port_h
+#define port_h
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+#include "clock.h"
+#include "peripheral.h"
+#include "processor.h"
+#include "vcd.h"
+
+struct PortConfig {
+  uint8_t number;
+  // PxIN, the other registers follow in the order of the REGISTER offsets
+  MemAddr base_addr;
+  MemAddr sel2_addr;
+  uint8_t vector;
+};
+
+/**
+ * @brief Digital I/O port with pin change interrupts
+ *
+ * Pins are driven by the port when PxDIR is set and from outside through
+ * SetInput() otherwise, an undriven input follows its pull resistor when
+ * PxREN is set. PxIN is kept up to date in memory so reads are plain.
+ */
+class Port : public Peripheral {
+ public:
+  Port(Clock* clock, Processor* proc, PortConfig config);
+  ~Port() override{};
+
+  void Reset() override;
+  void Save(Snapshot& snapshot) override;
+  void Load(Snapshot& snapshot) override;
+  void SetOutput(std::ostream* output);
+  void SetInput(uint8_t pin, bool level);
+  void SetTrace(VcdWriter* vcd);
+  uint8_t GetPins() { return pins; }
+  uint8_t GetNumber() { return config.number; }
+
+  static constexpr int PINS = 8;
+  static constexpr PortConfig P1{1, 0x20, 0x41, InterruptController::PORT1};
+  static constexpr PortConfig P2{2, 0x28, 0x42, InterruptController::PORT2};
+
+  // Register offsets from base_addr
+  static constexpr uint8_t IN = 0;
+  static constexpr uint8_t OUT = 1;
+  static constexpr uint8_t DIR = 2;
+  static constexpr uint8_t IFG = 3;
+  static constexpr uint8_t IES = 4;
+  static constexpr uint8_t IE = 5;
+  static constexpr uint8_t SEL = 6;
+  static constexpr uint8_t REN = 7;
+
+ protected:
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override;
+
+ private:
+  uint8_t GetLevels();
+  bool IsReplaying();
+  void Update();
+  void UpdateInterrupts();
+
+  Clock* clock;
+  InterruptController* irq;
+  const uint64_t* cycles;
+  PortConfig config;
+  std::ostream* output{&std::cout};
+  VcdWriter* vcd{nullptr};
+  std::array<char, PINS> vcd_ids{};
+
+  // Pins driven from outside and the levels they are driven to
+  uint8_t driven{0};
+  uint8_t input{0};
+  uint8_t pins{0};
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef sample_stream_h
+#define sample_stream_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Recorded analog input, a file of little endian 16 bit samples taken
+ * at a fixed rate
+ *
+ * The file is mapped rather than read so long recordings cost nothing up
+ * front, samples are looked up by virtual time and the last one is held
+ * once the recording runs out.
+ */
+class SampleStream {
+ public:
+  SampleStream(const std::string& path, uint32_t rate);
+  ~SampleStream();
+  SampleStream(const SampleStream&) = delete;
+  SampleStream& operator=(const SampleStream&) = delete;
+
+  uint16_t GetSample(uint64_t nanoseconds);
+  size_t GetCount() { return count; }
+
+ private:
+  const uint8_t* data{nullptr};
+  size_t size{0};
+  size_t count{0};
+  uint32_t rate;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef stimulus_h
+#define stimulus_h
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "port.h"
+#include "processor.h"
+
+/**
+ * @brief Drives port pins from a list of timed changes
+ *
+ * Each line is "<cycle> P<port>.<pin> <0|1>", blank lines and lines
+ * starting with '#' are skipped. Only the next change is scheduled.
+ */
+class Stimulus {
+ public:
+  Stimulus(Processor* proc);
+  ~Stimulus(){};
+
+  void AddPort(Port* port);
+  void Load(const std::string& path);
+  void Load(std::istream& input);
+  size_t GetRemaining() { return changes.size() - next; }
+
+ private:
+  struct Change {
+    uint64_t cycle;
+    uint8_t port;
+    uint8_t pin;
+    bool level;
+  };
+
+  void Event(uint64_t cycle);
+  void Schedule();
+
+  Scheduler* scheduler;
+  size_t event_id;
+  std::map<uint8_t, Port*> ports;
+  std::vector<Change> changes;
+  size_t next{0};
+};
+
+#endif
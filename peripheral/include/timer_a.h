@@ -0,0 +1,132 @@
+#ifndef timer_a_h
+#define timer_a_h
+
+#include <array>
+#include <cstdint>
+
+#include "clock.h"
+#include "peripheral.h"
+#include "processor.h"
+
+enum class TIMER_MODE { STOP, UP, CONTINUOUS, UP_DOWN };
+
+union TACTL_Union {
+  struct {
+    uint8_t TAIFG : 1;
+    uint8_t TAIE : 1;
+    uint8_t TACLR : 1;
+    uint8_t : 1;
+    uint8_t MCx : 2;
+    uint8_t IDx : 2;
+    uint8_t TASSELx : 2;
+    uint8_t : 6;
+  };
+  uint16_t val;
+};
+
+union TACCTL_Union {
+  struct {
+    uint8_t CCIFG : 1;
+    uint8_t COV : 1;
+    uint8_t OUT : 1;
+    uint8_t CCI : 1;
+    uint8_t CCIE : 1;
+    uint8_t OUTMODx : 3;
+    uint8_t CAP : 1;
+    uint8_t : 1;
+    uint8_t SCCI : 1;
+    uint8_t SCS : 1;
+    uint8_t CCISx : 2;
+    uint8_t CMx : 2;
+  };
+  uint16_t val;
+};
+
+struct TimerAConfig {
+  MemAddr ctl_addr;
+  MemAddr iv_addr;
+  uint8_t ccr0_vector;
+  uint8_t vector;
+};
+
+/**
+ * @brief Timer_A3 on top of the CPU cycle count
+ *
+ * TAR isn't incremented every cycle. The count is anchored at a clock tick
+ * and derived from the elapsed ticks when it's read, and the next compare
+ * or overflow is worked out ahead of time and handed to the scheduler.
+ * Flags that are already set aren't scheduled again.
+ */
+class TimerA : public Peripheral {
+ public:
+  TimerA(Clock* clock, Processor* proc, TimerAConfig config);
+  ~TimerA() override{};
+
+  void Reset() override;
+  void Save(Snapshot& snapshot) override;
+  void Load(Snapshot& snapshot) override;
+  uint16_t GetTAR();
+
+  static constexpr int CHANNELS = 3;
+  static constexpr TimerAConfig TIMER0{0x0160, 0x012E,
+                                       InterruptController::TIMER0_A0,
+                                       InterruptController::TIMER0_A1};
+  static constexpr TimerAConfig TIMER1{0x0180, 0x011E,
+                                       InterruptController::TIMER1_A0,
+                                       InterruptController::TIMER1_A1};
+
+  // TAIV values
+  static constexpr uint16_t IV_NONE = 0x00;
+  static constexpr uint16_t IV_CCR1 = 0x02;
+  static constexpr uint16_t IV_CCR2 = 0x04;
+  static constexpr uint16_t IV_TAIFG = 0x0A;
+
+ protected:
+  uint16_t ReadCallback(const RegisterDescriptor& reg, uint16_t val) override;
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override;
+
+ private:
+  static constexpr uint64_t NEVER = UINT64_MAX;
+
+  uint64_t GetSourceTicks(uint64_t cycle);
+  void Sync();
+  void Advance(uint64_t counts);
+  uint64_t CountsUntil(uint16_t val);
+  void Reschedule();
+  void Event(uint64_t cycle);
+  void WriteControl(uint16_t val);
+  void WriteCaptureControl(int channel, uint16_t old_val);
+  uint16_t ReadVector();
+  void UpdateInterrupts();
+
+  Clock* clock;
+  Scheduler* scheduler;
+  InterruptController* irq;
+  const uint64_t* cycles;
+  TimerAConfig config;
+  size_t event_id;
+
+  uint16_t ctl_index;
+  uint16_t tar_index;
+  uint16_t iv_index;
+  std::array<uint16_t, CHANNELS> cctl_index;
+  std::array<uint16_t, CHANNELS> ccr_index;
+
+  // Settings the count is derived from, kept so the count can be brought up
+  // to date with the old settings when they change
+  TIMER_MODE mode{TIMER_MODE::STOP};
+  int source{0};
+  uint64_t divider{1};
+  uint16_t period{0};
+
+  // TAR and direction as of anchor, a tick of the source clock
+  uint16_t tar{0};
+  bool down{false};
+  uint64_t anchor{0};
+
+  // Counts past anchor of the scheduled event
+  uint64_t pending{NEVER};
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef uart_h
+#define uart_h
+
+#include <cstdint>
+
+#include "clock.h"
+#include "peripheral.h"
+#include "processor.h"
+#include "ring_buffer.h"
+
+typedef RingBuffer<uint8_t, 1 << 14> SerialBuffer;
+
+union UCAxCTL0_Union {
+  struct {
+    uint8_t UCSYNC : 1;
+    uint8_t UCMODEx : 2;
+    uint8_t UCSPB : 1;
+    uint8_t UC7BIT : 1;
+    uint8_t UCMSB : 1;
+    uint8_t UCPAR : 1;
+    uint8_t UCPEN : 1;
+  };
+  uint8_t val;
+};
+
+union UCAxCTL1_Union {
+  struct {
+    uint8_t UCSWRST : 1;
+    uint8_t UCTXBRK : 1;
+    uint8_t UCTXADDR : 1;
+    uint8_t UCDORM : 1;
+    uint8_t UCBRKIE : 1;
+    uint8_t UCRXEIE : 1;
+    uint8_t UCSSELx : 2;
+  };
+  uint8_t val;
+};
+
+union UCAxMCTL_Union {
+  struct {
+    uint8_t UCOS16 : 1;
+    uint8_t UCBRSx : 3;
+    uint8_t UCBRFx : 4;
+  };
+  uint8_t val;
+};
+
+/**
+ * @brief USCI_A0 in UART mode
+ *
+ * Frames take the time given by the baud rate settings on BRCLK and are
+ * handed to the scheduler rather than shifted bit by bit. Transmitted bytes
+ * go into the tx ring buffer and received bytes are taken from the rx ring
+ * buffer, the host end of both is drained and filled from another thread.
+ */
+class Uart : public Peripheral {
+ public:
+  Uart(Clock* clock, Processor* proc);
+  ~Uart() override{};
+
+  void Reset() override;
+  void Save(Snapshot& snapshot) override;
+  void Load(Snapshot& snapshot) override;
+  SerialBuffer& GetTxBuffer() { return tx_buffer; }
+  SerialBuffer& GetRxBuffer() { return rx_buffer; }
+  uint64_t GetDropped() { return dropped; }
+  uint64_t GetFrameTicks();
+
+  static constexpr MemAddr IE2_ADDR = 0x0001;
+  static constexpr MemAddr IFG2_ADDR = 0x0003;
+  static constexpr MemAddr UCA0ABCTL_ADDR = 0x005D;
+  static constexpr MemAddr UCA0CTL0_ADDR = 0x0060;
+  static constexpr MemAddr UCA0CTL1_ADDR = 0x0061;
+  static constexpr MemAddr UCA0BR0_ADDR = 0x0062;
+  static constexpr MemAddr UCA0BR1_ADDR = 0x0063;
+  static constexpr MemAddr UCA0MCTL_ADDR = 0x0064;
+  static constexpr MemAddr UCA0STAT_ADDR = 0x0065;
+  static constexpr MemAddr UCA0RXBUF_ADDR = 0x0066;
+  static constexpr MemAddr UCA0TXBUF_ADDR = 0x0067;
+
+  // IE2/IFG2 bits
+  static constexpr uint8_t UCA0RXIE = 0x01;
+  static constexpr uint8_t UCA0TXIE = 0x02;
+  static constexpr uint8_t UCA0RXIFG = 0x01;
+  static constexpr uint8_t UCA0TXIFG = 0x02;
+
+  // UCA0STAT bits
+  static constexpr uint8_t UCBUSY = 0x01;
+  static constexpr uint8_t UCOE = 0x20;
+  static constexpr uint8_t UCLISTEN = 0x80;
+
+ protected:
+  uint16_t ReadCallback(const RegisterDescriptor& reg, uint16_t val) override;
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override;
+
+ private:
+  bool GetSource(CLOCK& source);
+  uint64_t FrameEnd();
+  void StartFrame(uint8_t val);
+  void TransmitDone(uint64_t cycle);
+  void Poll(uint64_t cycle);
+  void Receive(uint8_t val);
+  void SetFlag(uint8_t flag, bool set);
+  void SetBusy(bool busy);
+  void UpdateInterrupts();
+
+  Clock* clock;
+  Scheduler* scheduler;
+  InterruptController* irq;
+  const uint64_t* cycles;
+  size_t tx_id;
+  size_t rx_id;
+
+  uint16_t ie_index;
+  uint16_t ifg_index;
+  uint16_t ctl0_index;
+  uint16_t ctl1_index;
+  uint16_t br0_index;
+  uint16_t br1_index;
+  uint16_t mctl_index;
+  uint16_t stat_index;
+  uint16_t rxbuf_index;
+  uint16_t txbuf_index;
+
+  SerialBuffer tx_buffer;
+  SerialBuffer rx_buffer;
+  uint64_t dropped{0};
+
+  // Byte in the shift register and whether UCA0TXBUF is waiting behind it
+  bool shifting{false};
+  uint8_t shift{0};
+  bool tx_full{false};
+};
+
+#endif
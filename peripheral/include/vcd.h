@@ -0,0 +1,48 @@
+#ifndef vcd_h
+#define vcd_h
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streams one bit signals to a Value Change Dump file
+ *
+ * Changes are formatted into a buffer that is written out whenever it fills
+ * up, so a long run costs a write per BUFFER_SIZE bytes of output. Times
+ * are in nanoseconds of virtual time.
+ */
+class VcdWriter {
+ public:
+  VcdWriter(){};
+  ~VcdWriter();
+
+  void Open(const std::string& path);
+  void Close();
+  bool IsOpen() { return file != nullptr; }
+  char AddSignal(const std::string& scope, const std::string& name,
+                 bool initial);
+  void Change(uint64_t time, char id, bool val);
+  void Flush();
+
+  static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+ private:
+  struct Signal {
+    std::string scope;
+    std::string name;
+    char id;
+    bool initial;
+  };
+
+  void WriteHeader();
+
+  FILE* file{nullptr};
+  std::string buffer;
+  std::vector<Signal> signals;
+  bool header{false};
+  uint64_t time{0};
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef watchdog_h
+#define watchdog_h
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "clock.h"
+#include "peripheral.h"
+#include "processor.h"
+
+union WDTCTL_Union {
+  struct {
+    uint8_t WDTISx : 2;
+    uint8_t WDTSSEL : 1;
+    uint8_t WDTCNTCL : 1;
+    uint8_t WDTTMSEL : 1;
+    uint8_t WDTNMI : 1;
+    uint8_t WDTNMIES : 1;
+    uint8_t WDTHOLD : 1;
+    uint8_t WDTPW : 8;
+  };
+  uint16_t val;
+};
+
+/**
+ * @brief WDT+ in watchdog and interval timer mode
+ *
+ * WDTCNT isn't incremented every cycle. The count is kept as of an anchor
+ * tick of the source clock and the next expiry is handed to the scheduler.
+ * An expiry in watchdog mode or a bad password requests a PUC, which is
+ * carried out by the owner once the current instruction has finished.
+ */
+class Watchdog : public Peripheral {
+ public:
+  Watchdog(Clock* clock, Processor* proc);
+  ~Watchdog() override{};
+
+  void Reset() override;
+  void Save(Snapshot& snapshot) override;
+  void Load(Snapshot& snapshot) override;
+  void SetPuc(std::function<void()> puc);
+  void AddListener(std::function<void()> listener);
+  uint16_t GetCount();
+
+  static constexpr MemAddr IE1_ADDR = 0x0000;
+  static constexpr MemAddr IFG1_ADDR = 0x0002;
+  static constexpr MemAddr WDTCTL_ADDR = 0x0120;
+
+  static constexpr uint8_t PASSWORD = 0x5A;
+  static constexpr uint8_t READ_PASSWORD = 0x69;
+  static constexpr uint8_t WDTIE = 0x01;
+  static constexpr uint8_t WDTIFG = 0x01;
+
+  // Source clock ticks per expiry for WDTISx
+  static constexpr uint32_t INTERVALS[4] = {32768, 8192, 512, 64};
+
+ protected:
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override;
+
+ private:
+  uint64_t GetSourceTicks();
+  void Sync();
+  void Reschedule();
+  void Event(uint64_t cycle);
+  void Puc();
+  void UpdateInterrupts();
+
+  Clock* clock;
+  Scheduler* scheduler;
+  InterruptController* irq;
+  const uint64_t* cycles;
+  std::function<void()> puc;
+  std::vector<std::function<void()>> listeners;
+  size_t event_id;
+  size_t puc_id;
+
+  uint16_t ctl_index;
+  uint16_t ie_index;
+  uint16_t ifg_index;
+  WDTCTL_Union ctl;
+
+  // WDTCNT as of anchor, a tick of the source clock
+  uint64_t count{0};
+  uint64_t anchor{0};
+
+  // WDTIFG survives the PUC it caused
+  bool expired{false};
+};
+
+#endif
@@ -0,0 +1,282 @@
+#include "adc10.h"
+
+#include "input_log.h"
+
+Adc10::Adc10(Clock* clock, Processor* proc)
+    : clock(clock),
+      scheduler(&proc->scheduler),
+      irq(&proc->irq),
+      cycles(&proc->cycles) {
+  // ADC10B1 is only changed by the DTC
+  dtc0_index = AddRegister({"ADC10DTC0", ADC10DTC0_ADDR, 1, 0x00, 0xFF,
+                            ADC10FETCH | ADC10CT | ADC10TB});
+  dtc1_index = AddRegister({"ADC10DTC1", ADC10DTC1_ADDR, 1});
+  AddRegister({"ADC10AE0", ADC10AE0_ADDR, 1});
+  ctl0_index = AddRegister({"ADC10CTL0", ADC10CTL0_ADDR, 2, 0x0000, 0xFFFF,
+                            0xFFFF, HOOK::WRITE});
+  ctl1_index =
+      AddRegister({"ADC10CTL1", ADC10CTL1_ADDR, 2, 0x0000, 0xFFFF, 0xFFFE});
+  mem_index =
+      AddRegister({"ADC10MEM", ADC10MEM_ADDR, 2, 0x0000, 0xFFFF, 0x0000});
+  sa_index = AddRegister({"ADC10SA", ADC10SA_ADDR, 2, 0x0200, 0xFFFF, 0xFFFE,
+                          HOOK::WRITE});
+
+  // Temperature sensor at 25C against VREF+ = 1.5V, (VCC - VSS) / 2
+  inputs[10] = 672;
+  inputs[11] = 511;
+
+  event_id = scheduler->Add([this](uint64_t cycle) { Event(cycle); });
+
+  // Servicing the interrupt resets ADC10IFG
+  irq->SetAcknowledge(InterruptController::ADC10, [this]() {
+    ADC10CTL0_Union ctl0;
+    ctl0.val = GetValue(ctl0_index);
+    ctl0.ADC10IFG = 0;
+    SetValue(ctl0_index, ctl0.val);
+    UpdateInterrupts();
+  });
+}
+
+void Adc10::Reset() {
+  Peripheral::Reset();
+  Stop();
+  transfers = 0;
+  dtc_done = false;
+  UpdateInterrupts();
+}
+
+/**
+ * @brief The conversion sequence and the fixed input levels, sample streams
+ * are attached by the host and keep playing from virtual time
+ *
+ */
+void Adc10::Save(Snapshot& snapshot) {
+  snapshot.Put(inputs);
+  snapshot.Put(active);
+  snapshot.Put(converting);
+  snapshot.Put(stopping);
+  snapshot.Put(channel);
+  snapshot.Put(transfers);
+  snapshot.Put(dtc_done);
+}
+
+void Adc10::Load(Snapshot& snapshot) {
+  snapshot.Get(inputs);
+  snapshot.Get(active);
+  snapshot.Get(converting);
+  snapshot.Get(stopping);
+  snapshot.Get(channel);
+  snapshot.Get(transfers);
+  snapshot.Get(dtc_done);
+}
+
+/**
+ * @brief Fixed 10 bit value for a channel without a stream
+ *
+ */
+void Adc10::SetInput(uint8_t channel, uint16_t val) {
+  if (input_log != nullptr && !input_log->Drive(INPUT::ADC, 0, channel, val)) {
+    return;
+  }
+  inputs.at(channel) = val & 0x3FF;
+}
+
+void Adc10::SetStream(uint8_t channel, std::shared_ptr<SampleStream> stream) {
+  streams.at(channel) = stream;
+}
+
+/**
+ * @brief CPU cycles for the sample and hold time plus 13 ADC10CLK cycles of
+ * conversion, for a conversion started at cycle
+ *
+ */
+uint64_t Adc10::GetConversionCycles(uint64_t cycle) {
+  constexpr uint64_t SAMPLE_TICKS[4] = {4, 8, 16, 64};
+  constexpr uint64_t CONVERSION_TICKS = 13;
+
+  ADC10CTL0_Union ctl0;
+  ctl0.val = GetValue(ctl0_index);
+  ADC10CTL1_Union ctl1;
+  ctl1.val = GetValue(ctl1_index);
+  auto ticks = (SAMPLE_TICKS[ctl0.ADC10SHTx] + CONVERSION_TICKS) *
+               (ctl1.ADC10DIVx + 1);
+
+  CLOCK source;
+  switch (ctl1.ADC10SSELx) {
+    case 0: {
+      // ADC10OSC isn't part of the clock tree
+      unsigned __int128 scaled = ticks;
+      scaled *= clock->GetFrequency(CLOCK::MCLK);
+      return static_cast<uint64_t>((scaled + ADC10OSC_HZ - 1) / ADC10OSC_HZ);
+    }
+    case 1:
+      source = CLOCK::ACLK;
+      break;
+    case 2:
+      return ticks;
+    default:
+      source = CLOCK::SMCLK;
+      break;
+  }
+  auto start = clock->GetTicks(source, cycle);
+  return clock->GetCycle(source, start + ticks) - cycle;
+}
+
+void Adc10::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                          uint16_t val) {
+  auto index = static_cast<uint16_t>(&reg - registers.data());
+  if (index == ctl0_index) {
+    ADC10CTL0_Union previous;
+    previous.val = old_val;
+    ADC10CTL0_Union ctl0;
+    ctl0.val = val;
+    ADC10CTL1_Union ctl1;
+    ctl1.val = GetValue(ctl1_index);
+
+    if (!ctl0.ADC10ON) {
+      Stop();
+    } else if (previous.ENC && !ctl0.ENC) {
+      // Single conversions are aborted, the other modes finish first
+      if (ctl1.CONSEQx == 0) {
+        Stop();
+      } else {
+        stopping = true;
+      }
+    }
+
+    if (ctl0.ADC10SC) {
+      ctl0.ADC10SC = 0;
+      SetValue(ctl0_index, ctl0.val);
+      if (ctl0.ENC && ctl0.ADC10ON && !converting) {
+        if (!active) {
+          active = true;
+          stopping = false;
+          channel = ctl1.INCHx;
+          SetBusy(true);
+        }
+        Start(*cycles);
+      }
+    }
+  } else if (index == sa_index) {
+    // Writing ADC10SA restarts the DTC at the first block
+    transfers = 0;
+    dtc_done = false;
+    SetValue(dtc0_index, GetValue(dtc0_index) & ~ADC10B1);
+  }
+  UpdateInterrupts();
+}
+
+void Adc10::Start(uint64_t cycle) {
+  converting = true;
+  scheduler->Schedule(event_id, cycle + GetConversionCycles(cycle));
+}
+
+void Adc10::Stop() {
+  scheduler->Cancel(event_id);
+  active = false;
+  converting = false;
+  stopping = false;
+  SetBusy(false);
+}
+
+/**
+ * @brief End of a conversion, the sequence carries on straight away with
+ * MSC set and on the next ADC10SC otherwise
+ *
+ */
+void Adc10::Event(uint64_t cycle) {
+  converting = false;
+  Store(Sample(cycle));
+
+  ADC10CTL0_Union ctl0;
+  ctl0.val = GetValue(ctl0_index);
+  ADC10CTL1_Union ctl1;
+  ctl1.val = GetValue(ctl1_index);
+  bool sequence = ctl1.CONSEQx & 0x01;
+  bool repeat = ctl1.CONSEQx & 0x02;
+
+  bool more;
+  if (sequence && channel > 0) {
+    channel--;
+    more = true;
+  } else {
+    channel = ctl1.INCHx;
+    more = repeat && !stopping;
+  }
+
+  if (!more) {
+    Stop();
+  } else if (ctl0.MSC) {
+    Start(cycle);
+  }
+  UpdateInterrupts();
+}
+
+uint16_t Adc10::Sample(uint64_t cycle) {
+  auto& stream = streams[channel];
+  if (stream) {
+    return stream->GetSample(clock->GetNanoseconds(cycle)) & 0x3FF;
+  }
+  return inputs[channel];
+}
+
+/**
+ * @brief Put a result in ADC10MEM and, with ADC10DTC1 set, move it to
+ * memory
+ *
+ * The DTC fills ADC10DTC1 words from ADC10SA, or two such blocks one after
+ * the other with ADC10TB, and ADC10IFG is set once a block is full.
+ */
+void Adc10::Store(uint16_t val) {
+  ADC10CTL1_Union ctl1;
+  ctl1.val = GetValue(ctl1_index);
+  if (ctl1.ADC10DF) {
+    // Left justified two's complement
+    val = static_cast<uint16_t>((val - 512) << 6);
+  }
+  SetValue(mem_index, val);
+
+  auto block_size = GetValue(dtc1_index);
+  if (block_size == 0 || dtc_done) {
+    SetFlag();
+    return;
+  }
+
+  auto dtc0 = GetValue(dtc0_index);
+  bool two_blocks = dtc0 & ADC10TB;
+  bool second = two_blocks && (dtc0 & ADC10B1);
+  auto offset = transfers + (second ? block_size : 0);
+  mem->WriteRaw(GetValue(sa_index) + 2 * offset, val, false);
+
+  if (++transfers < block_size) {
+    return;
+  }
+  transfers = 0;
+  SetFlag();
+  if (two_blocks) {
+    SetValue(dtc0_index, dtc0 ^ ADC10B1);
+  }
+  if ((!two_blocks || second) && !(dtc0 & ADC10CT)) {
+    dtc_done = true;
+  }
+}
+
+void Adc10::SetBusy(bool busy) {
+  ADC10CTL1_Union ctl1;
+  ctl1.val = GetValue(ctl1_index);
+  ctl1.ADC10BUSY = busy;
+  SetValue(ctl1_index, ctl1.val);
+}
+
+void Adc10::SetFlag() {
+  ADC10CTL0_Union ctl0;
+  ctl0.val = GetValue(ctl0_index);
+  ctl0.ADC10IFG = 1;
+  SetValue(ctl0_index, ctl0.val);
+}
+
+void Adc10::UpdateInterrupts() {
+  ADC10CTL0_Union ctl0;
+  ctl0.val = GetValue(ctl0_index);
+  irq->Set(InterruptController::ADC10, ctl0.ADC10IE && ctl0.ADC10IFG);
+}
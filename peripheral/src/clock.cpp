@@ -16,22 +16,196 @@ F_DCO Clock::MakePair(int a, int b) {
 }
 
 Clock::Clock() {
+  // Datasheet reference points
   frequency_map.emplace(MakePair(0, 0), MHZ(0.06));
-  frequency_map.emplace(MakePair(0, 3), MHZ(0.12));
-  frequency_map.emplace(MakePair(1, 3), MHZ(0.15));
-  frequency_map.emplace(MakePair(2, 3), MHZ(0.21));
-  frequency_map.emplace(MakePair(3, 3), MHZ(0.30));
-  frequency_map.emplace(MakePair(4, 3), MHZ(0.41));
-  frequency_map.emplace(MakePair(5, 3), MHZ(0.58));
-  frequency_map.emplace(MakePair(6, 3), MHZ(0.80));
-  frequency_map.emplace(MakePair(7, 3), MHZ(1.2));
-  frequency_map.emplace(MakePair(8, 3), MHZ(1.6));
-  frequency_map.emplace(MakePair(9, 3), MHZ(2.3));
-  frequency_map.emplace(MakePair(10, 3), MHZ(3.4));
-  frequency_map.emplace(MakePair(11, 3), MHZ(4.25));
-  frequency_map.emplace(MakePair(12, 3), MHZ(6.0));
-  frequency_map.emplace(MakePair(13, 3), MHZ(7.8));
-  frequency_map.emplace(MakePair(14, 3), MHZ(12));
-  frequency_map.emplace(MakePair(15, 3), MHZ(15.25));
+  for (int rsel = 0; rsel < dco::RSEL_STEPS; rsel++) {
+    frequency_map.emplace(MakePair(rsel, 3), MHZ(dco::DCO3_MHZ[rsel]));
+  }
   frequency_map.emplace(MakePair(15, 7), MHZ(21));
+
+  dcoctl_index = AddRegister({"DCOCTL", DCOCTL_ADDR, 1, 0x60, 0xFF, 0xFF,
+                              HOOK::WRITE});
+  bcsctl1_index = AddRegister({"BCSCTL1", BCSCTL1_ADDR, 1, 0x87, 0xFF, 0xFF,
+                               HOOK::WRITE});
+  bcsctl2_index = AddRegister({"BCSCTL2", BCSCTL2_ADDR, 1, 0x00, 0xFF, 0xFF,
+                               HOOK::WRITE});
+  bcsctl3_index = AddRegister({"BCSCTL3", BCSCTL3_ADDR, 1, 0x05, 0xFF, 0xFF,
+                               HOOK::WRITE});
+  Reset();
+}
+
+/**
+ * @brief Register values after PUC
+ *
+ */
+void Clock::Reset() {
+  Peripheral::Reset();
+  DCO.val = GetValue(dcoctl_index);
+  BCSCTL1.val = GetValue(bcsctl1_index);
+  BCSCTL2.val = GetValue(bcsctl2_index);
+  BCSCTL3.val = GetValue(bcsctl3_index);
+
+  auto now = cycles ? *cycles : 0;
+  epoch.fill({now, 0});
+  // The cycle count only goes back when the whole machine is restarted
+  time_epoch = {now, (now < time_epoch.cycle) ? 0 : GetNanoseconds(now)};
+  Update();
+}
+
+void Clock::Save(Snapshot& snapshot) {
+  snapshot.Put(frequency);
+  snapshot.Put(epoch);
+  snapshot.Put(time_epoch);
+}
+
+/**
+ * @brief Frequencies and epochs are restored as they were, the control
+ * registers come back with memory
+ *
+ */
+void Clock::Load(Snapshot& snapshot) {
+  snapshot.Get(frequency);
+  snapshot.Get(epoch);
+  snapshot.Get(time_epoch);
+  DCO.val = GetValue(dcoctl_index);
+  BCSCTL1.val = GetValue(bcsctl1_index);
+  BCSCTL2.val = GetValue(bcsctl2_index);
+  BCSCTL3.val = GetValue(bcsctl3_index);
+}
+
+/**
+ * @brief CPU cycle counter used to keep tick counts continuous across clock
+ * changes
+ *
+ */
+void Clock::SetCycleCounter(const uint64_t* cycles) {
+  this->cycles = cycles;
+  Reset();
+}
+
+void Clock::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                          uint16_t val) {
+  switch (reg.addr) {
+    case DCOCTL_ADDR:
+      DCO.val = val;
+      break;
+    case BCSCTL1_ADDR:
+      BCSCTL1.val = val;
+      break;
+    case BCSCTL2_ADDR:
+      BCSCTL2.val = val;
+      break;
+    case BCSCTL3_ADDR:
+      BCSCTL3.val = val;
+      break;
+  }
+
+  // Tick counts so far were at the old rates
+  auto now = cycles ? *cycles : 0;
+  for (size_t x = 0; x < epoch.size(); x++) {
+    epoch[x] = {now, GetTicks(static_cast<CLOCK>(x), now)};
+  }
+  time_epoch = {now, GetNanoseconds(now)};
+  Update();
+
+  for (auto& listener : listeners) {
+    listener();
+  }
+}
+
+/**
+ * @brief Called after any change to the clock rates
+ *
+ */
+void Clock::AddListener(std::function<void()> listener) {
+  listeners.push_back(listener);
+}
+
+uint32_t Clock::GetLFXT1() {
+  // LFXT1Sx = 2 selects the VLO, anything else the watch crystal
+  return (BCSCTL3.LFXT1Sz == 2) ? VLO_HZ : LFXT1_HZ;
+}
+
+/**
+ * @brief Recalculate MCLK/SMCLK/ACLK from the current register values
+ *
+ */
+void Clock::Update() {
+  auto dcoclk = GetDCO();
+  auto lfxt1clk = GetLFXT1();
+
+  auto mclk = (BCSCTL2.SELMx < 2) ? dcoclk : lfxt1clk;
+  auto smclk = BCSCTL2.SELS ? lfxt1clk : dcoclk;
+  frequency[static_cast<int>(CLOCK::MCLK)] = mclk >> BCSCTL2.DIVMx;
+  frequency[static_cast<int>(CLOCK::SMCLK)] = smclk >> BCSCTL2.DIVSx;
+  frequency[static_cast<int>(CLOCK::ACLK)] = lfxt1clk >> BCSCTL1.DIVAx;
+}
+
+uint32_t Clock::GetFrequency(CLOCK clock) {
+  return frequency[static_cast<int>(clock)];
+}
+
+/**
+ * @brief Ticks of a clock that have elapsed by the given CPU (MCLK) cycle
+ *
+ */
+uint64_t Clock::GetTicks(CLOCK clock, uint64_t cycle) {
+  auto& start = epoch[static_cast<int>(clock)];
+  if (cycle <= start.cycle) {
+    return start.ticks;
+  }
+  unsigned __int128 elapsed = cycle - start.cycle;
+  return start.ticks + static_cast<uint64_t>(
+                           elapsed * GetFrequency(clock) /
+                           GetFrequency(CLOCK::MCLK));
+}
+
+/**
+ * @brief First CPU (MCLK) cycle by which the clock has reached ticks, at the
+ * current settings
+ *
+ */
+uint64_t Clock::GetCycle(CLOCK clock, uint64_t ticks) {
+  auto& start = epoch[static_cast<int>(clock)];
+  if (ticks <= start.ticks) {
+    return start.cycle;
+  }
+  unsigned __int128 remaining = ticks - start.ticks;
+  auto freq = GetFrequency(clock);
+  return start.cycle + static_cast<uint64_t>(
+                           (remaining * GetFrequency(CLOCK::MCLK) + freq - 1) /
+                           freq);
+}
+
+/**
+ * @brief Virtual time at the given CPU (MCLK) cycle
+ *
+ */
+uint64_t Clock::GetNanoseconds(uint64_t cycle) {
+  if (cycle <= time_epoch.cycle) {
+    return time_epoch.ticks;
+  }
+  unsigned __int128 elapsed = cycle - time_epoch.cycle;
+  return time_epoch.ticks +
+         static_cast<uint64_t>(elapsed * 1000000000 /
+                               GetFrequency(CLOCK::MCLK));
+}
+
+/**
+ * @brief DCO frequency for the current RSELx/DCOx/MODx settings
+ *
+ * MODx mixes f(DCO) with f(DCO + 1) over a period of 32 DCOCLK cycles.
+ */
+uint32_t Clock::GetDCO() {
+  constexpr uint64_t MOD_PERIOD = 32;
+
+  auto index = BCSCTL1.RSELx * dco::DCO_STEPS + DCO.DCOx;
+  uint64_t f_dco = dco::TABLE[index];
+  if (DCO.DCOx == dco::DCO_STEPS - 1 || DCO.MODx == 0) {
+    return static_cast<uint32_t>(f_dco);
+  }
+  uint64_t f_dco1 = dco::TABLE[index + 1];
+  uint64_t mod = DCO.MODx;
+  return static_cast<uint32_t>((MOD_PERIOD * f_dco * f_dco1) /
+                               ((mod * f_dco) + ((MOD_PERIOD - mod) * f_dco1)));
 }
\ No newline at end of file
@@ -0,0 +1,429 @@
+#include "flash.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+Flash::Flash(Clock* clock, Processor* proc)
+    : clock(clock),
+      proc(proc),
+      device(proc->device),
+      scheduler(&proc->scheduler),
+      irq(&proc->irq) {
+  ctl1_index = AddRegister(
+      {"FCTL1", FCTL1_ADDR, 2, 0x9600, 0xFFFF, 0xFFFF, HOOK::WRITE});
+  ctl2_index = AddRegister(
+      {"FCTL2", FCTL2_ADDR, 2, 0x9642, 0xFFFF, 0xFFFF, HOOK::WRITE});
+  ctl3_index = AddRegister(
+      {"FCTL3", FCTL3_ADDR, 2, 0x9658, 0xFFFF, 0xFFFF, HOOK::WRITE});
+
+  event_id = scheduler->Add([this](uint64_t cycle) { Event(cycle); });
+  puc_id = scheduler->Add([this](uint64_t cycle) {
+    if (this->puc) {
+      this->puc();
+    }
+  });
+
+  // Accepting the NMI resets ACCVIE
+  irq->SetAcknowledge(InterruptController::NMI, [this]() {
+    mem->WriteRaw(IE1_ADDR, mem->ReadRaw(IE1_ADDR, true) & ~ACCVIE, true);
+    UpdateInterrupts();
+  });
+}
+
+Flash::~Flash() {
+  if (backing != nullptr) {
+    munmap(backing, Memory::MEM_SIZE);
+  }
+}
+
+/**
+ * @brief Map the registers and route writes to information and main memory
+ * through the controller
+ *
+ */
+void Flash::Attach(Memory* mem) {
+  Peripheral::Attach(mem);
+  mem->MapWrites(device->info.start, device->info.size, this, FLASH_INDEX);
+  mem->MapWrites(device->flash.start, device->flash.size, this, FLASH_INDEX);
+}
+
+/**
+ * @brief Any operation in progress is abandoned, flash keeps its contents
+ *
+ */
+void Flash::Reset() {
+  Peripheral::Reset();
+  if (key_violation) {
+    FCTL3_Union status;
+    status.val = GetValue(ctl3_index);
+    status.KEYV = 1;
+    SetValue(ctl3_index, status.val);
+    key_violation = false;
+  }
+  op = FLASH_OP::NONE;
+  block_full = false;
+  scheduler->Cancel(event_id);
+  scheduler->Cancel(puc_id);
+  if (mem != nullptr) {
+    UpdateInterrupts();
+  }
+}
+
+void Flash::Save(Snapshot& snapshot) {
+  snapshot.Put(op);
+  snapshot.Put(block_full);
+  snapshot.Put(key_violation);
+}
+
+/**
+ * @brief Flash contents come back with memory, a backing file is brought in
+ * line with them
+ *
+ */
+void Flash::Load(Snapshot& snapshot) {
+  snapshot.Get(op);
+  snapshot.Get(block_full);
+  snapshot.Get(key_violation);
+  Store(device->info.start, device->info.size);
+  Store(device->flash.start, device->flash.size);
+}
+
+/**
+ * @brief Called to carry out the PUC a bad password causes
+ *
+ */
+void Flash::SetPuc(std::function<void()> puc) { this->puc = puc; }
+
+/**
+ * @brief Keep flash in a 64KiB file laid out like the address space. An
+ * existing file is loaded over the current contents, a new one is filled
+ * from them, and every erase or write is stored in it.
+ *
+ */
+void Flash::SetBacking(const std::string& path) {
+  if (mem == nullptr) {
+    throw PeripheralException("flash isn't attached to memory");
+  }
+  auto fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    throw PeripheralException("could not open " + path + ": " +
+                              strerror(errno));
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      (info.st_size != 0 && info.st_size != Memory::MEM_SIZE)) {
+    close(fd);
+    throw PeripheralException(path + " isn't a flash image");
+  }
+  bool existing = (info.st_size != 0);
+  if (!existing && ftruncate(fd, Memory::MEM_SIZE) != 0) {
+    close(fd);
+    throw PeripheralException("could not size " + path + ": " +
+                              strerror(errno));
+  }
+  auto mapped = mmap(nullptr, Memory::MEM_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    throw PeripheralException("could not map " + path + ": " +
+                              strerror(errno));
+  }
+
+  if (backing != nullptr) {
+    munmap(backing, Memory::MEM_SIZE);
+  }
+  backing = static_cast<uint8_t*>(mapped);
+  for (auto region : {device->info, device->flash}) {
+    if (existing) {
+      mem->WriteBlock(region.start, backing + region.start, region.size);
+    } else {
+      Store(region.start, region.size);
+    }
+  }
+}
+
+/**
+ * @brief Writes to flash arrive with FLASH_INDEX, the rest are registers
+ *
+ */
+void Flash::IoWrite(uint16_t index, MemAddr addr, uint16_t val, bool byte) {
+  if (index == FLASH_INDEX) {
+    WriteFlash(addr, val, byte);
+    return;
+  }
+  Peripheral::IoWrite(index, addr, val, byte);
+}
+
+void Flash::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                          uint16_t val) {
+  auto index = static_cast<uint16_t>(&reg - registers.data());
+  if ((val >> 8) != PASSWORD) {
+    SetValue(index, old_val);
+    key_violation = true;
+    Puc();
+    return;
+  }
+
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+  if (index == ctl1_index) {
+    // Only a block write can be changed while busy
+    if (status.BUSY && op != FLASH_OP::BLOCK) {
+      SetValue(index, old_val);
+      AccessViolation();
+      return;
+    }
+    FCTL1_Union ctl;
+    ctl.val = (READ_PASSWORD << 8) | (val & 0x00C6);
+    SetValue(index, ctl.val);
+    // Clearing BLKWRT between writes ends the block
+    if (op == FLASH_OP::BLOCK && status.WAIT && !ctl.BLKWRT) {
+      Start(FLASH_OP::BLOCK_END, BLOCK_END_TICKS);
+    }
+  } else if (index == ctl2_index) {
+    if (status.BUSY) {
+      SetValue(index, old_val);
+      AccessViolation();
+      return;
+    }
+    SetValue(index, (READ_PASSWORD << 8) | (val & 0x00FF));
+  } else if (index == ctl3_index) {
+    FCTL3_Union previous;
+    previous.val = old_val;
+    FCTL3_Union next;
+    next.val = val;
+    next.BUSY = previous.BUSY;
+    next.WAIT = previous.WAIT;
+    // LOCKA toggles when written with a one
+    next.LOCKA = previous.LOCKA ^ next.LOCKA;
+    next.FWKEY = READ_PASSWORD;
+    bool exit = next.EMEX;
+    next.EMEX = 0;
+    SetValue(index, next.val);
+    if (exit && op != FLASH_OP::NONE) {
+      scheduler->Cancel(event_id);
+      op = FLASH_OP::NONE;
+      next.BUSY = 0;
+      next.WAIT = 1;
+      SetValue(index, next.val);
+    }
+    UpdateInterrupts();
+  }
+}
+
+/**
+ * @brief A write to flash, which erases or programs depending on FCTL1
+ *
+ */
+void Flash::WriteFlash(MemAddr addr, uint16_t val, bool byte) {
+  FCTL1_Union ctl;
+  ctl.val = GetValue(ctl1_index);
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+
+  if (status.LOCK) {
+    AccessViolation();
+    return;
+  }
+  bool busy = (op == FLASH_OP::BLOCK) ? !status.WAIT : status.BUSY;
+  if (busy) {
+    AccessViolation();
+    return;
+  }
+
+  if (ctl.ERASE || ctl.MERAS) {
+    Erase(addr, ctl);
+    return;
+  }
+  if (!ctl.WRT) {
+    AccessViolation();
+    return;
+  }
+  if (ctl.BLKWRT) {
+    // The CPU can't fetch from flash during a block write
+    if (device->IsFlash(*proc->PC)) {
+      AccessViolation();
+      return;
+    }
+    auto ticks =
+        (op == FLASH_OP::BLOCK) ? BLOCK_NEXT_TICKS : BLOCK_FIRST_TICKS;
+    Program(addr, val, byte);
+    block_full = ((addr + (byte ? 1 : 2)) % BLOCK_SIZE) == 0;
+    Start(FLASH_OP::BLOCK, ticks);
+    return;
+  }
+  Program(addr, val, byte);
+  Start(FLASH_OP::PROGRAM, WORD_TICKS);
+}
+
+/**
+ * @brief Dummy write that starts a segment or mass erase
+ *
+ */
+void Flash::Erase(MemAddr addr, FCTL1_Union ctl) {
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+  if (ctl.MERAS) {
+    EraseRange(device->flash.start, device->flash.size);
+    // LOCKA keeps all of information memory from a mass erase
+    if (ctl.ERASE && !status.LOCKA) {
+      EraseRange(device->info.start, device->info.size);
+    }
+    Start(FLASH_OP::ERASE, MASS_ERASE_TICKS);
+    return;
+  }
+
+  auto size = device->info.Contains(addr) ? INFO_SEGMENT : MAIN_SEGMENT;
+  auto start = static_cast<MemAddr>(addr & ~(size - 1));
+  if (!IsProtected(start)) {
+    EraseRange(start, size);
+  }
+  Start(FLASH_OP::ERASE, SEGMENT_ERASE_TICKS);
+}
+
+void Flash::EraseRange(MemAddr addr, uint32_t size) {
+  std::vector<uint8_t> erased(size, 0xFF);
+  mem->WriteBlock(addr, erased.data(), size);
+  Store(addr, size);
+}
+
+/**
+ * @brief Programming can only clear bits
+ *
+ */
+void Flash::Program(MemAddr addr, uint16_t val, bool byte) {
+  if (IsProtected(addr)) {
+    return;
+  }
+  auto old_val = mem->ReadRaw(addr, byte);
+  mem->WriteRaw(addr, old_val & val, byte);
+  Store(addr, byte ? 1 : 2);
+}
+
+/**
+ * @brief Segment A is locked by LOCKA
+ *
+ */
+bool Flash::IsProtected(MemAddr addr) {
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+  return status.LOCKA && addr >= SEGMENT_A && addr < device->info.GetEnd();
+}
+
+/**
+ * @brief CPU cycles until ticks of the timing generator have passed, it runs
+ * from FSSELx divided by FNx + 1
+ *
+ */
+uint64_t Flash::GetCycles(uint32_t ticks) {
+  FCTL2_Union ctl;
+  ctl.val = GetValue(ctl2_index);
+  auto source = CLOCK::SMCLK;
+  if (ctl.FSSELx == 0) {
+    source = CLOCK::ACLK;
+  } else if (ctl.FSSELx == 1) {
+    source = CLOCK::MCLK;
+  }
+  uint64_t divider = ctl.FNx + 1;
+  auto now = proc->cycles;
+  auto start = clock->GetTicks(source, now);
+  auto end = clock->GetCycle(source, start + ticks * divider);
+  return (end > now) ? end - now : 0;
+}
+
+/**
+ * @brief Time an operation. Running from flash the CPU is held until it's
+ * done, otherwise BUSY is set until the scheduler finishes it.
+ *
+ */
+void Flash::Start(FLASH_OP op, uint32_t ticks) {
+  this->op = op;
+  auto duration = GetCycles(ticks);
+  bool block = (op == FLASH_OP::BLOCK || op == FLASH_OP::BLOCK_END);
+  if (!block && device->IsFlash(*proc->PC)) {
+    proc->cycles += duration;
+    Finish();
+    return;
+  }
+
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+  status.BUSY = 1;
+  status.WAIT = (op != FLASH_OP::BLOCK);
+  SetValue(ctl3_index, status.val);
+  scheduler->Schedule(event_id, proc->cycles + duration);
+}
+
+void Flash::Event(uint64_t cycle) { Finish(); }
+
+void Flash::Finish() {
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+  if (op == FLASH_OP::BLOCK) {
+    status.WAIT = 1;
+    SetValue(ctl3_index, status.val);
+    FCTL1_Union ctl;
+    ctl.val = GetValue(ctl1_index);
+    if (block_full || !ctl.BLKWRT) {
+      Start(FLASH_OP::BLOCK_END, BLOCK_END_TICKS);
+    }
+    return;
+  }
+
+  if (op == FLASH_OP::ERASE) {
+    FCTL1_Union ctl;
+    ctl.val = GetValue(ctl1_index);
+    ctl.ERASE = 0;
+    ctl.MERAS = 0;
+    SetValue(ctl1_index, ctl.val);
+  }
+  status.BUSY = 0;
+  status.WAIT = 1;
+  SetValue(ctl3_index, status.val);
+  op = FLASH_OP::NONE;
+}
+
+void Flash::AccessViolation() {
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+  status.ACCVIFG = 1;
+  SetValue(ctl3_index, status.val);
+  UpdateInterrupts();
+}
+
+/**
+ * @brief Request a PUC once the current instruction has finished
+ *
+ */
+void Flash::Puc() {
+  scheduler->Cancel(event_id);
+  scheduler->Schedule(puc_id, proc->cycles);
+}
+
+/**
+ * @brief Copy flash to the backing file
+ *
+ */
+void Flash::Store(MemAddr addr, uint32_t size) {
+  if (backing != nullptr) {
+    mem->ReadBlock(addr, backing + addr, size);
+  }
+}
+
+/**
+ * @brief ACCVIFG requests an NMI when ACCVIE is set
+ *
+ */
+void Flash::UpdateInterrupts() {
+  FCTL3_Union status;
+  status.val = GetValue(ctl3_index);
+  bool pending =
+      status.ACCVIFG && (mem->ReadRaw(IE1_ADDR, true) & ACCVIE);
+  irq->Set(InterruptController::NMI, pending);
+}
@@ -0,0 +1,101 @@
+#include "input_log.h"
+
+InputLog::InputLog(Processor* proc)
+    : scheduler(&proc->scheduler), cycles(&proc->cycles) {
+  event_id = scheduler->Add([this](uint64_t cycle) { Event(cycle); });
+}
+
+void InputLog::SetMode(INPUT_MODE mode) {
+  this->mode = mode;
+  if (mode != INPUT_MODE::REPLAY) {
+    scheduler->Cancel(event_id);
+  }
+}
+
+/**
+ * @brief Called by a peripheral before it takes a level from outside,
+ * returns false if the level is to be ignored because of a replay
+ *
+ */
+bool InputLog::Drive(INPUT source, uint8_t unit, uint8_t index,
+                     uint16_t val) {
+  if (mode == INPUT_MODE::REPLAY && !applying) {
+    return false;
+  }
+  if (mode == INPUT_MODE::RECORD) {
+    events.push_back({*cycles, source, unit, index, val});
+  }
+  return true;
+}
+
+/**
+ * @brief Called by a peripheral that took an input at a scheduled cycle
+ *
+ */
+void InputLog::Received(INPUT source, uint64_t cycle, uint16_t val) {
+  if (mode == INPUT_MODE::RECORD) {
+    events.push_back({cycle, source, 0, 0, val});
+  }
+}
+
+/**
+ * @brief The input a peripheral took at this cycle when it was recorded, if
+ * it took one
+ *
+ */
+bool InputLog::Replay(INPUT source, uint64_t cycle, uint16_t& val) {
+  while (received < events.size() && events[received].source != source) {
+    received++;
+  }
+  if (received == events.size() || events[received].cycle != cycle) {
+    return false;
+  }
+  val = events[received++].val;
+  return true;
+}
+
+/**
+ * @brief Replay from the event at index on, driven events that are already
+ * due are applied straight away
+ *
+ */
+void InputLog::Seek(size_t index) {
+  mode = INPUT_MODE::REPLAY;
+  driven = index;
+  received = index;
+  Event(*cycles);
+}
+
+void InputLog::Clear() {
+  events.clear();
+  driven = 0;
+  received = 0;
+  scheduler->Cancel(event_id);
+}
+
+void InputLog::Event(uint64_t cycle) {
+  if (mode != INPUT_MODE::REPLAY) {
+    return;
+  }
+  applying = true;
+  for (; driven < events.size(); driven++) {
+    auto& event = events[driven];
+    if (!IsDriven(event)) {
+      continue;
+    }
+    if (event.cycle > *cycles) {
+      break;
+    }
+    apply(event);
+  }
+  applying = false;
+  Schedule();
+}
+
+void InputLog::Schedule() {
+  if (driven < events.size()) {
+    scheduler->Schedule(event_id, events[driven].cycle);
+  } else {
+    scheduler->Cancel(event_id);
+  }
+}
@@ -1,5 +0,0 @@
-#include "p1.h"
-
-P1::P1() {
-    this->memory_mapped_io.push_back(0x21);
-}
\ No newline at end of file
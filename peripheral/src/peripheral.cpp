@@ -1 +1,123 @@
-#include "peripheral.h"
\ No newline at end of file
+#include "peripheral.h"
+
+static uint16_t WidthMask(uint8_t width) {
+  return (width == 1) ? 0x00FF : 0xFFFF;
+}
+
+/**
+ * @brief Registers with full masks and no hooks are left as plain memory
+ *
+ */
+bool RegisterDescriptor::IsPlain() const {
+  auto mask = WidthMask(width);
+  return (read_mask & mask) == mask && (write_mask & mask) == mask &&
+         hooks == HOOK::NONE;
+}
+
+/**
+ * @brief Map the registers that have side effects into memory and put every
+ * register in its reset state
+ *
+ */
+void Peripheral::Attach(Memory* mem) {
+  this->mem = mem;
+  for (uint16_t index = 0; index < registers.size(); index++) {
+    auto& reg = registers[index];
+    if (reg.IsPlain()) {
+      continue;
+    }
+    auto mask = WidthMask(reg.width);
+    bool read = reg.HasHook(HOOK::READ) || (reg.read_mask & mask) != mask;
+    bool write = reg.HasHook(HOOK::WRITE) || (reg.write_mask & mask) != mask;
+    mem->MapIo(reg.addr, reg.width, this, index, read, write);
+  }
+  Reset();
+}
+
+/**
+ * @brief Register values after PUC, no callbacks are made
+ *
+ */
+void Peripheral::Reset() {
+  for (uint16_t index = 0; index < registers.size(); index++) {
+    SetValue(index, registers[index].reset);
+  }
+}
+
+uint16_t Peripheral::IoRead(uint16_t index, MemAddr addr, bool byte) {
+  auto& reg = registers[index];
+  auto val = GetValue(index) & reg.read_mask;
+  if (reg.HasHook(HOOK::READ)) {
+    val = ReadCallback(reg, val);
+  }
+  if (byte && reg.width == 2) {
+    val = (addr == reg.addr) ? (val & 0x00FF) : (val >> 8);
+  }
+  return val;
+}
+
+void Peripheral::IoWrite(uint16_t index, MemAddr addr, uint16_t val,
+                         bool byte) {
+  auto& reg = registers[index];
+  auto old_val = GetValue(index);
+  if (byte && reg.width == 2) {
+    auto shift = (addr - reg.addr) * 8;
+    val = (old_val & ~(0x00FF << shift)) | ((val & 0x00FF) << shift);
+  }
+  val = (old_val & ~reg.write_mask) | (val & reg.write_mask);
+  val &= WidthMask(reg.width);
+
+  SetValue(index, val);
+  if (reg.HasHook(HOOK::WRITE)) {
+    WriteCallback(reg, old_val, val);
+  }
+}
+
+/**
+ * @brief Value seen by reads of a register with HOOK::READ
+ *
+ */
+uint16_t Peripheral::ReadCallback(const RegisterDescriptor& reg,
+                                  uint16_t val) {
+  return val;
+}
+
+/**
+ * @brief Called after a register with HOOK::WRITE has been written, val has
+ * already been stored
+ *
+ */
+void Peripheral::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                               uint16_t val) {}
+
+/**
+ * @brief Describe a register, must happen before Attach()
+ *
+ */
+uint16_t Peripheral::AddRegister(RegisterDescriptor reg) {
+  if ((reg.width != 1 && reg.width != 2) || (reg.width == 2 && reg.addr % 2)) {
+    throw PeripheralException(reg.name + " has an invalid width");
+  }
+  registers.push_back(reg);
+  return static_cast<uint16_t>(registers.size() - 1);
+}
+
+/**
+ * @brief Stored register value, without masks or callbacks
+ *
+ */
+uint16_t Peripheral::GetValue(uint16_t index) {
+  if (mem == nullptr) {
+    return registers[index].reset;
+  }
+  auto& reg = registers[index];
+  return mem->ReadRaw(reg.addr, reg.width == 1);
+}
+
+void Peripheral::SetValue(uint16_t index, uint16_t val) {
+  if (mem == nullptr) {
+    return;
+  }
+  auto& reg = registers[index];
+  mem->WriteRaw(reg.addr, val, reg.width == 1);
+}
@@ -0,0 +1,125 @@
+#include "port.h"
+
+#include <iomanip>
+
+#include "input_log.h"
+
+Port::Port(Clock* clock, Processor* proc, PortConfig config)
+    : clock(clock), irq(&proc->irq), cycles(&proc->cycles), config(config) {
+  auto prefix = "P" + std::to_string(config.number);
+  auto addr = config.base_addr;
+  // PxIN follows the pins, writes are ignored
+  AddRegister({prefix + "IN", addr, 1, 0x00, 0xFF, 0x00});
+  AddRegister({prefix + "OUT", ++addr, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  AddRegister({prefix + "DIR", ++addr, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  AddRegister({prefix + "IFG", ++addr, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  AddRegister({prefix + "IES", ++addr, 1});
+  AddRegister({prefix + "IE", ++addr, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  AddRegister({prefix + "SEL", ++addr, 1});
+  AddRegister({prefix + "REN", ++addr, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  AddRegister({prefix + "SEL2", config.sel2_addr, 1});
+}
+
+/**
+ * @brief All pins are inputs after PUC, outside drivers are left alone
+ *
+ */
+void Port::Reset() {
+  Peripheral::Reset();
+  pins = GetLevels();
+  SetValue(IN, pins);
+  UpdateInterrupts();
+}
+
+void Port::Save(Snapshot& snapshot) {
+  snapshot.Put(driven);
+  snapshot.Put(input);
+  snapshot.Put(pins);
+}
+
+void Port::Load(Snapshot& snapshot) {
+  snapshot.Get(driven);
+  snapshot.Get(input);
+  snapshot.Get(pins);
+}
+
+void Port::SetOutput(std::ostream* output) { this->output = output; }
+
+/**
+ * @brief Drive a pin from outside, it only shows while PxDIR is clear
+ *
+ */
+void Port::SetInput(uint8_t pin, bool level) {
+  if (input_log != nullptr &&
+      !input_log->Drive(INPUT::PORT, config.number, pin, level)) {
+    return;
+  }
+  uint8_t mask = 1 << pin;
+  driven |= mask;
+  input = level ? (input | mask) : (input & ~mask);
+  Update();
+}
+
+/**
+ * @brief Record pin levels from now on, must be set before the first change
+ * is written
+ *
+ */
+void Port::SetTrace(VcdWriter* vcd) {
+  this->vcd = vcd;
+  auto scope = "P" + std::to_string(config.number);
+  for (int pin = 0; pin < PINS; pin++) {
+    vcd_ids[pin] = vcd->AddSignal(scope, scope + "." + std::to_string(pin),
+                                  (pins >> pin) & 1);
+  }
+}
+
+uint8_t Port::GetLevels() {
+  auto out = GetValue(OUT);
+  auto dir = GetValue(DIR);
+  auto pull = GetValue(REN) & ~driven;
+  return (dir & out) | (~dir & driven & input) | (~dir & pull & out);
+}
+
+/**
+ * @brief Work out the pin levels again, edges selected by PxIES set PxIFG
+ *
+ */
+void Port::Update() {
+  auto levels = GetLevels();
+  uint8_t changed = levels ^ pins;
+  if (changed) {
+    auto ies = GetValue(IES);
+    uint8_t edges = (changed & levels & ~ies) | (changed & ~levels & ies);
+    SetValue(IFG, GetValue(IFG) | edges);
+
+    if (vcd != nullptr && !IsReplaying()) {
+      auto time = clock->GetNanoseconds(*cycles);
+      for (int pin = 0; pin < PINS; pin++) {
+        if ((changed >> pin) & 1) {
+          vcd->Change(time, vcd_ids[pin], (levels >> pin) & 1);
+        }
+      }
+    }
+    pins = levels;
+    SetValue(IN, pins);
+  }
+  UpdateInterrupts();
+}
+
+void Port::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                         uint16_t val) {
+  if (reg.addr == config.base_addr + OUT && !IsReplaying()) {
+    *output << "P" << +config.number << "OUT: 0x" << std::hex << +val
+            << std::dec << "\n";
+  }
+  Update();
+}
+
+bool Port::IsReplaying() {
+  return input_log != nullptr && input_log->IsReplaying();
+}
+
+void Port::UpdateInterrupts() {
+  irq->Set(config.vector, GetValue(IE) & GetValue(IFG));
+}
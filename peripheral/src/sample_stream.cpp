@@ -0,0 +1,52 @@
+#include "sample_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "peripheral.h"
+
+SampleStream::SampleStream(const std::string& path, uint32_t rate)
+    : rate(rate) {
+  if (rate == 0) {
+    throw PeripheralException("sample rate of " + path + " is zero");
+  }
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw PeripheralException("could not open " + path + ": " +
+                              strerror(errno));
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < 2) {
+    close(fd);
+    throw PeripheralException(path + " has no samples");
+  }
+  size = info.st_size;
+  auto mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    throw PeripheralException("could not map " + path + ": " +
+                              strerror(errno));
+  }
+  madvise(mapped, size, MADV_SEQUENTIAL);
+  data = static_cast<const uint8_t*>(mapped);
+  count = size / 2;
+}
+
+SampleStream::~SampleStream() {
+  if (data != nullptr) {
+    munmap(const_cast<uint8_t*>(data), size);
+  }
+}
+
+uint16_t SampleStream::GetSample(uint64_t nanoseconds) {
+  unsigned __int128 index = nanoseconds;
+  index = index * rate / 1000000000;
+  auto position = (index < count) ? static_cast<size_t>(index) : count - 1;
+  auto sample = data + 2 * position;
+  return sample[0] | (sample[1] << 8);
+}
@@ -0,0 +1,82 @@
+#include "stimulus.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "peripheral.h"
+
+Stimulus::Stimulus(Processor* proc) : scheduler(&proc->scheduler) {
+  event_id = scheduler->Add([this](uint64_t cycle) { Event(cycle); });
+}
+
+void Stimulus::AddPort(Port* port) { ports[port->GetNumber()] = port; }
+
+void Stimulus::Load(const std::string& path) {
+  std::ifstream input(path);
+  if (!input) {
+    throw PeripheralException("could not open " + path);
+  }
+  Load(input);
+}
+
+/**
+ * @brief Replace the pending changes with the ones read from input
+ *
+ */
+void Stimulus::Load(std::istream& input) {
+  std::vector<Change> loaded;
+  std::string line;
+  for (int number = 1; std::getline(input, line); number++) {
+    std::istringstream fields(line);
+    std::string time;
+    if (!(fields >> time) || time[0] == '#') {
+      continue;
+    }
+
+    std::string signal;
+    int level = -1;
+    unsigned port = 0;
+    unsigned pin = Port::PINS;
+    char extra;
+    fields >> signal >> level;
+    bool valid = sscanf(signal.c_str(), "P%u.%u%c", &port, &pin, &extra) == 2;
+    if (!valid || pin >= Port::PINS || ports.count(port) == 0 ||
+        (level != 0 && level != 1) || (fields >> extra)) {
+      throw PeripheralException("invalid stimulus on line " +
+                                std::to_string(number) + ": " + line);
+    }
+    try {
+      loaded.push_back({std::stoull(time, nullptr, 0),
+                        static_cast<uint8_t>(port), static_cast<uint8_t>(pin),
+                        level == 1});
+    } catch (std::exception&) {
+      throw PeripheralException("invalid time on line " +
+                                std::to_string(number) + ": " + line);
+    }
+  }
+
+  std::stable_sort(loaded.begin(), loaded.end(),
+                   [](const Change& a, const Change& b) {
+                     return a.cycle < b.cycle;
+                   });
+  changes = loaded;
+  next = 0;
+  Schedule();
+}
+
+void Stimulus::Schedule() {
+  if (next < changes.size()) {
+    scheduler->Schedule(event_id, changes[next].cycle);
+  } else {
+    scheduler->Cancel(event_id);
+  }
+}
+
+void Stimulus::Event(uint64_t cycle) {
+  while (next < changes.size() && changes[next].cycle <= cycle) {
+    auto& change = changes[next++];
+    ports[change.port]->SetInput(change.pin, change.level);
+  }
+  Schedule();
+}
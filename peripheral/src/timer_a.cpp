@@ -0,0 +1,405 @@
+#include "timer_a.h"
+
+#include <algorithm>
+
+TimerA::TimerA(Clock* clock, Processor* proc, TimerAConfig config)
+    : clock(clock),
+      scheduler(&proc->scheduler),
+      irq(&proc->irq),
+      cycles(&proc->cycles),
+      config(config) {
+  auto ctl_addr = config.ctl_addr;
+  // CCI and SCCI follow the input, bit 9 is unused
+  constexpr uint16_t CCTL_WRITE_MASK = 0xF9F7;
+
+  ctl_index = AddRegister(
+      {"TACTL", ctl_addr, 2, 0x0000, 0x03F7, 0x03F7, HOOK::READ_WRITE});
+  for (int x = 0; x < CHANNELS; x++) {
+    cctl_index[x] =
+        AddRegister({"TACCTL" + std::to_string(x),
+                     static_cast<MemAddr>(ctl_addr + 2 + 2 * x), 2, 0x0000,
+                     0xFFFF, CCTL_WRITE_MASK, HOOK::READ_WRITE});
+  }
+  tar_index = AddRegister({"TAR", static_cast<MemAddr>(ctl_addr + 0x10), 2,
+                           0x0000, 0xFFFF, 0xFFFF, HOOK::READ_WRITE});
+  for (int x = 0; x < CHANNELS; x++) {
+    ccr_index[x] = AddRegister({"TACCR" + std::to_string(x),
+                                static_cast<MemAddr>(ctl_addr + 0x12 + 2 * x),
+                                2, 0x0000, 0xFFFF, 0xFFFF, HOOK::WRITE});
+  }
+  iv_index = AddRegister({"TAIV", config.iv_addr, 2, 0x0000, 0xFFFF, 0x0000,
+                          HOOK::READ});
+
+  event_id = scheduler->Add([this](uint64_t cycle) { Event(cycle); });
+  clock->AddListener([this]() { Reschedule(); });
+
+  // TACCR0 has its own vector, servicing it resets CCIFG
+  irq->SetAcknowledge(config.ccr0_vector, [this]() {
+    TACCTL_Union cctl;
+    cctl.val = GetValue(cctl_index[0]);
+    cctl.CCIFG = 0;
+    SetValue(cctl_index[0], cctl.val);
+    Reschedule();
+    UpdateInterrupts();
+  });
+}
+
+void TimerA::Reset() {
+  Peripheral::Reset();
+  mode = TIMER_MODE::STOP;
+  source = 0;
+  divider = 1;
+  period = 0;
+  tar = 0;
+  down = false;
+  anchor = 0;
+  pending = NEVER;
+  scheduler->Cancel(event_id);
+  UpdateInterrupts();
+}
+
+void TimerA::Save(Snapshot& snapshot) {
+  snapshot.Put(mode);
+  snapshot.Put(source);
+  snapshot.Put(divider);
+  snapshot.Put(period);
+  snapshot.Put(tar);
+  snapshot.Put(down);
+  snapshot.Put(anchor);
+  snapshot.Put(pending);
+}
+
+void TimerA::Load(Snapshot& snapshot) {
+  snapshot.Get(mode);
+  snapshot.Get(source);
+  snapshot.Get(divider);
+  snapshot.Get(period);
+  snapshot.Get(tar);
+  snapshot.Get(down);
+  snapshot.Get(anchor);
+  snapshot.Get(pending);
+}
+
+uint16_t TimerA::GetTAR() {
+  Sync();
+  return tar;
+}
+
+/**
+ * @brief Ticks of the selected clock, TACLK and INCLK aren't connected
+ *
+ */
+uint64_t TimerA::GetSourceTicks(uint64_t cycle) {
+  switch (source) {
+    case 1:
+      return clock->GetTicks(CLOCK::ACLK, cycle);
+    case 2:
+      return clock->GetTicks(CLOCK::SMCLK, cycle);
+  }
+  return 0;
+}
+
+/**
+ * @brief Bring TAR up to the current cycle, setting the flags of any events
+ * that were due on the way
+ *
+ */
+void TimerA::Sync() {
+  auto ticks = GetSourceTicks(*cycles);
+  if (mode == TIMER_MODE::STOP || source == 0 || source == 3) {
+    anchor = ticks;
+    return;
+  }
+
+  while (true) {
+    auto counts = (ticks > anchor) ? (ticks - anchor) / divider : 0;
+    if (counts < pending) {
+      Advance(counts);
+      anchor += counts * divider;
+      pending = (pending == NEVER) ? NEVER : pending - counts;
+      break;
+    }
+
+    Advance(pending);
+    anchor += pending * divider;
+
+    for (int x = 0; x < CHANNELS; x++) {
+      TACCTL_Union cctl;
+      cctl.val = GetValue(cctl_index[x]);
+      if (!cctl.CAP && GetValue(ccr_index[x]) == tar) {
+        cctl.CCIFG = 1;
+        SetValue(cctl_index[x], cctl.val);
+      }
+    }
+    if (tar == 0) {
+      TACTL_Union ctl;
+      ctl.val = GetValue(ctl_index);
+      ctl.TAIFG = 1;
+      SetValue(ctl_index, ctl.val);
+    }
+    Reschedule();
+    UpdateInterrupts();
+  }
+  SetValue(tar_index, tar);
+}
+
+/**
+ * @brief Move TAR on by a number of timer counts
+ *
+ */
+void TimerA::Advance(uint64_t counts) {
+  switch (mode) {
+    case TIMER_MODE::STOP:
+      return;
+    case TIMER_MODE::CONTINUOUS:
+      tar = static_cast<uint16_t>(tar + counts);
+      down = false;
+      return;
+    case TIMER_MODE::UP: {
+      if (period == 0 || counts == 0) {
+        return;
+      }
+      // Shrinking TACCR0 below TAR rolls the count over to zero
+      if (tar > period) {
+        counts--;
+        tar = 0;
+      }
+      tar = static_cast<uint16_t>((tar + counts) % (period + 1));
+      return;
+    }
+    case TIMER_MODE::UP_DOWN: {
+      if (period == 0 || counts == 0) {
+        return;
+      }
+      // TACCR0 below TAR, count down to zero first
+      if (tar > period) {
+        if (counts < tar) {
+          tar = static_cast<uint16_t>(tar - counts);
+          down = true;
+          return;
+        }
+        counts -= tar;
+        tar = 0;
+        down = false;
+      }
+      uint64_t span = 2 * static_cast<uint64_t>(period);
+      uint64_t position = down ? span - tar : tar;
+      position = (position + counts) % span;
+      tar = static_cast<uint16_t>(position <= period ? position
+                                                     : span - position);
+      down = position > period;
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Timer counts from the anchor until TAR next counts to val
+ *
+ */
+uint64_t TimerA::CountsUntil(uint16_t val) {
+  switch (mode) {
+    case TIMER_MODE::STOP:
+      return NEVER;
+    case TIMER_MODE::CONTINUOUS: {
+      uint16_t counts = val - tar;
+      return counts ? counts : 0x10000;
+    }
+    case TIMER_MODE::UP: {
+      if (period == 0 || val > period) {
+        return NEVER;
+      }
+      if (tar > period) {
+        return 1 + val;
+      }
+      uint64_t span = period + 1;
+      auto counts = (val + span - tar) % span;
+      return counts ? counts : span;
+    }
+    case TIMER_MODE::UP_DOWN: {
+      if (period == 0 || val > period) {
+        return NEVER;
+      }
+      if (tar > period) {
+        return tar - val;
+      }
+      uint64_t span = 2 * static_cast<uint64_t>(period);
+      uint64_t position = down ? span - tar : tar;
+      uint64_t best = NEVER;
+      for (uint64_t target : {static_cast<uint64_t>(val), span - val}) {
+        auto counts = (target + span - position) % span;
+        best = std::min(best, counts ? counts : span);
+      }
+      return best;
+    }
+  }
+  return NEVER;
+}
+
+/**
+ * @brief Schedule the next compare or overflow whose flag isn't already set
+ *
+ */
+void TimerA::Reschedule() {
+  pending = NEVER;
+  if (source == 1 || source == 2) {
+    for (int x = 0; x < CHANNELS; x++) {
+      TACCTL_Union cctl;
+      cctl.val = GetValue(cctl_index[x]);
+      if (!cctl.CAP && !cctl.CCIFG) {
+        pending = std::min(pending, CountsUntil(GetValue(ccr_index[x])));
+      }
+    }
+    TACTL_Union ctl;
+    ctl.val = GetValue(ctl_index);
+    if (!ctl.TAIFG) {
+      pending = std::min(pending, CountsUntil(0));
+    }
+  }
+
+  if (pending == NEVER) {
+    scheduler->Cancel(event_id);
+    return;
+  }
+  auto source_clock = (source == 1) ? CLOCK::ACLK : CLOCK::SMCLK;
+  auto deadline = clock->GetCycle(source_clock, anchor + pending * divider);
+  scheduler->Schedule(event_id, deadline);
+}
+
+void TimerA::Event(uint64_t cycle) {
+  Sync();
+  Reschedule();
+}
+
+uint16_t TimerA::ReadCallback(const RegisterDescriptor& reg, uint16_t val) {
+  auto index = static_cast<uint16_t>(&reg - registers.data());
+  Sync();
+  if (index == tar_index) {
+    return tar;
+  }
+  if (index == iv_index) {
+    return ReadVector();
+  }
+  // Flags may have been set by the sync
+  return GetValue(index) & reg.read_mask;
+}
+
+void TimerA::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                           uint16_t val) {
+  auto index = static_cast<uint16_t>(&reg - registers.data());
+
+  // Count up to now with the settings from before the write
+  Sync();
+
+  if (index == ctl_index) {
+    WriteControl(val);
+  } else if (index == tar_index) {
+    tar = val;
+    SetValue(tar_index, tar);
+  } else if (index == ccr_index[0]) {
+    period = val;
+  }
+  for (int x = 0; x < CHANNELS; x++) {
+    if (index == cctl_index[x]) {
+      WriteCaptureControl(x, old_val);
+    }
+  }
+  Reschedule();
+  UpdateInterrupts();
+}
+
+void TimerA::WriteControl(uint16_t val) {
+  TACTL_Union ctl;
+  ctl.val = val;
+  if (ctl.TACLR) {
+    // Clears TAR, the divider and the direction
+    tar = 0;
+    down = false;
+    ctl.TACLR = 0;
+    anchor = GetSourceTicks(*cycles);
+    SetValue(ctl_index, ctl.val);
+    SetValue(tar_index, tar);
+  }
+  mode = static_cast<TIMER_MODE>(ctl.MCx);
+  divider = static_cast<uint64_t>(1) << ctl.IDx;
+  if (source != ctl.TASSELx) {
+    source = ctl.TASSELx;
+    anchor = GetSourceTicks(*cycles);
+  }
+}
+
+/**
+ * @brief Capture inputs driven from software with CCISx = GND or VCC
+ *
+ */
+void TimerA::WriteCaptureControl(int channel, uint16_t old_val) {
+  TACCTL_Union previous;
+  previous.val = old_val;
+  TACCTL_Union cctl;
+  cctl.val = GetValue(cctl_index[channel]);
+  if (cctl.CCISx < 2) {
+    return;
+  }
+
+  bool input = (cctl.CCISx == 3);
+  cctl.CCI = input;
+  if (cctl.CAP && input != previous.CCI) {
+    auto edge = input ? 0b01 : 0b10;
+    if (cctl.CMx & edge) {
+      SetValue(ccr_index[channel], tar);
+      if (cctl.CCIFG) {
+        cctl.COV = 1;
+      }
+      cctl.CCIFG = 1;
+    }
+  }
+  SetValue(cctl_index[channel], cctl.val);
+}
+
+/**
+ * @brief Highest priority enabled TACCR1/TACCR2/TAIFG interrupt, its flag is
+ * cleared by the read
+ *
+ */
+uint16_t TimerA::ReadVector() {
+  for (int x = 1; x < CHANNELS; x++) {
+    TACCTL_Union cctl;
+    cctl.val = GetValue(cctl_index[x]);
+    if (cctl.CCIFG && cctl.CCIE) {
+      cctl.CCIFG = 0;
+      SetValue(cctl_index[x], cctl.val);
+      Reschedule();
+      UpdateInterrupts();
+      return (x == 1) ? IV_CCR1 : IV_CCR2;
+    }
+  }
+  TACTL_Union ctl;
+  ctl.val = GetValue(ctl_index);
+  if (ctl.TAIFG && ctl.TAIE) {
+    ctl.TAIFG = 0;
+    SetValue(ctl_index, ctl.val);
+    Reschedule();
+    UpdateInterrupts();
+    return IV_TAIFG;
+  }
+  return IV_NONE;
+}
+
+/**
+ * @brief Request lines for TACCR0 and for TACCR1/TACCR2/TAIFG
+ *
+ */
+void TimerA::UpdateInterrupts() {
+  TACCTL_Union cctl;
+  cctl.val = GetValue(cctl_index[0]);
+  irq->Set(config.ccr0_vector, cctl.CCIE && cctl.CCIFG);
+
+  TACTL_Union ctl;
+  ctl.val = GetValue(ctl_index);
+  bool pending = ctl.TAIE && ctl.TAIFG;
+  for (int x = 1; x < CHANNELS; x++) {
+    cctl.val = GetValue(cctl_index[x]);
+    pending = pending || (cctl.CCIE && cctl.CCIFG);
+  }
+  irq->Set(config.vector, pending);
+}
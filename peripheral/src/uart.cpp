@@ -0,0 +1,236 @@
+#include "uart.h"
+
+#include <algorithm>
+
+#include "input_log.h"
+
+Uart::Uart(Clock* clock, Processor* proc)
+    : clock(clock),
+      scheduler(&proc->scheduler),
+      irq(&proc->irq),
+      cycles(&proc->cycles) {
+  ie_index = AddRegister({"IE2", IE2_ADDR, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  // UCB0TXIFG is set after PUC as well
+  ifg_index =
+      AddRegister({"IFG2", IFG2_ADDR, 1, 0x0A, 0xFF, 0xFF, HOOK::WRITE});
+  AddRegister({"UCA0ABCTL", UCA0ABCTL_ADDR, 1});
+  AddRegister({"UCA0IRTCTL", 0x005E, 1});
+  AddRegister({"UCA0IRRCTL", 0x005F, 1});
+  ctl0_index = AddRegister({"UCA0CTL0", UCA0CTL0_ADDR, 1});
+  ctl1_index = AddRegister(
+      {"UCA0CTL1", UCA0CTL1_ADDR, 1, 0x01, 0xFF, 0xFF, HOOK::WRITE});
+  br0_index = AddRegister({"UCA0BR0", UCA0BR0_ADDR, 1});
+  br1_index = AddRegister({"UCA0BR1", UCA0BR1_ADDR, 1});
+  mctl_index = AddRegister({"UCA0MCTL", UCA0MCTL_ADDR, 1});
+  stat_index = AddRegister({"UCA0STAT", UCA0STAT_ADDR, 1, 0x00, 0xFF, 0xFE});
+  rxbuf_index = AddRegister(
+      {"UCA0RXBUF", UCA0RXBUF_ADDR, 1, 0x00, 0xFF, 0x00, HOOK::READ});
+  txbuf_index = AddRegister(
+      {"UCA0TXBUF", UCA0TXBUF_ADDR, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+
+  tx_id = scheduler->Add([this](uint64_t cycle) { TransmitDone(cycle); });
+  rx_id = scheduler->Add([this](uint64_t cycle) { Poll(cycle); });
+}
+
+/**
+ * @brief Held in reset with UCSWRST set after PUC, bytes still waiting in
+ * the ring buffers are kept
+ *
+ */
+void Uart::Reset() {
+  Peripheral::Reset();
+  scheduler->Cancel(tx_id);
+  scheduler->Cancel(rx_id);
+  shifting = false;
+  tx_full = false;
+  UpdateInterrupts();
+}
+
+/**
+ * @brief The shift register, the host side buffers aren't part of the
+ * machine and are left alone
+ *
+ */
+void Uart::Save(Snapshot& snapshot) {
+  snapshot.Put(shifting);
+  snapshot.Put(shift);
+  snapshot.Put(tx_full);
+}
+
+void Uart::Load(Snapshot& snapshot) {
+  snapshot.Get(shifting);
+  snapshot.Get(shift);
+  snapshot.Get(tx_full);
+}
+
+/**
+ * @brief BRCLK ticks per frame, start bit, data, parity and stop bits
+ *
+ * Bit times are counted in eighths of a BRCLK tick so the UCBRSx
+ * modulation averages out over the frame.
+ */
+uint64_t Uart::GetFrameTicks() {
+  UCAxCTL0_Union ctl0;
+  ctl0.val = GetValue(ctl0_index);
+  UCAxMCTL_Union mctl;
+  mctl.val = GetValue(mctl_index);
+
+  uint64_t prescaler = GetValue(br0_index) | (GetValue(br1_index) << 8);
+  prescaler = std::max<uint64_t>(prescaler, 1);
+  uint64_t bits = 1 + (ctl0.UC7BIT ? 7 : 8) + ctl0.UCPEN + (ctl0.UCSPB ? 2 : 1);
+  uint64_t eighths = mctl.UCOS16 ? 8 * (16 * prescaler + mctl.UCBRFx)
+                                 : 8 * prescaler + mctl.UCBRSx;
+  return (bits * eighths + 7) / 8;
+}
+
+/**
+ * @brief BRCLK, UCLK isn't connected
+ *
+ */
+bool Uart::GetSource(CLOCK& source) {
+  UCAxCTL1_Union ctl1;
+  ctl1.val = GetValue(ctl1_index);
+  switch (ctl1.UCSSELx) {
+    case 0:
+      return false;
+    case 1:
+      source = CLOCK::ACLK;
+      return true;
+  }
+  source = CLOCK::SMCLK;
+  return true;
+}
+
+/**
+ * @brief Cycle at which a frame started now ends, NEVER without a BRCLK
+ *
+ */
+uint64_t Uart::FrameEnd() {
+  CLOCK source;
+  if (!GetSource(source)) {
+    return Scheduler::NEVER;
+  }
+  auto start = clock->GetTicks(source, *cycles);
+  return clock->GetCycle(source, start + GetFrameTicks());
+}
+
+/**
+ * @brief Move a byte into the shift register, UCA0TXBUF is free again
+ *
+ */
+void Uart::StartFrame(uint8_t val) {
+  shift = val;
+  shifting = true;
+  SetBusy(true);
+  SetFlag(UCA0TXIFG, true);
+  scheduler->Schedule(tx_id, FrameEnd());
+}
+
+void Uart::TransmitDone(uint64_t cycle) {
+  shifting = false;
+  bool replaying = input_log != nullptr && input_log->IsReplaying();
+  if (!replaying && !tx_buffer.Push(shift)) {
+    dropped++;
+  }
+  if (GetValue(stat_index) & UCLISTEN) {
+    Receive(shift);
+  }
+  if (tx_full) {
+    tx_full = false;
+    StartFrame(static_cast<uint8_t>(GetValue(txbuf_index)));
+  } else {
+    SetBusy(false);
+  }
+  UpdateInterrupts();
+}
+
+/**
+ * @brief Take the next byte from the host, at most one per frame time
+ *
+ */
+void Uart::Poll(uint64_t cycle) {
+  uint8_t val;
+  bool received;
+  if (input_log != nullptr && input_log->IsReplaying()) {
+    uint16_t replayed;
+    received = input_log->Replay(INPUT::UART, cycle, replayed);
+    val = static_cast<uint8_t>(replayed);
+  } else {
+    received = rx_buffer.Pop(val);
+    if (received && input_log != nullptr) {
+      input_log->Received(INPUT::UART, cycle, val);
+    }
+  }
+  if (received) {
+    Receive(val);
+    UpdateInterrupts();
+  }
+  scheduler->Schedule(rx_id, FrameEnd());
+}
+
+void Uart::Receive(uint8_t val) {
+  if (GetValue(ifg_index) & UCA0RXIFG) {
+    SetValue(stat_index, GetValue(stat_index) | UCOE);
+  }
+  SetValue(rxbuf_index, val);
+  SetFlag(UCA0RXIFG, true);
+}
+
+uint16_t Uart::ReadCallback(const RegisterDescriptor& reg, uint16_t val) {
+  auto index = static_cast<uint16_t>(&reg - registers.data());
+  if (index == rxbuf_index) {
+    // Reading UCA0RXBUF resets the flag and the overrun error
+    SetFlag(UCA0RXIFG, false);
+    SetValue(stat_index, GetValue(stat_index) & ~UCOE);
+    UpdateInterrupts();
+  }
+  return val;
+}
+
+void Uart::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                         uint16_t val) {
+  auto index = static_cast<uint16_t>(&reg - registers.data());
+  UCAxCTL1_Union ctl1;
+  ctl1.val = GetValue(ctl1_index);
+
+  if (index == ctl1_index) {
+    if (ctl1.UCSWRST) {
+      constexpr uint8_t ERROR_FLAGS = 0x7E;
+      scheduler->Cancel(tx_id);
+      scheduler->Cancel(rx_id);
+      shifting = false;
+      tx_full = false;
+      SetBusy(false);
+      SetValue(stat_index, GetValue(stat_index) & ~ERROR_FLAGS);
+      SetValue(ie_index, GetValue(ie_index) & ~(UCA0RXIE | UCA0TXIE));
+      SetFlag(UCA0RXIFG, false);
+      SetFlag(UCA0TXIFG, true);
+    } else if (old_val & 0x01) {
+      scheduler->Schedule(rx_id, FrameEnd());
+    }
+  } else if (index == txbuf_index && !ctl1.UCSWRST) {
+    SetFlag(UCA0TXIFG, false);
+    if (shifting) {
+      tx_full = true;
+    } else {
+      StartFrame(static_cast<uint8_t>(val));
+    }
+  }
+  UpdateInterrupts();
+}
+
+void Uart::SetFlag(uint8_t flag, bool set) {
+  auto ifg = GetValue(ifg_index);
+  SetValue(ifg_index, set ? (ifg | flag) : (ifg & ~flag));
+}
+
+void Uart::SetBusy(bool busy) {
+  auto stat = GetValue(stat_index);
+  SetValue(stat_index, busy ? (stat | UCBUSY) : (stat & ~UCBUSY));
+}
+
+void Uart::UpdateInterrupts() {
+  auto pending = GetValue(ie_index) & GetValue(ifg_index);
+  irq->Set(InterruptController::USCI_RX, pending & UCA0RXIFG);
+  irq->Set(InterruptController::USCI_TX, pending & UCA0TXIFG);
+}
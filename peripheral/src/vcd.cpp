@@ -0,0 +1,113 @@
+#include "vcd.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "peripheral.h"
+
+VcdWriter::~VcdWriter() { Close(); }
+
+void VcdWriter::Open(const std::string& path) {
+  Close();
+  file = fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    throw PeripheralException("could not open " + path + ": " +
+                              strerror(errno));
+  }
+  buffer.reserve(BUFFER_SIZE + 64);
+  signals.clear();
+  header = false;
+  time = 0;
+}
+
+/**
+ * @brief Write out what is left, the header is written even with no changes
+ *
+ */
+void VcdWriter::Close() {
+  if (file == nullptr) {
+    return;
+  }
+  if (!header) {
+    WriteHeader();
+  }
+  Flush();
+  fclose(file);
+  file = nullptr;
+}
+
+/**
+ * @brief Declare a signal, only possible before the first change
+ *
+ */
+char VcdWriter::AddSignal(const std::string& scope, const std::string& name,
+                          bool initial) {
+  if (header) {
+    throw PeripheralException("VCD signals added after the first change");
+  }
+  // Identifiers are single printable characters from '!'
+  auto id = static_cast<char>('!' + signals.size());
+  if (id > '~') {
+    throw PeripheralException("too many VCD signals");
+  }
+  signals.push_back({scope, name, id, initial});
+  return id;
+}
+
+void VcdWriter::Change(uint64_t time, char id, bool val) {
+  if (file == nullptr) {
+    return;
+  }
+  if (!header) {
+    WriteHeader();
+  }
+  // Times never go backwards, even across a reset of the cycle count
+  if (time > this->time) {
+    this->time = time;
+    buffer += '#';
+    buffer += std::to_string(time);
+    buffer += '\n';
+  }
+  buffer += val ? '1' : '0';
+  buffer += id;
+  buffer += '\n';
+  if (buffer.size() >= BUFFER_SIZE) {
+    Flush();
+  }
+}
+
+void VcdWriter::Flush() {
+  if (file != nullptr && !buffer.empty()) {
+    fwrite(buffer.data(), 1, buffer.size(), file);
+    fflush(file);
+  }
+  buffer.clear();
+}
+
+void VcdWriter::WriteHeader() {
+  header = true;
+  buffer += "$version msp430emu $end\n$timescale 1ns $end\n";
+  std::string scope;
+  for (auto& signal : signals) {
+    if (signal.scope != scope) {
+      if (!scope.empty()) {
+        buffer += "$upscope $end\n";
+      }
+      scope = signal.scope;
+      buffer += "$scope module " + scope + " $end\n";
+    }
+    buffer += "$var wire 1 ";
+    buffer += signal.id;
+    buffer += " " + signal.name + " $end\n";
+  }
+  if (!scope.empty()) {
+    buffer += "$upscope $end\n";
+  }
+  buffer += "$enddefinitions $end\n#0\n$dumpvars\n";
+  for (auto& signal : signals) {
+    buffer += signal.initial ? '1' : '0';
+    buffer += signal.id;
+    buffer += '\n';
+  }
+  buffer += "$end\n";
+}
@@ -0,0 +1,184 @@
+#include "watchdog.h"
+
+Watchdog::Watchdog(Clock* clock, Processor* proc)
+    : clock(clock),
+      scheduler(&proc->scheduler),
+      irq(&proc->irq),
+      cycles(&proc->cycles) {
+  ie_index = AddRegister({"IE1", IE1_ADDR, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  ifg_index =
+      AddRegister({"IFG1", IFG1_ADDR, 1, 0x00, 0xFF, 0xFF, HOOK::WRITE});
+  ctl_index = AddRegister({"WDTCTL", WDTCTL_ADDR, 2, 0x6900, 0xFFFF, 0xFFFF,
+                           HOOK::WRITE});
+
+  event_id = scheduler->Add([this](uint64_t cycle) { Event(cycle); });
+  puc_id = scheduler->Add([this](uint64_t cycle) {
+    if (this->puc) {
+      this->puc();
+    }
+  });
+  clock->AddListener([this]() { Reschedule(); });
+
+  // Servicing the interval timer interrupt resets WDTIFG
+  irq->SetAcknowledge(InterruptController::WDT, [this]() {
+    SetValue(ifg_index, GetValue(ifg_index) & ~WDTIFG);
+    UpdateInterrupts();
+  });
+}
+
+/**
+ * @brief The watchdog starts counting SMCLK in watchdog mode after a PUC
+ *
+ */
+void Watchdog::Reset() {
+  Peripheral::Reset();
+  ctl.val = GetValue(ctl_index);
+  if (expired) {
+    SetValue(ifg_index, GetValue(ifg_index) | WDTIFG);
+    expired = false;
+  }
+  count = 0;
+  anchor = GetSourceTicks();
+  scheduler->Cancel(puc_id);
+  Reschedule();
+  UpdateInterrupts();
+}
+
+void Watchdog::Save(Snapshot& snapshot) {
+  snapshot.Put(ctl);
+  snapshot.Put(count);
+  snapshot.Put(anchor);
+  snapshot.Put(expired);
+}
+
+void Watchdog::Load(Snapshot& snapshot) {
+  snapshot.Get(ctl);
+  snapshot.Get(count);
+  snapshot.Get(anchor);
+  snapshot.Get(expired);
+}
+
+/**
+ * @brief Called to carry out a PUC, without one expiries only set WDTIFG
+ *
+ */
+void Watchdog::SetPuc(std::function<void()> puc) { this->puc = puc; }
+
+/**
+ * @brief Called after IE1 is written, it also holds enable bits of other
+ * peripherals
+ *
+ */
+void Watchdog::AddListener(std::function<void()> listener) {
+  listeners.push_back(listener);
+}
+
+/**
+ * @brief WDTCNT, which isn't accessible to software
+ *
+ */
+uint16_t Watchdog::GetCount() {
+  Sync();
+  return static_cast<uint16_t>(count);
+}
+
+uint64_t Watchdog::GetSourceTicks() {
+  auto source = ctl.WDTSSEL ? CLOCK::ACLK : CLOCK::SMCLK;
+  return clock->GetTicks(source, *cycles);
+}
+
+/**
+ * @brief Bring WDTCNT up to the current cycle
+ *
+ */
+void Watchdog::Sync() {
+  auto ticks = GetSourceTicks();
+  if (!ctl.WDTHOLD && ticks > anchor) {
+    count += ticks - anchor;
+  }
+  anchor = ticks;
+}
+
+/**
+ * @brief Schedule the next time the selected WDTCNT tap goes high
+ *
+ */
+void Watchdog::Reschedule() {
+  if (ctl.WDTHOLD) {
+    scheduler->Cancel(event_id);
+    return;
+  }
+  auto interval = INTERVALS[ctl.WDTISx];
+  auto remaining = interval - count % interval;
+  auto source = ctl.WDTSSEL ? CLOCK::ACLK : CLOCK::SMCLK;
+  scheduler->Schedule(event_id, clock->GetCycle(source, anchor + remaining));
+}
+
+void Watchdog::Event(uint64_t cycle) {
+  Sync();
+  if (!ctl.WDTTMSEL) {
+    expired = true;
+    Puc();
+    return;
+  }
+  SetValue(ifg_index, GetValue(ifg_index) | WDTIFG);
+  UpdateInterrupts();
+  Reschedule();
+}
+
+/**
+ * @brief Request a PUC, it happens when the scheduler next runs so the
+ * current instruction isn't cut short
+ *
+ */
+void Watchdog::Puc() {
+  scheduler->Cancel(event_id);
+  scheduler->Schedule(puc_id, *cycles);
+}
+
+void Watchdog::WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                             uint16_t val) {
+  auto index = static_cast<uint16_t>(&reg - registers.data());
+  if (index == ctl_index) {
+    WDTCTL_Union next;
+    next.val = val;
+    if (next.WDTPW != PASSWORD) {
+      SetValue(ctl_index, old_val);
+      expired = true;
+      Puc();
+      return;
+    }
+
+    // Count up to now with the settings from before the write
+    Sync();
+    if (next.WDTCNTCL) {
+      count = 0;
+    }
+    next.WDTCNTCL = 0;
+    next.WDTPW = READ_PASSWORD;
+    SetValue(ctl_index, next.val);
+
+    bool source_changed = (next.WDTSSEL != ctl.WDTSSEL);
+    ctl = next;
+    if (source_changed) {
+      anchor = GetSourceTicks();
+    }
+    Reschedule();
+  }
+  UpdateInterrupts();
+  if (index == ie_index) {
+    for (auto& listener : listeners) {
+      listener();
+    }
+  }
+}
+
+/**
+ * @brief WDTIFG only requests an interrupt in interval timer mode
+ *
+ */
+void Watchdog::UpdateInterrupts() {
+  bool pending = ctl.WDTTMSEL && (GetValue(ie_index) & WDTIE) &&
+                 (GetValue(ifg_index) & WDTIFG);
+  irq->Set(InterruptController::WDT, pending);
+}
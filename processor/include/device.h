@@ -0,0 +1,130 @@
+#ifndef device_h
+#define device_h
+
+#include <cstdint>
+#include <string>
+
+#include "interrupt.h"
+#include "memory.h"
+
+/**
+ * @brief Contiguous part of the address space
+ *
+ */
+struct MemoryRegion {
+  MemAddr start;
+  uint32_t size;
+
+  constexpr bool Contains(MemAddr addr) const {
+    return addr >= start && static_cast<uint32_t>(addr - start) < size;
+  }
+  constexpr uint32_t GetEnd() const { return start + size; }
+};
+
+/**
+ * @brief Memory map, peripheral set and vector table of an MSP430G2xx part
+ *
+ * The descriptors are constant expressions, so their layouts are verified
+ * when the emulator is compiled. The device is picked at run time and read
+ * through a pointer, so on the hot path the checks below are a few compares
+ * against its fields.
+ */
+struct Device {
+  const char* name;
+  MemoryRegion ram;
+  MemoryRegion info;
+  MemoryRegion flash;
+  // Bit n set for each vector at VECTOR_TABLE + 2n that has a source
+  uint16_t vectors;
+  // Peripherals beyond the ones every part has
+  uint32_t peripherals;
+
+  constexpr bool Has(uint32_t peripheral) const {
+    return (peripherals & peripheral) == peripheral;
+  }
+  constexpr bool IsPeripheral(MemAddr addr) const {
+    return PERIPHERALS.Contains(addr);
+  }
+  constexpr bool IsRam(MemAddr addr) const { return ram.Contains(addr); }
+  constexpr bool IsFlash(MemAddr addr) const {
+    return info.Contains(addr) || flash.Contains(addr);
+  }
+  constexpr bool IsExecutable(MemAddr addr) const {
+    return IsRam(addr) || IsFlash(addr);
+  }
+
+  static const Device* Find(const std::string& name);
+
+  static constexpr MemoryRegion PERIPHERALS{0x0000, Memory::IO_SIZE};
+  static constexpr MemAddr RESET_VECTOR = 0xFFFE;
+
+  // Optional peripherals
+  static constexpr uint32_t TIMER1 = 1 << 0;
+  static constexpr uint32_t USCI = 1 << 1;
+  static constexpr uint32_t ADC10 = 1 << 2;
+
+  static const Device G2231;
+  static const Device G2452;
+  static const Device G2553;
+};
+
+namespace device {
+
+// Sources every part has, RESET is the top vector
+constexpr uint16_t COMMON_VECTORS =
+    (1 << InterruptController::PORT1) | (1 << InterruptController::PORT2) |
+    (1 << InterruptController::TIMER0_A1) |
+    (1 << InterruptController::TIMER0_A0) | (1 << InterruptController::WDT) |
+    (1 << InterruptController::NMI) | (1 << 15);
+
+}  // namespace device
+
+constexpr Device Device::G2231{
+    "G2231",
+    {0x0200, 0x0080},
+    {0x1000, 0x0100},
+    {0xF800, 0x0800},
+    device::COMMON_VECTORS | (1 << InterruptController::USI) |
+        (1 << InterruptController::ADC10),
+    ADC10};
+
+constexpr Device Device::G2452{
+    "G2452",
+    {0x0200, 0x0100},
+    {0x1000, 0x0100},
+    {0xE000, 0x2000},
+    device::COMMON_VECTORS | (1 << InterruptController::USI) |
+        (1 << InterruptController::ADC10) |
+        (1 << InterruptController::COMPARATOR),
+    ADC10};
+
+constexpr Device Device::G2553{
+    "G2553",
+    {0x0200, 0x0200},
+    {0x1000, 0x0100},
+    {0xC000, 0x4000},
+    device::COMMON_VECTORS | (1 << InterruptController::ADC10) |
+        (1 << InterruptController::USCI_TX) |
+        (1 << InterruptController::USCI_RX) |
+        (1 << InterruptController::COMPARATOR) |
+        (1 << InterruptController::TIMER1_A1) |
+        (1 << InterruptController::TIMER1_A0),
+    TIMER1 | USCI | ADC10};
+
+namespace device {
+
+constexpr bool IsValid(const Device& device) {
+  return device.ram.start == Device::PERIPHERALS.GetEnd() &&
+         device.info.GetEnd() <= device.flash.start &&
+         device.flash.GetEnd() == Memory::MEM_SIZE &&
+         device.flash.Contains(Device::RESET_VECTOR) &&
+         device.flash.Contains(InterruptController::VECTOR_TABLE);
+}
+
+static_assert(IsValid(Device::G2231), "G2231 memory map is inconsistent");
+static_assert(IsValid(Device::G2452), "G2452 memory map is inconsistent");
+static_assert(IsValid(Device::G2553), "G2553 memory map is inconsistent");
+
+}  // namespace device
+
+#endif
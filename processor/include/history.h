@@ -0,0 +1,64 @@
+#ifndef history_h
+#define history_h
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief An executed instruction, sp and sr are as they were before it ran
+ *
+ */
+struct HistoryEntry {
+  uint64_t cycles;
+  uint16_t pc;
+  uint16_t opcode;
+  uint16_t sp;
+  uint16_t sr;
+};
+
+/**
+ * @brief The last SIZE instructions the processor executed
+ *
+ * Add() is a single store into a fixed array and a counter increment, with
+ * nothing formatted until the history is read, so it is cheap enough to
+ * keep on all the time. It is written by the thread running the processor
+ * and read between steps.
+ */
+class History {
+ public:
+  History(){};
+  ~History(){};
+
+  void Add(uint64_t cycles, uint16_t pc, uint16_t opcode, uint16_t sp,
+           uint16_t sr) {
+    entries[count++ & MASK] = {cycles, pc, opcode, sp, sr};
+  }
+
+  size_t GetSize() const {
+    return static_cast<size_t>(std::min<uint64_t>(count, SIZE));
+  }
+
+  /**
+   * @brief Entries in the order they ran, 0 is the oldest still kept
+   *
+   */
+  const HistoryEntry& Get(size_t index) const {
+    return entries[(count - GetSize() + index) & MASK];
+  }
+
+  uint64_t GetCount() const { return count; }
+  void Clear() { count = 0; }
+
+  static std::string Mnemonic(uint16_t opcode);
+
+  static constexpr size_t SIZE = 256;
+  static constexpr size_t MASK = SIZE - 1;
+
+ private:
+  HistoryEntry entries[SIZE];
+  uint64_t count{0};
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef interrupt_h
+#define interrupt_h
+
+#include <cstdint>
+#include <functional>
+
+#include "memory.h"
+
+/**
+ * @brief Pending interrupt requests, one bit per vector
+ *
+ * Bit n is the vector at VECTOR_TABLE + 2n, a higher vector address is a
+ * higher priority so the highest set bit wins. dirty is set whenever the
+ * pending mask changes so the processor only looks when something did.
+ */
+class InterruptController {
+ public:
+  typedef std::function<void()> Acknowledge;
+
+  InterruptController(){};
+  ~InterruptController(){};
+
+  void Set(uint8_t vector, bool pending);
+  void SetAcknowledge(uint8_t vector, Acknowledge acknowledge);
+  void SetVectors(uint16_t vectors) { implemented = vectors; }
+  int GetHighest(bool gie);
+  void Accept(uint8_t vector);
+  uint16_t GetPending() { return pending; }
+  void Save(Snapshot& snapshot);
+  void Load(Snapshot& snapshot);
+  static MemAddr GetVectorAddress(uint8_t vector);
+
+  bool dirty{true};
+
+  static constexpr MemAddr VECTOR_TABLE = 0xFFE0;
+  static constexpr uint8_t VECTORS = 16;
+
+  // G2xx vectors
+  static constexpr uint8_t PORT1 = 2;
+  static constexpr uint8_t PORT2 = 3;
+  static constexpr uint8_t USI = 4;
+  static constexpr uint8_t ADC10 = 5;
+  static constexpr uint8_t USCI_TX = 6;
+  static constexpr uint8_t USCI_RX = 7;
+  static constexpr uint8_t TIMER0_A1 = 8;
+  static constexpr uint8_t TIMER0_A0 = 9;
+  static constexpr uint8_t WDT = 10;
+  static constexpr uint8_t COMPARATOR = 11;
+  static constexpr uint8_t TIMER1_A1 = 12;
+  static constexpr uint8_t TIMER1_A0 = 13;
+  static constexpr uint8_t NMI = 14;
+
+ private:
+  // Serviced regardless of GIE
+  static constexpr uint16_t NON_MASKABLE = 1 << NMI;
+
+  uint16_t pending{0};
+  // Vectors the device has a source for, requests on the rest are dropped
+  uint16_t implemented{0xFFFF};
+  Acknowledge acknowledge[VECTORS];
+};
+
+#endif
@@ -6,7 +6,11 @@
 #include <map>
 #include <optional>
 
+#include "device.h"
+#include "history.h"
+#include "interrupt.h"
 #include "memory.h"
+#include "scheduler.h"
 
 enum class FORMAT { FORMAT1, FORMAT2, JUMP, NONE };
 
@@ -51,10 +55,12 @@ class Processor {
   typedef void (Processor::*OP)();
 
  public:
-  Processor();
+  Processor(const Device& device = Device::G2553);
   ~Processor();
 
   void SetMemory(Memory* mem);
+  void Save(Snapshot& snapshot);
+  void Load(Snapshot& snapshot);
   void Step();
   uint16_t FetchInstruction(uint16_t PC);
   ADDRESSING_MODE GetAddressingMode(REG reg, uint8_t ax);
@@ -70,9 +76,11 @@ class Processor {
   OP GetOp();
   std::string GetModeString(ADDRESSING_MODE addr);
   bool CheckConstantGenerator(uint16_t reg_num, uint16_t as, uint16_t* val);
+  uint8_t InstructionCycles(uint16_t instruction);
   void Cycle();
 
   Memory* mem;
+  const Device* device;
   FORMAT current_format{FORMAT::NONE};
 
   uint16_t R0{};
@@ -113,6 +121,11 @@ class Processor {
   uint16_t* GC1;
   uint16_t* GC2;
   uint16_t current_instruction{};
+  uint64_t cycles{};
+  uint64_t instructions{};
+  Scheduler scheduler;
+  InterruptController irq;
+  History history;
 
   void SetFlags(uint16_t src, uint16_t dst, uint16_t val, bool byte);
   void SetFlagsXOR(uint16_t src, uint16_t dst, uint16_t val, bool byte);
@@ -121,6 +134,7 @@ class Processor {
   void PrintStatusRegister();
   void DisplayInstruction(MemAddr addr);
   bool DisplayVerbose();
+  void Trace(const char* format, ...) __attribute__((format(printf, 2, 3)));
   std::string GetOperandString(std::optional<uint16_t> source_mem,
                                uint16_t src);
 
@@ -158,6 +172,8 @@ class Processor {
 
   // interrupts
   void int_reset();
+  bool Interrupt();
+  void RunEvents();
 
   union Format1 {
     struct {
@@ -193,8 +209,11 @@ class Processor {
   std::map<std::string, OP> op_map;
   std::map<uint16_t, uint16_t*> register_map{};
 
-  static constexpr uint16_t RESET_VECTOR = 0xFFFE;
-  static constexpr uint16_t PERIPH_MAX = 0x01FF;
+  static constexpr uint16_t RESET_VECTOR = Device::RESET_VECTOR;
+  static constexpr uint8_t INTERRUPT_CYCLES = 6;
+  static constexpr uint8_t RETI_CYCLES = 5;
+  // Cycles skipped at a time in low power mode with nothing scheduled
+  static constexpr uint64_t IDLE_CYCLES = 1000;
 
   ADDRESSING_MODE current_as_mode{};
   ADDRESSING_MODE current_ad_mode{};
@@ -203,6 +222,8 @@ class Processor {
   uint16_t const_generator_val{};
   bool display_instruction{false};
   bool step{false};
+  // Where verbose instruction output goes
+  std::ostream* trace{&std::cout};
   bool no_increment{false};
 };
 
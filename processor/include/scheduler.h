@@ -0,0 +1,47 @@
+#ifndef scheduler_h
+#define scheduler_h
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "snapshot.h"
+
+/**
+ * @brief Calls peripheral events once the CPU cycle count reaches their
+ * deadline, so peripherals don't have to be ticked every cycle
+ *
+ * There are only a handful of event sources, each has at most one pending
+ * deadline and the earliest one is cached for the per-instruction check.
+ */
+class Scheduler {
+ public:
+  typedef std::function<void(uint64_t cycle)> Callback;
+
+  Scheduler(){};
+  ~Scheduler(){};
+
+  size_t Add(Callback callback);
+  void Schedule(size_t id, uint64_t cycle);
+  void Cancel(size_t id);
+  void Run(uint64_t now);
+  uint64_t GetNext() { return next; }
+  uint64_t GetDeadline(size_t id) { return events[id].cycle; }
+  void Save(Snapshot& snapshot);
+  void Load(Snapshot& snapshot);
+
+  static constexpr uint64_t NEVER = UINT64_MAX;
+
+ private:
+  struct Event {
+    uint64_t cycle;
+    Callback callback;
+  };
+
+  void Update();
+
+  std::vector<Event> events;
+  uint64_t next{NEVER};
+};
+
+#endif
@@ -0,0 +1,15 @@
+#include "device.h"
+
+/**
+ * @brief Descriptor for a part name like "G2553" or "MSP430G2553", null if
+ * it isn't known
+ *
+ */
+const Device* Device::Find(const std::string& name) {
+  for (auto device : {&G2231, &G2452, &G2553}) {
+    if (name == device->name || name == std::string("MSP430") + device->name) {
+      return device;
+    }
+  }
+  return nullptr;
+}
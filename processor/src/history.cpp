@@ -0,0 +1,37 @@
+#include "history.h"
+
+namespace {
+
+constexpr const char* FORMAT1[] = {"mov", "add", "addc", "subc",
+                                   "sub", "cmp", "dadd", "bit",
+                                   "bic", "bis", "xor",  "and"};
+constexpr const char* FORMAT2[] = {"rrc",  "swpb", "rra",  "sxt",
+                                   "push", "call", "reti", nullptr};
+constexpr const char* JUMPS[] = {"jne", "jeq", "jnc", "jc",
+                                 "jn",  "jge", "jl",  "jmp"};
+
+}  // namespace
+
+/**
+ * @brief Instruction name from the first word alone, enough to read a
+ * history without decoding operands
+ *
+ */
+std::string History::Mnemonic(uint16_t opcode) {
+  bool byte = opcode & 0x0040;
+  if (opcode >= 0x4000) {
+    return std::string(FORMAT1[(opcode >> 12) - 4]) + (byte ? ".b" : "");
+  }
+  if (opcode >= 0x2000) {
+    return JUMPS[(opcode >> 10) & 0x7];
+  }
+  if ((opcode & 0xFC00) == 0x1000) {
+    auto index = (opcode >> 7) & 0x7;
+    if (FORMAT2[index] != nullptr) {
+      // Only rrc, rra and push come in byte form
+      bool has_byte = index % 2 == 0 && index < 6;
+      return std::string(FORMAT2[index]) + (byte && has_byte ? ".b" : "");
+    }
+  }
+  return "???";
+}
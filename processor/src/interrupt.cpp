@@ -0,0 +1,59 @@
+#include "interrupt.h"
+
+/**
+ * @brief Raise or drop the request line of a vector
+ *
+ */
+void InterruptController::Set(uint8_t vector, bool pending) {
+  pending = pending && (implemented & (1 << vector));
+  uint16_t updated = pending ? (this->pending | (1 << vector))
+                             : (this->pending & ~(1 << vector));
+  if (updated != this->pending) {
+    this->pending = updated;
+    dirty = true;
+  }
+}
+
+/**
+ * @brief Called when the vector is serviced, for sources whose flag is reset
+ * by hardware
+ *
+ */
+void InterruptController::SetAcknowledge(uint8_t vector,
+                                         Acknowledge acknowledge) {
+  this->acknowledge[vector] = acknowledge;
+}
+
+/**
+ * @brief Highest priority vector that can be serviced, -1 if none
+ *
+ */
+int InterruptController::GetHighest(bool gie) {
+  uint32_t mask = gie ? pending : (pending & NON_MASKABLE);
+  if (mask == 0) {
+    return -1;
+  }
+  return 31 - __builtin_clz(mask);
+}
+
+void InterruptController::Accept(uint8_t vector) {
+  if (acknowledge[vector]) {
+    acknowledge[vector]();
+  }
+}
+
+MemAddr InterruptController::GetVectorAddress(uint8_t vector) {
+  return VECTOR_TABLE + 2 * vector;
+}
+
+void InterruptController::Save(Snapshot& snapshot) { snapshot.Put(pending); }
+
+/**
+ * @brief Restore the request lines, the processor looks at them again
+ * before the next instruction
+ *
+ */
+void InterruptController::Load(Snapshot& snapshot) {
+  snapshot.Get(pending);
+  dirty = true;
+}
@@ -1,7 +1,10 @@
 #include "processor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdarg>
+#include <cstdio>
 #include <ctime>
 #include <iostream>
 #include <thread>
@@ -9,7 +12,8 @@
 using namespace std::literals;
 using clock_type = std::chrono::high_resolution_clock;
 
-Processor::Processor() {
+Processor::Processor(const Device& device) : device(&device) {
+  irq.SetVectors(device.vectors);
   PC = &R0;
   SP = &R1;
   SR = &R2;
@@ -67,6 +71,35 @@ void Processor::SetMemory(Memory* mem_ptr) {
   int_reset();
 }
 
+/**
+ * @brief Registers, counters, pending events and interrupt requests. Saved
+ * between instructions, so none of the decode state is needed.
+ *
+ */
+void Processor::Save(Snapshot& snapshot) {
+  for (auto& reg : register_map) {
+    snapshot.Put(*reg.second);
+  }
+  snapshot.Put(current_instruction);
+  snapshot.Put(cycles);
+  snapshot.Put(instructions);
+  scheduler.Save(snapshot);
+  irq.Save(snapshot);
+}
+
+void Processor::Load(Snapshot& snapshot) {
+  for (auto& reg : register_map) {
+    snapshot.Get(*reg.second);
+  }
+  snapshot.Get(current_instruction);
+  snapshot.Get(cycles);
+  snapshot.Get(instructions);
+  scheduler.Load(snapshot);
+  irq.Load(snapshot);
+  // What ran before isn't what led to the restored state
+  history.Clear();
+}
+
 bool CheckBits(uint16_t a, uint16_t b, uint16_t bit) {
   auto v1 = (a >> bit) & 0xF;
   auto v2 = (b >> bit) & 0xF;
@@ -166,10 +199,10 @@ Processor::OP Processor::GetOpCodeFunc() {
     }
   }
   if (opcode == 0x0) {
-    std::cout << std::hex << +opcode << std::endl;
+    *trace << std::hex << +opcode << std::dec << std::endl;
     throw(ProcessorException("Undefined Opcode"));
   }
-  std::cout << std::hex << +opcode << std::endl;
+  *trace << std::hex << +opcode << std::dec << std::endl;
   throw(ProcessorException("Undefined Opcode"));
 }
 
@@ -211,7 +244,27 @@ void Processor::Cycle() {
 }
 
 void Processor::Step() {
+  if (irq.dirty) {
+    irq.dirty = false;
+    if (Interrupt()) {
+      RunEvents();
+      return;
+    }
+  }
+  if (SR->cpu_off) {
+    // Low power mode, nothing runs until the next peripheral event
+    auto next = scheduler.GetNext();
+    if (next == Scheduler::NEVER && !SR->general_int_en) {
+      throw(ProcessorException("CPU off with interrupts disabled"));
+    }
+    cycles = (next == Scheduler::NEVER) ? cycles + IDLE_CYCLES
+                                        : std::max(next, cycles + 1);
+    RunEvents();
+    return;
+  }
+
   current_instruction = FetchInstruction(*PC);
+  history.Add(cycles, *PC, current_instruction, *SP, SR->val);
 
   (this->*GetOpCodeFunc())();
 
@@ -220,12 +273,23 @@ void Processor::Step() {
   }
 
   no_increment = false;
+  cycles += InstructionCycles(current_instruction);
+  instructions++;
+  RunEvents();
+}
+
+void Processor::RunEvents() {
+  if (cycles >= scheduler.GetNext()) {
+    scheduler.Run(cycles);
+  }
 }
 
 uint16_t Processor::FetchInstruction(uint16_t PC) {
-  if (PC <= PERIPH_MAX) {
+  if (!device->IsExecutable(PC)) {
     throw(ProcessorException(
-        "Tried to fetch instruction from peripheral address space"));
+        device->IsPeripheral(PC)
+            ? "Tried to fetch instruction from peripheral address space"
+            : "Tried to fetch instruction from vacant memory"));
   }
   return (mem->GetUint16(PC));
 }
@@ -240,6 +304,35 @@ void Processor::int_reset() {
 
   // Reset Program Counter
   *PC = mem->GetUint16(RESET_VECTOR);
+  irq.dirty = true;
+}
+
+/**
+ * @brief Enter the highest priority pending interrupt, if GIE allows it
+ *
+ * PC and SR are pushed, SR is cleared apart from SCG0 (which also leaves low
+ * power mode) and PC is loaded from the vector.
+ */
+bool Processor::Interrupt() {
+  constexpr uint16_t SCG0 = 0x0040;
+
+  auto vector = irq.GetHighest(SR->general_int_en);
+  if (vector < 0) {
+    return false;
+  }
+
+  *SP = *SP - 2;
+  mem->SetUint16BSwap(*SP, *PC);
+  *SP = *SP - 2;
+  mem->SetUint16BSwap(*SP, SR->val);
+  irq.Accept(vector);
+  SR->val &= SCG0;
+  *PC = mem->GetUint16(InterruptController::GetVectorAddress(vector));
+  cycles += INTERRUPT_CYCLES;
+
+  // Anything still pending is looked at again once GIE is back
+  irq.dirty = true;
+  return true;
 }
 
 ADDRESSING_MODE Processor::GetAddressingMode(REG reg, uint8_t ax) {
@@ -284,6 +377,56 @@ ADDRESSING_MODE Processor::GetAddressingMode(REG reg, uint8_t ax) {
   return ADDRESSING_MODE::NONE;
 }
 
+/**
+ * @brief MCLK cycles taken by an instruction, from the format I/II and jump
+ * cycle tables in the family user's guide
+ *
+ */
+uint8_t Processor::InstructionCycles(uint16_t instruction) {
+  // Indexed by As: register, indexed, indirect, indirect autoincrement
+  static constexpr uint8_t format1_reg[4] = {1, 3, 2, 2};
+  static constexpr uint8_t format1_pc[4] = {2, 3, 2, 3};
+  static constexpr uint8_t format1_mem[4] = {4, 6, 5, 5};
+  static constexpr uint8_t format2_single[4] = {1, 4, 3, 3};
+  static constexpr uint8_t format2_push[4] = {3, 5, 4, 5};
+  static constexpr uint8_t format2_call[4] = {4, 5, 4, 5};
+
+  auto opcode = instruction >> 12;
+  if (opcode >= 0x4) {
+    auto format = Format1();
+    format.val = instruction;
+    uint16_t constant;
+    auto as = CheckConstantGenerator(format.s_reg, format.as, &constant)
+                  ? 0
+                  : format.as;
+    if (format.ad) {
+      return format1_mem[as];
+    }
+    return (format.d_reg == 0) ? format1_pc[as] : format1_reg[as];
+  }
+  if (opcode >= 0x2) {
+    return 2;
+  }
+
+  auto format = Format2();
+  format.val = instruction;
+  uint16_t constant;
+  auto as = CheckConstantGenerator(format.ds_reg, format.ad, &constant)
+                ? 0
+                : format.ad;
+  auto immediate = (format.ds_reg == 0) && (as == 0b11);
+  switch ((instruction >> 7) & 0x7) {
+    case 4:
+      return immediate ? 4 : format2_push[as];
+    case 5:
+      return format2_call[as];
+    case 6:
+      return RETI_CYCLES;
+    default:
+      return format2_single[as];
+  }
+}
+
 bool Processor::CheckConstantGenerator(uint16_t reg, uint16_t as,
                                        uint16_t* val) {
   if ((reg == 2) && (as == 0b00)) {
@@ -510,12 +653,37 @@ void Processor::DisplayInstruction(MemAddr addr) {
 }
 
 void Processor::PrintStatusRegister() {
-  std::cout << "Overflow: " << +SR->overflow << " Carry: " << +SR->carry
+  *trace << "Overflow: " << +SR->overflow << " Carry: " << +SR->carry
             << " Negative: " << +SR->negative << " Zero: " << +SR->zero
             << std::endl;
 }
 
 bool Processor::DisplayVerbose() { return step || display_instruction; }
+
+/**
+ * @brief printf() to the trace stream
+ *
+ */
+void Processor::Trace(const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  auto size = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (size < 0) {
+    return;
+  }
+  if (static_cast<size_t>(size) < sizeof(buffer)) {
+    *trace << buffer;
+    return;
+  }
+  std::string long_line(size + 1, '\0');
+  va_start(args, format);
+  vsnprintf(&long_line[0], long_line.size(), format, args);
+  va_end(args);
+  long_line.resize(size);
+  *trace << long_line;
+}
 // bool Processor::DisplayVerbose() { return false;}
 
 Processor::~Processor() {}
\ No newline at end of file
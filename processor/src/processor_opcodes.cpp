@@ -14,6 +14,10 @@ void Processor::WriteToRegister(uint16_t reg, uint16_t val, bool byte) {
   } else {
     *register_map[reg] = val;
   }
+  if (reg == 2) {
+    // GIE or CPUOFF may have changed
+    irq.dirty = true;
+  }
 }
 
 void Processor::SetFlagsXOR(uint16_t src, uint16_t dst, uint16_t val,
@@ -186,24 +190,24 @@ void Processor::op_add() {
   val = *src + *dst;
 
   if (DisplayVerbose()) {
-    printf("ADD R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
-           *register_map[instruction.s_reg], instruction.d_reg,
-           *register_map[instruction.d_reg], instruction.as, instruction.ad);
+    Trace("ADD R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
+          *register_map[instruction.s_reg], instruction.d_reg,
+          *register_map[instruction.d_reg], instruction.as, instruction.ad);
     if (byte) {
-      std::cout << "BYTE";
+      *trace << "BYTE";
     } else {
-      std::cout << "WORD";
+      *trace << "WORD";
     }
     if (const_generator_used) {
-      printf(", CGVAL: 0x%04x", const_generator_val);
+      Trace(", CGVAL: 0x%04x", const_generator_val);
     }
-    std::cout << std::endl;
+    *trace << std::endl;
     std::string source = GetOperandString(source_mem, instruction.s_reg);
     std::string destination =
         GetOperandString(destination_mem, instruction.d_reg);
-    printf("ADD %s(0x%04x) + %s(0x%04x) = 0x%04x -> %s", source.c_str(), *src,
-           destination.c_str(), *dst, val, destination.c_str());
-    std::cout << std::endl;
+    Trace("ADD %s(0x%04x) + %s(0x%04x) = 0x%04x -> %s", source.c_str(), *src,
+          destination.c_str(), *dst, val, destination.c_str());
+    *trace << std::endl;
   }
 
   // Write value to register or memory
@@ -243,25 +247,25 @@ void Processor::op_bis() {
   val = *src | *dst;
 
   if (DisplayVerbose()) {
-    printf("BIS R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
-           *register_map[instruction.s_reg], instruction.d_reg,
-           *register_map[instruction.d_reg], instruction.as, instruction.ad);
+    Trace("BIS R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
+          *register_map[instruction.s_reg], instruction.d_reg,
+          *register_map[instruction.d_reg], instruction.as, instruction.ad);
     if (byte) {
-      std::cout << "BYTE";
+      *trace << "BYTE";
     } else {
-      std::cout << "WORD";
+      *trace << "WORD";
     }
     if (const_generator_used) {
-      printf(", CGVAL: 0x%04x", const_generator_val);
+      Trace(", CGVAL: 0x%04x", const_generator_val);
     }
-    std::cout << std::endl;
+    *trace << std::endl;
     std::string source = GetOperandString(source_mem, instruction.s_reg);
     std::string destination =
         GetOperandString(destination_mem, instruction.d_reg);
 
-    printf("BIS %s(0x%04x) OR %s(0x%04x) = 0x%04x -> %s", source.c_str(), *src,
-           destination.c_str(), *dst, val, destination.c_str());
-    std::cout << std::endl;
+    Trace("BIS %s(0x%04x) OR %s(0x%04x) = 0x%04x -> %s", source.c_str(), *src,
+          destination.c_str(), *dst, val, destination.c_str());
+    *trace << std::endl;
   }
 
   // Write value to register or memory
@@ -291,19 +295,19 @@ void Processor::op_call() {
   *PC = dst;
 
   if (DisplayVerbose()) {
-    printf("CALL R%i=0x%04x, Ad: %i, ", instruction.ds_reg,
-           *register_map[instruction.ds_reg], instruction.ad);
+    Trace("CALL R%i=0x%04x, Ad: %i, ", instruction.ds_reg,
+          *register_map[instruction.ds_reg], instruction.ad);
     if (byte) {
-      std::cout << "BYTE";
+      *trace << "BYTE";
     } else {
-      std::cout << "WORD";
+      *trace << "WORD";
     }
     if (const_generator_used) {
-      printf(", CGVAL: 0x%04x", const_generator_val);
+      Trace(", CGVAL: 0x%04x", const_generator_val);
     }
-    std::cout << std::endl;
-    printf("CALL 0x%04x", dst);
-    std::cout << std::endl;
+    *trace << std::endl;
+    Trace("CALL 0x%04x", dst);
+    *trace << std::endl;
   }
 
   no_increment = true;
@@ -337,25 +341,25 @@ void Processor::op_cmp() {
   val = *dst + inverse;
 
   if (DisplayVerbose()) {
-    printf("CMP R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
-           *register_map[instruction.s_reg], instruction.d_reg,
-           *register_map[instruction.d_reg], instruction.as, instruction.ad);
+    Trace("CMP R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
+          *register_map[instruction.s_reg], instruction.d_reg,
+          *register_map[instruction.d_reg], instruction.as, instruction.ad);
     if (byte) {
-      std::cout << "BYTE";
+      *trace << "BYTE";
     } else {
-      std::cout << "WORD";
+      *trace << "WORD";
     }
     if (const_generator_used) {
-      printf(", CGVAL: 0x%04x", const_generator_val);
+      Trace(", CGVAL: 0x%04x", const_generator_val);
     }
 
-    std::cout << std::endl;
+    *trace << std::endl;
     std::string source = GetOperandString(source_mem, instruction.s_reg);
     std::string destination =
         GetOperandString(destination_mem, instruction.d_reg);
-    printf("CMP %s(0x%04x) - %s(0x%04x) = 0x%04x -> %s", destination.c_str(),
-           *dst, source.c_str(), *src, val, destination.c_str());
-    std::cout << std::endl;
+    Trace("CMP %s(0x%04x) - %s(0x%04x) = 0x%04x -> %s", destination.c_str(),
+          *dst, source.c_str(), *src, val, destination.c_str());
+    *trace << std::endl;
   }
 
   // Write value to register or memory
@@ -392,9 +396,9 @@ void Processor::op_jc_jhs() {
   auto offset = instruction.offset;
 
   if (DisplayVerbose()) {
-    printf("JC_JHS OPCODE=0x%04x, C=0x%04x, OFFSET=%i, CARRY=0x%04x",
-           instruction.op_code, instruction.c, offset, SR->carry);
-    std::cout << std::endl;
+    Trace("JC_JHS OPCODE=0x%04x, C=0x%04x, OFFSET=%i, CARRY=0x%04x",
+          instruction.op_code, instruction.c, offset, SR->carry);
+    *trace << std::endl;
   }
 
   throw(ProcessorException("JC_JHS Undefined"));
@@ -410,9 +414,9 @@ void Processor::op_jeq_jz() {
   auto new_pc = *PC + (2* offset);
 
   if (DisplayVerbose()) {
-      printf("JEQ_JZ OPCODE=0x%04x, Z=0x%04x, OFFSET=%i, NEW_PC=0x%04x",
+      Trace("JEQ_JZ OPCODE=0x%04x, Z=0x%04x, OFFSET=%i, NEW_PC=0x%04x",
             instruction.op_code, SR->zero, offset, new_pc);
-      std::cout << std::endl;
+      *trace << std::endl;
     }
 
   if(SR->zero == 1) {
@@ -433,9 +437,9 @@ void Processor::op_jmp() {
   auto new_pc = *PC + (2* offset);
 
   if (DisplayVerbose()) {
-    printf("JMP OPCODE=0x%04x, C=0x%04x, OFFSET=%i, NEW_PC=0x%04x",
-           instruction.op_code, instruction.c, offset, new_pc);
-    std::cout << std::endl;
+    Trace("JMP OPCODE=0x%04x, C=0x%04x, OFFSET=%i, NEW_PC=0x%04x",
+          instruction.op_code, instruction.c, offset, new_pc);
+    *trace << std::endl;
   }
 
   *PC = new_pc;
@@ -471,24 +475,24 @@ void Processor::op_mov() {
   val = *src;
 
   if (DisplayVerbose()) {
-    printf("MOV R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
-           *register_map[instruction.s_reg], instruction.d_reg,
-           *register_map[instruction.d_reg], instruction.as, instruction.ad);
+    Trace("MOV R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
+          *register_map[instruction.s_reg], instruction.d_reg,
+          *register_map[instruction.d_reg], instruction.as, instruction.ad);
     if (byte) {
-      std::cout << "BYTE";
+      *trace << "BYTE";
     } else {
-      std::cout << "WORD";
+      *trace << "WORD";
     }
     if (const_generator_used) {
-      printf(", CGVAL: 0x%04x", const_generator_val);
+      Trace(", CGVAL: 0x%04x", const_generator_val);
     }
-    std::cout << std::endl;
+    *trace << std::endl;
     std::string source = GetOperandString(source_mem, instruction.s_reg);
     std::string destination =
         GetOperandString(destination_mem, instruction.d_reg);
 
-    printf("MOV %s(0x%04x) to %s", source.c_str(), val, destination.c_str());
-    std::cout << std::endl;
+    Trace("MOV %s(0x%04x) to %s", source.c_str(), val, destination.c_str());
+    *trace << std::endl;
   }
 
   // Write value to register or memory
@@ -505,7 +509,21 @@ void Processor::op_mov() {
 
 void Processor::op_push() { throw(ProcessorException("PUSH Undefined")); };
 void Processor::op_push_b() { throw(ProcessorException("PUSH_B Undefined")); };
-void Processor::op_reti() { throw(ProcessorException("RETI Undefined")); };
+void Processor::op_reti() {
+  current_format = FORMAT::FORMAT2;
+  SR->val = mem->GetUint16(*SP);
+  *SP = *SP + 2;
+  *PC = mem->GetUint16(*SP);
+  *SP = *SP + 2;
+
+  if (DisplayVerbose()) {
+    Trace("RETI 0x%04x", *PC);
+    *trace << std::endl;
+  }
+
+  irq.dirty = true;
+  no_increment = true;
+};
 void Processor::op_rra() { throw(ProcessorException("RRA Undefined")); };
 void Processor::op_rra_b() { throw(ProcessorException("RRA_B Undefined")); };
 void Processor::op_rrc() { throw(ProcessorException("RRC Undefined")); };
@@ -539,25 +557,25 @@ void Processor::op_sub() {
   val = *dst + inverse;
 
   if (DisplayVerbose()) {
-    printf("SUB R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
-           *register_map[instruction.s_reg], instruction.d_reg,
-           *register_map[instruction.d_reg], instruction.as, instruction.ad);
+    Trace("SUB R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
+          *register_map[instruction.s_reg], instruction.d_reg,
+          *register_map[instruction.d_reg], instruction.as, instruction.ad);
     if (byte) {
-      std::cout << "BYTE";
+      *trace << "BYTE";
     } else {
-      std::cout << "WORD";
+      *trace << "WORD";
     }
     if (const_generator_used) {
-      printf(", CGVAL: 0x%04x", const_generator_val);
+      Trace(", CGVAL: 0x%04x", const_generator_val);
     }
 
-    std::cout << std::endl;
+    *trace << std::endl;
     std::string source = GetOperandString(source_mem, instruction.s_reg);
     std::string destination =
         GetOperandString(destination_mem, instruction.d_reg);
-    printf("SUB %s(0x%04x) - %s(0x%04x) = 0x%04x -> %s", destination.c_str(),
-           *dst, source.c_str(), *src, val, destination.c_str());
-    std::cout << std::endl;
+    Trace("SUB %s(0x%04x) - %s(0x%04x) = 0x%04x -> %s", destination.c_str(),
+          *dst, source.c_str(), *src, val, destination.c_str());
+    *trace << std::endl;
   }
 
   // Write value to register or memory
@@ -596,25 +614,25 @@ void Processor::op_xor() {
   val = *src ^ *dst;
 
   if (DisplayVerbose()) {
-    printf("XOR R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
-           *register_map[instruction.s_reg], instruction.d_reg,
-           *register_map[instruction.d_reg], instruction.as, instruction.ad);
+    Trace("XOR R%i=0x%04x, R%i=0x%04x, As: %i, Ad: %i, ", instruction.s_reg,
+          *register_map[instruction.s_reg], instruction.d_reg,
+          *register_map[instruction.d_reg], instruction.as, instruction.ad);
     if (byte) {
-      std::cout << "BYTE";
+      *trace << "BYTE";
     } else {
-      std::cout << "WORD";
+      *trace << "WORD";
     }
     if (const_generator_used) {
-      printf(", CGVAL: 0x%04x", const_generator_val);
+      Trace(", CGVAL: 0x%04x", const_generator_val);
     }
-    std::cout << std::endl;
+    *trace << std::endl;
     std::string source = GetOperandString(source_mem, instruction.s_reg);
     std::string destination =
         GetOperandString(destination_mem, instruction.d_reg);
 
-    printf("XOR %s(0x%04x) XOR %s(0x%04x) = 0x%04x -> %s", source.c_str(), *src,
-           destination.c_str(), *dst, val, destination.c_str());
-    std::cout << std::endl;
+    Trace("XOR %s(0x%04x) XOR %s(0x%04x) = 0x%04x -> %s", source.c_str(), *src,
+          destination.c_str(), *dst, val, destination.c_str());
+    *trace << std::endl;
   }
 
   // Write value to register or memory
@@ -0,0 +1,79 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+/**
+ * @brief Register an event source, returns the id to schedule it with
+ *
+ */
+size_t Scheduler::Add(Callback callback) {
+  events.push_back({NEVER, callback});
+  return events.size() - 1;
+}
+
+/**
+ * @brief Replace the pending deadline of an event source
+ *
+ */
+void Scheduler::Schedule(size_t id, uint64_t cycle) {
+  events[id].cycle = cycle;
+  if (cycle <= next) {
+    next = cycle;
+  } else {
+    Update();
+  }
+}
+
+void Scheduler::Cancel(size_t id) { Schedule(id, NEVER); }
+
+/**
+ * @brief Call every event that is due by now, events scheduled by the
+ * callbacks that are already due run as well. Callbacks get the cycle they
+ * were scheduled for.
+ *
+ */
+void Scheduler::Run(uint64_t now) {
+  while (next <= now) {
+    for (auto& event : events) {
+      if (event.cycle <= now) {
+        auto cycle = event.cycle;
+        event.cycle = NEVER;
+        event.callback(cycle);
+      }
+    }
+    Update();
+  }
+}
+
+/**
+ * @brief Pending deadlines, the callbacks belong to the sources that added
+ * them so only the count has to match
+ *
+ */
+void Scheduler::Save(Snapshot& snapshot) {
+  snapshot.Put(static_cast<uint32_t>(events.size()));
+  for (auto& event : events) {
+    snapshot.Put(event.cycle);
+  }
+}
+
+void Scheduler::Load(Snapshot& snapshot) {
+  uint32_t count;
+  snapshot.Get(count);
+  if (count != events.size()) {
+    throw SnapshotException("snapshot has " + std::to_string(count) +
+                            " scheduler events, expected " +
+                            std::to_string(events.size()));
+  }
+  for (auto& event : events) {
+    snapshot.Get(event.cycle);
+  }
+  Update();
+}
+
+void Scheduler::Update() {
+  next = NEVER;
+  for (auto& event : events) {
+    next = std::min(next, event.cycle);
+  }
+}
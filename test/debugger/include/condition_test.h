@@ -0,0 +1,23 @@
+#ifndef condition_test_h
+#define condition_test_h
+
+#include "condition.h"
+#include "debugger.h"
+#include "gtest/gtest.h"
+
+class ConditionTest : public ::testing::Test {
+ public:
+  ConditionTest(){};
+  ~ConditionTest(){};
+
+  void SetUp();
+  void TearDown(){};
+
+  int64_t Evaluate(const std::string& text) {
+    return debug.Compile(text).Evaluate();
+  }
+
+  Debugger debug;
+};
+
+#endif
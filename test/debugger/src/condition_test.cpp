@@ -0,0 +1,61 @@
+#include "condition_test.h"
+
+#include <string>
+
+void ConditionTest::SetUp() { debug.LoadMem(DOCUMENT_PATH); }
+
+TEST_F(ConditionTest, Arithmetic) {
+  EXPECT_EQ(Evaluate("1 + 2 * 3"), 7);
+  EXPECT_EQ(Evaluate("(1 + 2) * 3"), 9);
+  EXPECT_EQ(Evaluate("7 % 3 == 1 && 2 < 3"), 1);
+  EXPECT_EQ(Evaluate("1 << 4 | 1"), 17);
+  EXPECT_EQ(Evaluate("~0 & 0xff"), 0xff);
+  EXPECT_EQ(Evaluate("-1 < 0"), 1);
+  EXPECT_EQ(Evaluate("!0 || 0"), 1);
+  EXPECT_EQ(Evaluate("6 ^ 3 != 5"), 7);
+  EXPECT_EQ(Evaluate("10 / 0"), 0);
+
+  // Constants are folded away
+  EXPECT_EQ(debug.Compile("(1 + 2) * 3 == 9").GetSize(), 1);
+  EXPECT_EQ(debug.Compile("R4 + 1 + 2").GetSize(), 5);
+}
+
+TEST_F(ConditionTest, MachineState) {
+  debug.proc.WriteToRegister(12, 150, false);
+  debug.mem.WriteRaw(0x200, 0x0403, false);
+  auto condition =
+      debug.Compile("PC == 0xF842 && R12 > 100 && mem[0x200] == 0x403");
+  EXPECT_TRUE(condition.IsTrue());
+  EXPECT_EQ(Evaluate("mem8[0x201]"), 4);
+  EXPECT_EQ(Evaluate("r12 * 2"), 300);
+
+  // The compiled code reads the state as it is when evaluated
+  debug.proc.WriteToRegister(12, 50, false);
+  EXPECT_FALSE(condition.IsTrue());
+  debug.proc.cycles = 1234;
+  EXPECT_EQ(Evaluate("CYCLES"), 1234);
+}
+
+TEST_F(ConditionTest, Symbols) {
+  EXPECT_EQ(Evaluate("main"), 0xf800);
+  EXPECT_EQ(Evaluate("mem[_reset_vector] == PC"), 1);
+  debug.SetSymbols({{"counter", 0x210}});
+  EXPECT_EQ(Evaluate("counter + 2"), 0x212);
+  EXPECT_THROW(Evaluate("main"), ConditionException);
+}
+
+TEST_F(ConditionTest, Errors) {
+  EXPECT_THROW(Evaluate(""), ConditionException);
+  EXPECT_THROW(Evaluate("R12 >"), ConditionException);
+  EXPECT_THROW(Evaluate("(1 + 2"), ConditionException);
+  EXPECT_THROW(Evaluate("mem[0x200"), ConditionException);
+  EXPECT_THROW(Evaluate("R16"), ConditionException);
+  EXPECT_THROW(Evaluate("1 2"), ConditionException);
+  EXPECT_THROW(Evaluate("R4 @ 1"), ConditionException);
+
+  std::string deep = "R4";
+  for (int x = 0; x < 40; x++) {
+    deep = "R4 + (" + deep + ")";
+  }
+  EXPECT_THROW(Evaluate(deep), ConditionException);
+}
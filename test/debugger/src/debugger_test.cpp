@@ -1,5 +1,9 @@
 #include "debugger_test.h"
 
+#include <unistd.h>
+
+#include <sstream>
+
 /**
  * @brief Load MSP430 Binary Into Memory
  *
@@ -56,9 +60,9 @@ TEST_F(DebuggerTest, Step) {
   debug.Step();
   EXPECT_EQ(debug.GetSP(), 0x27C);
 
-  // Stop Watchdog Timer
+  // Stop Watchdog Timer, the password reads back as 0x69
   debug.Step();
-  EXPECT_EQ(debug.GetMemory(static_cast<uint16_t>(0x120)), 0x5a80);
+  EXPECT_EQ(debug.GetMemory(0x120), 0x6980);
 
   // Set System Clock BCSCTL1
   debug.Step();
@@ -68,11 +72,11 @@ TEST_F(DebuggerTest, Step) {
 
   // BIS.B #1, M[0x22]
   debug.Step();
-  EXPECT_EQ(debug.GetMemory(static_cast<uint8_t>(0x22)), 1);
+  EXPECT_EQ(debug.GetMemoryByte(0x22), 1);
 
   // XOR P1OUT
   debug.Step();
-  EXPECT_EQ(debug.GetMemory(static_cast<uint8_t>(0x21)), 1);
+  EXPECT_EQ(debug.GetMemoryByte(0x21), 1);
 
   // Clear SP
   debug.Step();
@@ -80,4 +84,297 @@ TEST_F(DebuggerTest, Step) {
 
   //
   // debug.Step();
-}
\ No newline at end of file
+}
+
+TEST_F(DebuggerTest, Device) {
+  // A G2231 has no USCI, UCA0CTL1 is left as plain memory
+  Debugger g2231(Device::G2231);
+  EXPECT_EQ(g2231.mem.GetUint8(0x61), 0x00);
+  EXPECT_EQ(debug.mem.GetUint8(0x61), 0x01);
+}
+
+TEST_F(DebuggerTest, Breakpoints) {
+  // Without breakpoints only the limit stops it
+  EXPECT_EQ(debug.Continue(4), STOP_REASON::STEP_LIMIT);
+  EXPECT_EQ(debug.GetPC(), 0xf84a);
+
+  debug.Reset();
+  auto instructions = debug.proc.instructions;
+  debug.SetBreakpoint(0xf864);
+  debug.SetBreakpoint(0xf800);
+  debug.SetBreakpoint(0xf800);
+  EXPECT_EQ(debug.GetBreakpointCount(), 2);
+
+  // Call #system.pre.init
+  EXPECT_EQ(debug.Continue(), STOP_REASON::BREAKPOINT);
+  EXPECT_EQ(debug.GetPC(), 0xf864);
+  EXPECT_EQ(debug.proc.instructions - instructions, 2);
+
+  // Continuing from a breakpoint runs on to the next one, main
+  EXPECT_EQ(debug.Continue(), STOP_REASON::BREAKPOINT);
+  EXPECT_EQ(debug.GetPC(), 0xf800);
+
+  debug.ClearBreakpoint(0xf864);
+  EXPECT_FALSE(debug.HasBreakpoint(0xf864));
+  EXPECT_TRUE(debug.HasBreakpoint(0xf800));
+  debug.ClearBreakpoints();
+  EXPECT_EQ(debug.GetBreakpointCount(), 0);
+  EXPECT_EQ(debug.Continue(3), STOP_REASON::STEP_LIMIT);
+}
+
+TEST_F(DebuggerTest, Watchpoints) {
+  // Call #system.pre.init pushes the return address
+  auto id = debug.AddWatchpoint(0x27E, 2, WATCH::WRITE);
+  EXPECT_EQ(debug.Continue(), STOP_REASON::WATCHPOINT);
+  auto& hit = debug.GetWatchHit();
+  EXPECT_EQ(hit.pc, 0xf846);
+  EXPECT_EQ(hit.addr, 0x27E);
+  EXPECT_EQ(hit.old_val, 0x0000);
+  EXPECT_EQ(hit.new_val, 0xf84a);
+  EXPECT_TRUE(hit.write);
+  EXPECT_FALSE(hit.byte);
+  EXPECT_EQ(debug.GetPC(), 0xf864);
+
+  // RET pops it
+  debug.RemoveWatchpoint(id);
+  id = debug.AddWatchpoint(0x27F, 1, WATCH::READ);
+  EXPECT_EQ(debug.Continue(), STOP_REASON::WATCHPOINT);
+  EXPECT_EQ(hit.pc, 0xf866);
+  EXPECT_EQ(hit.new_val, 0xf84a);
+  EXPECT_FALSE(hit.write);
+
+  // Call main pushes a different return address
+  debug.RemoveWatchpoint(id);
+  debug.AddWatchpoint(0x27E, 2, WATCH::CHANGE);
+  EXPECT_EQ(debug.Continue(), STOP_REASON::WATCHPOINT);
+  EXPECT_EQ(hit.pc, 0xf84c);
+  EXPECT_EQ(hit.old_val, 0xf84a);
+  EXPECT_EQ(hit.new_val, 0xf850);
+
+  debug.ClearWatchpoints();
+  EXPECT_EQ(debug.Continue(3), STOP_REASON::STEP_LIMIT);
+}
+
+TEST_F(DebuggerTest, Snapshot) {
+  // Stops the watchdog, runs TA0 from SMCLK and counts R4 up in a loop
+  const uint8_t program[] = {0xb2, 0x40, 0x80, 0x5a, 0x20, 0x01,
+                             0xb2, 0x40, 0x20, 0x02, 0x60, 0x01,
+                             0x14, 0x53, 0xfe, 0x3f};
+  debug.LoadImage(0x200, program, sizeof(program));
+  *debug.proc.PC = 0x200;
+  debug.Continue(100);
+
+  Snapshot snapshot;
+  debug.SaveSnapshot(snapshot);
+  auto r4 = debug.GetRegister(4);
+  auto cycles = debug.proc.cycles;
+
+  debug.Continue(500);
+  auto tar = debug.timer0.GetTAR();
+  auto after = debug.GetRegister(4);
+  EXPECT_NE(after, r4);
+
+  debug.LoadSnapshot(snapshot);
+  EXPECT_EQ(debug.GetRegister(4), r4);
+  EXPECT_EQ(debug.proc.cycles, cycles);
+  debug.Continue(500);
+  EXPECT_EQ(debug.GetRegister(4), after);
+  EXPECT_EQ(debug.timer0.GetTAR(), tar);
+
+  // Through a file into another instance
+  auto path = testing::TempDir() + "debugger_test.snap";
+  snapshot.Write(path);
+  Snapshot read;
+  read.Read(path);
+  unlink(path.c_str());
+  Debugger copy;
+  copy.LoadSnapshot(read);
+  EXPECT_EQ(copy.GetRegister(4), r4);
+  EXPECT_EQ(copy.GetMemory(0x20c), 0x5314);
+
+  Debugger other(Device::G2231);
+  EXPECT_THROW(other.LoadSnapshot(snapshot), SnapshotException);
+}
+
+TEST_F(DebuggerTest, ReverseStep) {
+  // Same program as above
+  const uint8_t program[] = {0xb2, 0x40, 0x80, 0x5a, 0x20, 0x01,
+                             0xb2, 0x40, 0x20, 0x02, 0x60, 0x01,
+                             0x14, 0x53, 0xfe, 0x3f};
+  debug.LoadImage(0x200, program, sizeof(program));
+  *debug.proc.PC = 0x200;
+  EXPECT_EQ(debug.ReverseStep(), STOP_REASON::HISTORY_START);
+
+  debug.StartRecording(0);
+  debug.Continue(100);
+  auto r4 = debug.GetRegister(4);
+  auto cycles = debug.proc.cycles;
+  debug.Continue(5000);
+  auto after = debug.GetRegister(4);
+  auto tar = debug.timer0.GetTAR();
+  EXPECT_EQ(debug.GetPosition(), 5100);
+
+  EXPECT_EQ(debug.ReverseStep(5000), STOP_REASON::STEP_LIMIT);
+  EXPECT_EQ(debug.GetPosition(), 100);
+  EXPECT_EQ(debug.GetRegister(4), r4);
+  EXPECT_EQ(debug.proc.cycles, cycles);
+
+  debug.Continue(5000);
+  EXPECT_EQ(debug.GetRegister(4), after);
+  EXPECT_EQ(debug.timer0.GetTAR(), tar);
+
+  EXPECT_EQ(debug.ReverseStep(10000), STOP_REASON::HISTORY_START);
+  EXPECT_EQ(debug.GetPosition(), 0);
+  EXPECT_EQ(debug.GetPC(), 0x200);
+  debug.StopRecording();
+  EXPECT_EQ(debug.ReverseStep(), STOP_REASON::HISTORY_START);
+}
+
+TEST_F(DebuggerTest, ReverseContinue) {
+  const uint8_t program[] = {0xb2, 0x40, 0x80, 0x5a, 0x20, 0x01,
+                             0xb2, 0x40, 0x20, 0x02, 0x60, 0x01,
+                             0x14, 0x53, 0xfe, 0x3f};
+  debug.LoadImage(0x200, program, sizeof(program));
+  *debug.proc.PC = 0x200;
+  debug.StartRecording(0);
+  debug.Continue(5000);
+  auto r4 = debug.GetRegister(4);
+
+  // Back to the loop's last pass
+  debug.SetBreakpoint(0x20c);
+  EXPECT_EQ(debug.ReverseContinue(), STOP_REASON::BREAKPOINT);
+  EXPECT_EQ(debug.GetPosition(), 4998);
+  EXPECT_EQ(debug.GetRegister(4), r4 - 1);
+  debug.ClearBreakpoints();
+
+  // Across checkpoints to where TA0 was started
+  debug.AddWatchpoint(0x160, 2, WATCH::WRITE);
+  EXPECT_EQ(debug.ReverseContinue(), STOP_REASON::WATCHPOINT);
+  EXPECT_EQ(debug.GetPosition(), 2);
+  EXPECT_EQ(debug.GetWatchHit().pc, 0x206);
+  EXPECT_EQ(debug.GetWatchHit().new_val, 0x0220);
+  EXPECT_EQ(debug.ReverseContinue(), STOP_REASON::HISTORY_START);
+  EXPECT_EQ(debug.GetPosition(), 0);
+
+  debug.ClearWatchpoints();
+  debug.Continue(5000);
+  EXPECT_EQ(debug.GetRegister(4), r4);
+}
+
+TEST_F(DebuggerTest, ReplayInputs) {
+  // Stops the watchdog and adds P1IN to R4 in a loop
+  const uint8_t program[] = {0xb2, 0x40, 0x80, 0x5a, 0x20, 0x01, 0x55, 0x42,
+                             0x20, 0x00, 0x04, 0x55, 0xfc, 0x3f};
+  debug.LoadImage(0x200, program, sizeof(program));
+  *debug.proc.PC = 0x200;
+  debug.StartRecording(0);
+  debug.Continue(100);
+  debug.p1.SetInput(0, true);
+  debug.Continue(1500);
+  debug.p1.SetInput(0, false);
+  debug.Continue(100);
+  auto r4 = debug.GetRegister(4);
+  EXPECT_GT(r4, 0);
+
+  // Pins follow the recording, not the live input
+  debug.ReverseStep(1650);
+  EXPECT_EQ(debug.GetRegister(4), 0);
+  debug.p1.SetInput(3, true);
+  debug.Continue(1650);
+  EXPECT_EQ(debug.GetRegister(4), r4);
+  EXPECT_EQ(debug.mem.GetUint8(0x20) & 0x09, 0);
+
+  // Past the end of the recording they're live again
+  debug.p1.SetInput(3, true);
+  debug.Continue(10);
+  EXPECT_EQ(debug.mem.GetUint8(0x20) & 0x09, 0x08);
+}
+
+TEST_F(DebuggerTest, ConditionalBreakpoint) {
+  // Stops the watchdog and counts R4 up in a loop at 0x206
+  const uint8_t program[] = {0xb2, 0x40, 0x80, 0x5a, 0x20, 0x01,
+                             0x14, 0x53, 0xfe, 0x3f};
+  debug.LoadImage(0x200, program, sizeof(program));
+  *debug.proc.PC = 0x200;
+  debug.SetBreakpoint(0x206, "R4 == 100 && PC == 0x206");
+  EXPECT_EQ(debug.Continue(), STOP_REASON::BREAKPOINT);
+  EXPECT_EQ(debug.GetRegister(4), 100);
+  EXPECT_EQ(debug.GetPC(), 0x206);
+  EXPECT_THROW(debug.SetBreakpoint(0x206, "R4 =="), ConditionException);
+
+  // Plain again
+  debug.SetBreakpoint(0x206);
+  EXPECT_EQ(debug.Continue(), STOP_REASON::BREAKPOINT);
+  EXPECT_EQ(debug.GetRegister(4), 101);
+  debug.ClearBreakpoint(0x206);
+  EXPECT_EQ(debug.Continue(10), STOP_REASON::STEP_LIMIT);
+}
+
+TEST_F(DebuggerTest, Tracepoint) {
+  const uint8_t program[] = {0xb2, 0x40, 0x80, 0x5a, 0x20, 0x01,
+                             0x14, 0x53, 0xfe, 0x3f};
+  debug.LoadImage(0x200, program, sizeof(program));
+  *debug.proc.PC = 0x200;
+  debug.SetTracepoint(0x206, {"R4", "CYCLES"}, "R4 % 10 == 0");
+  EXPECT_EQ(debug.Continue(200), STOP_REASON::STEP_LIMIT);
+
+  auto& hits = debug.GetTraceHits();
+  ASSERT_EQ(hits.size(), 10);
+  for (size_t x = 0; x < hits.size(); x++) {
+    EXPECT_EQ(hits[x].pc, 0x206);
+    EXPECT_EQ(hits[x].values[0], 10 * x);
+    EXPECT_EQ(hits[x].values[1], hits[x].cycles);
+  }
+  debug.ClearTraceHits();
+  debug.ClearBreakpoints();
+  debug.Continue(200);
+  EXPECT_TRUE(debug.GetTraceHits().empty());
+}
+
+TEST_F(DebuggerTest, DumpHistory) {
+  debug.Continue(3);
+  std::ostringstream out;
+  debug.DumpHistory(out);
+  auto dump = out.str();
+  EXPECT_EQ(dump.find("last 3 of 3 instructions:\n"), 0);
+  EXPECT_NE(dump.find("f842  4031  mov"), std::string::npos);
+  EXPECT_NE(
+      dump.find("call    sp=0280 sr=0000  _c_int00_noinit_noargs+0x4\n"),
+      std::string::npos);
+  EXPECT_NE(dump.find("_system_pre_init\n"), std::string::npos);
+  EXPECT_EQ(debug.Symbolize(0xf802), "main+0x2");
+  EXPECT_EQ(debug.Symbolize(0x0200), "");
+}
+
+TEST_F(DebuggerTest, SymbolizeData) {
+  EXPECT_EQ(debug.Symbolize(0x024c, true), "_stack");
+  EXPECT_EQ(debug.Symbolize(0x024d, true), "_stack+0x1");
+  EXPECT_EQ(debug.Symbolize(0x024e, true), "");
+  EXPECT_EQ(debug.Symbolize(0xf800, true), "");
+}
+
+TEST_F(DebuggerTest, Block) {
+  // Past 0xFF, where byte reads used to wrap
+  const uint8_t data[] = {0x12, 0x34, 0x56};
+  debug.WriteBlock(0x0301, data, sizeof(data));
+  EXPECT_EQ(debug.GetMemoryByte(0x0301), 0x12);
+  EXPECT_EQ(debug.GetMemory(0x0302), 0x5634);
+
+  uint8_t copy[4];
+  debug.ReadBlock(0x0300, copy, sizeof(copy));
+  EXPECT_EQ(std::vector<uint8_t>(copy, copy + 4),
+            std::vector<uint8_t>({0x00, 0x12, 0x34, 0x56}));
+  EXPECT_EQ(debug.DumpMemory(0x0301, 3).substr(0, 18), "00000301  12 34 56");
+  EXPECT_THROW(debug.ReadBlock(0xffff, copy, 2), MemoryException);
+}
+
+TEST_F(DebuggerTest, AccessViolationEnabledLater) {
+  // A write to locked flash sets ACCVIFG, ACCVIE is only set afterwards
+  auto& irq = debug.proc.irq;
+  debug.mem.SetUint16BSwap(0xC000, 0);
+  EXPECT_TRUE(debug.mem.GetUint16(Flash::FCTL3_ADDR) & 0x0004);
+  EXPECT_EQ(irq.GetPending(), 0);
+
+  debug.mem.SetUint8(Flash::IE1_ADDR, Flash::ACCVIE);
+  EXPECT_EQ(irq.GetHighest(false), InterruptController::NMI);
+}
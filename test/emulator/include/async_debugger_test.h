@@ -0,0 +1,31 @@
+#ifndef async_debugger_test_h
+#define async_debugger_test_h
+
+#include <chrono>
+
+#include "async_debugger.h"
+#include "debugger.h"
+#include "gtest/gtest.h"
+
+class AsyncDebuggerTest : public ::testing::Test {
+ public:
+  AsyncDebuggerTest(){};
+  ~AsyncDebuggerTest(){};
+
+  // Stops the watchdog and counts R4 up in a loop at 0x0206
+  void SetUp() {
+    const uint8_t program[] = {0xb2, 0x40, 0x80, 0x5a, 0x20, 0x01,
+                               0x14, 0x53, 0xfe, 0x3f};
+    debug.LoadImage(0x200, program, sizeof(program));
+    *debug.proc.PC = 0x200;
+    async.Start();
+  };
+  void TearDown() { async.Stop(); };
+
+  static constexpr std::chrono::milliseconds TIMEOUT{5000};
+
+  Debugger debug;
+  AsyncDebugger async{debug};
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef cli_test_h
+#define cli_test_h
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+class CliTest : public ::testing::Test {
+ public:
+  CliTest(){};
+  ~CliTest(){};
+
+  void SetUp(){};
+  void TearDown(){};
+
+  /**
+   * @brief Everything the emulator writes to stdout for the given arguments,
+   * stderr is dropped
+   *
+   */
+  std::string Run(const std::string& args) {
+    std::string command = std::string(EMULATOR_PATH) + " " + DOCUMENT_PATH +
+                          " " + args + " 2>/dev/null";
+    std::string output;
+    auto pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+      return output;
+    }
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+      output.append(buffer, count);
+    }
+    pclose(pipe);
+    return output;
+  }
+};
+
+#endif
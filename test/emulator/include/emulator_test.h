@@ -0,0 +1,22 @@
+#ifndef emulator_test_h
+#define emulator_test_h
+
+#include <iostream>
+#include <sstream>
+
+#include "emulator.h"
+#include "gtest/gtest.h"
+
+class EmulatorTest : public ::testing::Test {
+ public:
+  EmulatorTest() : emulator(DOCUMENT_PATH){};
+  ~EmulatorTest(){};
+
+  void SetUp() { emulator.SetOutput(&output); };
+  void TearDown(){};
+
+  Emulator emulator;
+  std::ostringstream output;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef farm_test_h
+#define farm_test_h
+
+#include <iostream>
+
+#include "farm.h"
+#include "gtest/gtest.h"
+
+class FarmTest : public ::testing::Test {
+ public:
+  FarmTest() : farm(4){};
+  ~FarmTest(){};
+
+  void SetUp(){};
+  void TearDown(){};
+
+  Farm farm;
+};
+
+#endif
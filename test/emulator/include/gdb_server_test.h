@@ -0,0 +1,28 @@
+#ifndef gdb_server_test_h
+#define gdb_server_test_h
+
+#include <iostream>
+
+#include "debugger.h"
+#include "gdb_server.h"
+#include "gtest/gtest.h"
+
+class GdbServerTest : public ::testing::Test {
+ public:
+  GdbServerTest(){};
+  ~GdbServerTest(){};
+
+  void SetUp(){};
+  void TearDown(){};
+
+  // Stops the watchdog, stores 0x1234 to 0x0210 and loops at 0x020C
+  void LoadProgram() {
+    EXPECT_EQ(server.Handle("M200,e:b240805a2001b24034121002ff3f"), "OK");
+    EXPECT_EQ(server.Handle("P0=00020000"), "OK");
+  }
+
+  Debugger debug;
+  GdbServer server{debug};
+};
+
+#endif
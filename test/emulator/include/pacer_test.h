@@ -0,0 +1,20 @@
+#ifndef pacer_test_h
+#define pacer_test_h
+
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "pacer.h"
+
+class PacerTest : public ::testing::Test {
+ public:
+  PacerTest(){};
+  ~PacerTest(){};
+
+  void SetUp(){};
+  void TearDown(){};
+
+  Pacer pacer;
+};
+
+#endif
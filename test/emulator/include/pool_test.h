@@ -0,0 +1,22 @@
+#ifndef pool_test_h
+#define pool_test_h
+
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "pool.h"
+#include "server.h"
+
+class PoolTest : public ::testing::Test {
+ public:
+  PoolTest() : server(pool){};
+  ~PoolTest(){};
+
+  void SetUp(){};
+  void TearDown(){};
+
+  Pool pool;
+  PoolServer server;
+};
+
+#endif
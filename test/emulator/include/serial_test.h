@@ -0,0 +1,21 @@
+#ifndef serial_test_h
+#define serial_test_h
+
+#include <iostream>
+
+#include "debugger.h"
+#include "gtest/gtest.h"
+#include "serial.h"
+
+class SerialTest : public ::testing::Test {
+ public:
+  SerialTest(){};
+  ~SerialTest(){};
+
+  void SetUp(){};
+  void TearDown(){};
+
+  Debugger debug;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "async_debugger_test.h"
+
+#include <thread>
+
+TEST_F(AsyncDebuggerTest, Steps) {
+  DebugEvent event;
+  async.Resume(10);
+  ASSERT_TRUE(async.WaitEvent(event, TIMEOUT));
+  EXPECT_EQ(event.type, EVENT::STOPPED);
+  EXPECT_EQ(event.reason, STOP_REASON::STEP_LIMIT);
+  EXPECT_FALSE(async.IsRunning());
+  EXPECT_EQ(async.Call([](Debugger& debug) { return debug.proc.instructions; })
+                .get(),
+            10);
+  // inc and jmp alternate after the first mov
+  EXPECT_EQ(async.Call([](Debugger& debug) { return debug.GetRegister(4); })
+                .get(),
+            5);
+}
+
+TEST_F(AsyncDebuggerTest, Breakpoint) {
+  DebugEvent event;
+  async.Resume(1000);
+  ASSERT_TRUE(async.WaitEvent(event, TIMEOUT));
+  async.SetBreakpoint(0x206);
+  async.Resume();
+  ASSERT_TRUE(async.WaitEvent(event, TIMEOUT));
+  EXPECT_EQ(event.type, EVENT::STOPPED);
+  EXPECT_EQ(event.reason, STOP_REASON::BREAKPOINT);
+  EXPECT_EQ(event.pc, 0x206);
+
+  async.ClearBreakpoint(0x206);
+  async.Resume(100);
+  ASSERT_TRUE(async.WaitEvent(event, TIMEOUT));
+  EXPECT_EQ(event.reason, STOP_REASON::STEP_LIMIT);
+}
+
+TEST_F(AsyncDebuggerTest, InspectWhileRunning) {
+  async.Resume();
+  // Calls run between blocks, keep asking until a block has gone by
+  auto Instructions = [this]() {
+    return async.Call([](Debugger& debug) { return debug.proc.instructions; })
+        .get();
+  };
+  uint64_t last = 0;
+  for (int x = 0; x < 3; x++) {
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    auto instructions = Instructions();
+    while (instructions <= last &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      instructions = Instructions();
+    }
+    EXPECT_GT(instructions, last);
+    last = instructions;
+  }
+  EXPECT_TRUE(async.IsRunning());
+
+  DebugEvent event;
+  async.Pause();
+  ASSERT_TRUE(async.WaitEvent(event, TIMEOUT));
+  EXPECT_EQ(event.type, EVENT::PAUSED);
+  EXPECT_FALSE(async.IsRunning());
+  auto cycles =
+      async.Call([](Debugger& debug) { return debug.proc.cycles; }).get();
+  EXPECT_EQ(cycles, event.cycles);
+  EXPECT_FALSE(async.PollEvent(event));
+}
+
+TEST_F(AsyncDebuggerTest, Fault) {
+  // mov #0x0100, pc
+  async.Call([](Debugger& debug) {
+    debug.mem.WriteRaw(0x206, 0x4030, false);
+    debug.mem.WriteRaw(0x208, 0x0100, false);
+  });
+  async.Resume();
+  DebugEvent event;
+  ASSERT_TRUE(async.WaitEvent(event, TIMEOUT));
+  EXPECT_EQ(event.type, EVENT::FAULT);
+  EXPECT_EQ(event.pc, 0x100);
+  EXPECT_EQ(event.error,
+            "Tried to fetch instruction from peripheral address space");
+}
@@ -0,0 +1,154 @@
+#include "cli_test.h"
+
+#include <unistd.h>
+
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Just enough of a JSON parser to tell whether text is one valid
+ * value and nothing else
+ *
+ */
+class JsonChecker {
+ public:
+  JsonChecker(const std::string& text) : text(text){};
+
+  bool IsValid() {
+    if (!Value()) {
+      return false;
+    }
+    Spaces();
+    return pos == text.size();
+  }
+
+ private:
+  bool Value() {
+    Spaces();
+    if (pos >= text.size()) {
+      return false;
+    }
+    switch (text[pos]) {
+      case '{':
+        return Container('}', true);
+      case '[':
+        return Container(']', false);
+      case '"':
+        return String();
+      case 't':
+        return Word("true");
+      case 'f':
+        return Word("false");
+      case 'n':
+        return Word("null");
+      default:
+        return Number();
+    }
+  }
+
+  bool Container(char end, bool object) {
+    pos++;
+    Spaces();
+    if (pos < text.size() && text[pos] == end) {
+      pos++;
+      return true;
+    }
+    while (true) {
+      if (object) {
+        Spaces();
+        if (pos >= text.size() || text[pos] != '"' || !String()) {
+          return false;
+        }
+        Spaces();
+        if (pos >= text.size() || text[pos++] != ':') {
+          return false;
+        }
+      }
+      if (!Value()) {
+        return false;
+      }
+      Spaces();
+      if (pos >= text.size()) {
+        return false;
+      }
+      auto c = text[pos++];
+      if (c == end) {
+        return true;
+      }
+      if (c != ',') {
+        return false;
+      }
+    }
+  }
+
+  bool String() {
+    pos++;
+    while (pos < text.size() && text[pos] != '"') {
+      if (static_cast<unsigned char>(text[pos]) < 0x20) {
+        return false;
+      }
+      pos += (text[pos] == '\\') ? 2 : 1;
+    }
+    return pos++ < text.size();
+  }
+
+  bool Word(const char* word) {
+    auto size = strlen(word);
+    if (text.compare(pos, size, word) != 0) {
+      return false;
+    }
+    pos += size;
+    return true;
+  }
+
+  bool Number() {
+    auto start = pos;
+    while (pos < text.size() && (isdigit(text[pos]) ||
+                                 strchr("+-.eE", text[pos]) != nullptr)) {
+      pos++;
+    }
+    return pos > start;
+  }
+
+  void Spaces() {
+    while (pos < text.size() && isspace(text[pos])) {
+      pos++;
+    }
+  }
+
+  const std::string& text;
+  size_t pos{0};
+};
+
+}  // namespace
+
+TEST_F(CliTest, StdoutIsJson) {
+  // The firmware writes P1OUT, which is logged to stderr
+  auto output = Run("--cycles 2000");
+  EXPECT_TRUE(JsonChecker(output).IsValid()) << output;
+  EXPECT_NE(output.find("\"exit_reason\":\"fault\""), std::string::npos);
+}
+
+TEST_F(CliTest, TraceKeepsStdoutJson) {
+  for (auto level : {"1", "2"}) {
+    auto output = Run(std::string("--cycles 2000 --trace ") + level);
+    EXPECT_TRUE(JsonChecker(output).IsValid()) << output;
+  }
+}
+
+TEST_F(CliTest, TraceFile) {
+  std::string path = "/tmp/msp430emu_cli_test_" + std::to_string(getpid());
+  auto output = Run("--cycles 2000 --trace 1 --trace-file " + path);
+  EXPECT_TRUE(JsonChecker(output).IsValid()) << output;
+
+  FILE* file = fopen(path.c_str(), "r");
+  ASSERT_NE(file, nullptr);
+  char buffer[4096];
+  std::string trace(buffer, fread(buffer, 1, sizeof(buffer), file));
+  fclose(file);
+  remove(path.c_str());
+  EXPECT_EQ(trace.find("PC: 0xf842\n"), 0);
+  EXPECT_NE(trace.find("P1OUT: 0x1\n"), std::string::npos);
+}
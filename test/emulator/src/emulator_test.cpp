@@ -0,0 +1,60 @@
+#include "emulator_test.h"
+
+TEST_F(EmulatorTest, CycleLimit) {
+  EXPECT_EQ(emulator.Run(10), EXIT_REASON::CYCLE_LIMIT);
+  EXPECT_GE(emulator.GetCycles(), 10);
+}
+
+TEST_F(EmulatorTest, InstructionLimit) {
+  StopConditions stop;
+  stop.max_instructions = 3;
+  EXPECT_EQ(emulator.Run(stop), EXIT_REASON::INSTRUCTION_LIMIT);
+  EXPECT_EQ(emulator.GetInstructions(), 3);
+}
+
+TEST_F(EmulatorTest, PCReached) {
+  StopConditions stop;
+  stop.pc = 0xf800;  // main
+  EXPECT_EQ(emulator.Run(stop), EXIT_REASON::PC_REACHED);
+  EXPECT_EQ(emulator.GetDebugger().GetPC(), 0xf800);
+}
+
+TEST_F(EmulatorTest, SentinelWrite) {
+  StopConditions stop;
+  stop.sentinel = 0x22;  // P1DIR
+  EXPECT_EQ(emulator.Run(stop), EXIT_REASON::SENTINEL_WRITE);
+  EXPECT_EQ(emulator.GetDebugger().GetPC(), 0xf818);
+
+  // Hook is removed once the run is over
+  stop.sentinel.reset();
+  stop.max_instructions = 1;
+  EXPECT_EQ(emulator.Run(stop), EXIT_REASON::INSTRUCTION_LIMIT);
+}
+
+TEST_F(EmulatorTest, SentinelKeepsHook) {
+  auto& mem = emulator.GetDebugger().mem;
+  int writes = 0;
+  mem.SetWriteHook(0x22, [&](MemAddr, uint8_t) { writes++; });
+  StopConditions stop;
+  stop.sentinel = 0x22;
+  EXPECT_EQ(emulator.Run(stop), EXIT_REASON::SENTINEL_WRITE);
+  EXPECT_EQ(writes, 1);
+
+  // The caller's hook is back on its own after the run
+  ASSERT_TRUE(mem.GetWriteHook(0x22));
+  mem.GetWriteHook(0x22)(0x22, 0);
+  EXPECT_EQ(writes, 2);
+}
+
+TEST_F(EmulatorTest, Fault) {
+  EXPECT_THROW(emulator.Run(), ProcessorException);
+  EXPECT_EQ(output.str(), "P1OUT: 0x1\n");
+}
+
+TEST_F(EmulatorTest, Trace) {
+  emulator.SetTrace(Emulator::TRACE_PC);
+  StopConditions stop;
+  stop.max_instructions = 1;
+  emulator.Run(stop);
+  EXPECT_EQ(output.str(), "PC: 0xf842\n");
+}
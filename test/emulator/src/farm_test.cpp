@@ -0,0 +1,70 @@
+#include "farm_test.h"
+
+#include <set>
+
+TEST_F(FarmTest, Workers) { EXPECT_EQ(farm.GetWorkers(), 4); }
+
+TEST_F(FarmTest, RunJobs) {
+  constexpr size_t JOBS = 64;
+  for (size_t x = 0; x < JOBS; x++) {
+    EXPECT_EQ(farm.Submit({DOCUMENT_PATH, 1000}), x);
+  }
+
+  auto results = farm.Wait();
+  ASSERT_EQ(results.size(), JOBS);
+  for (size_t x = 0; x < JOBS; x++) {
+    EXPECT_EQ(results[x].id, x) << "Results not ordered by job";
+    EXPECT_EQ(results[x].filepath, DOCUMENT_PATH);
+    EXPECT_GT(results[x].cycles, 0);
+    // Blinker toggles P1OUT before running into an unimplemented opcode
+    EXPECT_EQ(results[x].output, "P1OUT: 0x1\n");
+    EXPECT_EQ(results[x].exit_reason, EXIT_REASON::FAULT);
+    EXPECT_EQ(results[x].error, "JC_JHS Undefined");
+  }
+}
+
+TEST_F(FarmTest, Slices) {
+  // jmp $ at the reset vector so the job only stops at its cycle limit
+  constexpr uint8_t LOOP[] = {0xff, 0x3f};
+  constexpr unsigned SLICES = 4;
+  constexpr size_t JOBS = 32;
+  FarmJob loop{DOCUMENT_PATH, SLICES * Farm::SLICE_CYCLES,
+               [&](Emulator& emulator) {
+                 auto& debug = emulator.GetDebugger();
+                 debug.LoadImage(debug.GetPC(), LOOP, sizeof(LOOP));
+               }};
+
+  // Every fourth job lands on the first worker, which the others drain
+  for (size_t x = 0; x < JOBS; x++) {
+    farm.Submit(x % farm.GetWorkers() ? FarmJob{DOCUMENT_PATH, 1000} : loop);
+  }
+
+  auto results = farm.Wait();
+  ASSERT_EQ(results.size(), JOBS);
+  std::set<size_t> workers;
+  for (size_t x = 0; x < JOBS; x += farm.GetWorkers()) {
+    EXPECT_EQ(results[x].exit_reason, EXIT_REASON::CYCLE_LIMIT);
+    EXPECT_GE(results[x].cycles, SLICES * Farm::SLICE_CYCLES);
+    EXPECT_EQ(results[x].slices, SLICES);
+    workers.insert(results[x].workers.begin(), results[x].workers.end());
+  }
+  EXPECT_GT(workers.size(), 1) << "Requeued slices were never stolen";
+}
+
+TEST_F(FarmTest, Fault) {
+  farm.Submit({"/bad", 1000});
+  auto results = farm.Wait();
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].exit_reason, EXIT_REASON::FAULT);
+  EXPECT_EQ(results[0].error, "File does not exist");
+  EXPECT_EQ(results[0].cycles, 0);
+}
+
+TEST_F(FarmTest, Reuse) {
+  farm.Submit({"/bad", 1000});
+  farm.Wait();
+  farm.Submit({"/bad", 1000});
+  farm.Submit({"/bad", 1000});
+  auto results = farm.Wait();
+  ASSERT_EQ(results.size(), 2);
+}
@@ -0,0 +1,193 @@
+#include "gdb_server_test.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <future>
+#include <string>
+
+namespace {
+
+std::string Frame(const std::string& data) {
+  uint8_t sum = 0;
+  for (auto c : data) {
+    sum += c;
+  }
+  char checksum[3];
+  snprintf(checksum, sizeof(checksum), "%02x", sum);
+  return "$" + data + "#" + checksum;
+}
+
+bool Send(int fd, const std::string& data) {
+  return write(fd, data.data(), data.size()) ==
+         static_cast<ssize_t>(data.size());
+}
+
+std::string Receive(int fd, size_t size) {
+  std::string data;
+  char buffer[256];
+  while (data.size() < size) {
+    auto count =
+        read(fd, buffer, std::min(sizeof(buffer), size - data.size()));
+    if (count <= 0) {
+      break;
+    }
+    data.append(buffer, count);
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST_F(GdbServerTest, Registers) {
+  auto regs = server.Handle("g");
+  ASSERT_EQ(regs.size(), 8u * GdbServer::REGISTERS);
+
+  EXPECT_EQ(server.Handle("P4=34120000"), "OK");
+  EXPECT_EQ(debug.GetRegister(4), 0x1234);
+  EXPECT_EQ(server.Handle("p4"), "34120000");
+  EXPECT_EQ(server.Handle("p10"), "E01");
+  EXPECT_EQ(server.Handle("P4=3412"), "E01");
+
+  regs.replace(8 * 15, 8, "cdab0000");
+  EXPECT_EQ(server.Handle("G" + regs), "OK");
+  EXPECT_EQ(debug.GetRegister(15), 0xabcd);
+  EXPECT_EQ(server.Handle("g"), regs);
+  EXPECT_EQ(server.Handle("G00"), "E01");
+}
+
+TEST_F(GdbServerTest, Memory) {
+  EXPECT_EQ(server.Handle("M200,4:deadbeef"), "OK");
+  EXPECT_EQ(debug.mem.GetUint8(0x200), 0xde);
+  EXPECT_EQ(server.Handle("m200,4"), "deadbeef");
+  EXPECT_EQ(server.Handle("m201,2"), "adbe");
+
+  // 0x7d escapes the byte after it, which is xored with 0x20
+  EXPECT_EQ(server.Handle("X210,3:a}]b"), "OK");
+  EXPECT_EQ(server.Handle("m210,3"), "617d62");
+
+  // Reads stop at the end of memory
+  EXPECT_EQ(server.Handle("mfffe,10").size(), 4u);
+  EXPECT_EQ(server.Handle("m10000,1"), "E01");
+  EXPECT_EQ(server.Handle("M200,2:00"), "E01");
+  EXPECT_EQ(server.Handle("M200,1:zz"), "E01");
+  EXPECT_EQ(server.Handle("vMustReplyEmpty"), "");
+}
+
+TEST_F(GdbServerTest, Breakpoint) {
+  LoadProgram();
+  EXPECT_EQ(server.Handle("Z0,20c,2"), "OK");
+  EXPECT_TRUE(debug.HasBreakpoint(0x20c));
+  EXPECT_EQ(server.Handle("c"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x20c);
+
+  // Continuing from the breakpoint runs the loop once more
+  EXPECT_EQ(server.Handle("c"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x20c);
+
+  EXPECT_EQ(server.Handle("z0,20c,2"), "OK");
+  EXPECT_FALSE(debug.HasBreakpoint(0x20c));
+}
+
+TEST_F(GdbServerTest, Step) {
+  LoadProgram();
+  EXPECT_EQ(server.Handle("s"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x206);
+  EXPECT_EQ(server.Handle("s206"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x20c);
+  EXPECT_EQ(debug.mem.GetUint16(0x210), 0x1234);
+}
+
+TEST_F(GdbServerTest, Watchpoint) {
+  LoadProgram();
+  EXPECT_EQ(server.Handle("Z2,210,2"), "OK");
+  EXPECT_EQ(server.Handle("c"), "T05watch:0210;");
+  EXPECT_EQ(debug.GetPC(), 0x20c);
+  EXPECT_EQ(server.Handle("z2,210,2"), "OK");
+
+  EXPECT_EQ(server.Handle("P0=00020000"), "OK");
+  EXPECT_EQ(server.Handle("Z4,210,2"), "OK");
+  EXPECT_EQ(server.Handle("c"), "T05awatch:0210;");
+  EXPECT_EQ(server.Handle("z4,210,2"), "OK");
+  EXPECT_EQ(server.Handle("Z5,210,2"), "");
+}
+
+TEST_F(GdbServerTest, Reverse) {
+  LoadProgram();
+  EXPECT_EQ(server.Handle("bs"), "E01");
+  debug.StartRecording();
+  EXPECT_EQ(server.Handle("s"), "S05");
+  EXPECT_EQ(server.Handle("s"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x20c);
+  EXPECT_EQ(server.Handle("bs"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x206);
+  EXPECT_EQ(server.Handle("bs"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x200);
+  EXPECT_EQ(server.Handle("bs"), "T05replaylog:begin;");
+
+  EXPECT_EQ(server.Handle("Z0,206,2"), "OK");
+  EXPECT_EQ(server.Handle("s"), "S05");
+  EXPECT_EQ(server.Handle("s"), "S05");
+  EXPECT_EQ(server.Handle("bc"), "S05");
+  EXPECT_EQ(debug.GetPC(), 0x206);
+  EXPECT_EQ(server.Handle("bc"), "T05replaylog:begin;");
+
+  // Writes start the recording over
+  EXPECT_EQ(server.Handle("s"), "S05");
+  EXPECT_EQ(server.Handle("M210,2:0000"), "OK");
+  EXPECT_EQ(server.Handle("bs"), "T05replaylog:begin;");
+  EXPECT_EQ(debug.GetPC(), 0x206);
+}
+
+TEST_F(GdbServerTest, Monitor) {
+  LoadProgram();
+  EXPECT_EQ(server.Handle("s"), "S05");
+  auto Decode = [](const std::string& hex) {
+    std::string text;
+    for (size_t x = 0; x + 1 < hex.size(); x += 2) {
+      text += static_cast<char>(std::stoi(hex.substr(x, 2), nullptr, 16));
+    }
+    return text;
+  };
+  // "history" and "help"
+  auto history = Decode(server.Handle("qRcmd,686973746f7279"));
+  EXPECT_EQ(history.find("last 1 of 1 instructions:\n"), 0);
+  EXPECT_NE(history.find("0200  40b2  mov"), std::string::npos);
+  auto help = Decode(server.Handle("qRcmd,68656c70"));
+  EXPECT_EQ(help.find("unknown command: help"), 0);
+  // "dump 0x200 4"
+  EXPECT_EQ(Decode(server.Handle("qRcmd,64756d702030783230302034"))
+                .substr(0, 21),
+            "00000200  b2 40 80 5a");
+}
+
+TEST_F(GdbServerTest, Connection) {
+  LoadProgram();
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  auto served = std::async(std::launch::async,
+                           [this, &fds]() { return server.Serve(fds[0]); });
+  int client = fds[1];
+
+  ASSERT_TRUE(Send(client, Frame("?")));
+  EXPECT_EQ(Receive(client, 8), "+" + Frame("S05"));
+
+  // A bad checksum is nacked
+  ASSERT_TRUE(Send(client, "$?#00"));
+  EXPECT_EQ(Receive(client, 1), "-");
+
+  ASSERT_TRUE(Send(client, Frame("QStartNoAckMode")));
+  EXPECT_EQ(Receive(client, 7), "+" + Frame("OK"));
+
+  // Runs until interrupted
+  ASSERT_TRUE(Send(client, Frame("c")));
+  usleep(10000);
+  ASSERT_TRUE(Send(client, "\x03"));
+  EXPECT_EQ(Receive(client, 7), Frame("S02"));
+  EXPECT_EQ(debug.GetPC(), 0x20c);
+
+  ASSERT_TRUE(Send(client, Frame("k")));
+  EXPECT_FALSE(served.get());
+  close(client);
+}
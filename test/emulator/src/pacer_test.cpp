@@ -0,0 +1,58 @@
+#include "pacer_test.h"
+
+#include <thread>
+
+using std::chrono::milliseconds;
+
+TEST_F(PacerTest, MaxSpeed) {
+  pacer.SetMode(PACING::MAX_SPEED);
+  pacer.Start(0, 1000000);
+  EXPECT_EQ(pacer.NextPace(), UINT64_MAX) << "Max speed should never pace";
+}
+
+TEST_F(PacerTest, RealTime) {
+  pacer.SetMode(PACING::REAL_TIME);
+  pacer.Start(0, 1000000);
+  EXPECT_EQ(pacer.NextPace(), 1000) << "Batch should be 1ms of cycles";
+
+  // 20ms of virtual time at 1MHz
+  auto start = Pacer::clock_type::now();
+  pacer.Pace(20000, 1000000);
+  auto elapsed = Pacer::clock_type::now() - start;
+  EXPECT_GE(elapsed, milliseconds(19));
+  EXPECT_EQ(pacer.NextPace(), 21000);
+}
+
+TEST_F(PacerTest, Scaled) {
+  pacer.SetMode(PACING::SCALED, 10.0);
+  pacer.Start(0, 1000000);
+  EXPECT_EQ(pacer.NextPace(), 10000);
+
+  // 200ms of virtual time at 10x takes 20ms
+  auto start = Pacer::clock_type::now();
+  pacer.Pace(200000, 1000000);
+  auto elapsed = Pacer::clock_type::now() - start;
+  EXPECT_GE(elapsed, milliseconds(19));
+  EXPECT_LT(elapsed, milliseconds(150));
+}
+
+TEST_F(PacerTest, Drift) {
+  pacer.SetMode(PACING::REAL_TIME);
+  pacer.Start(0, 1000000);
+
+  // Fall behind by more than MAX_DRIFT, pacer should re-anchor
+  std::this_thread::sleep_for(Pacer::MAX_DRIFT + milliseconds(50));
+  pacer.Pace(1000, 1000000);
+
+  auto start = Pacer::clock_type::now();
+  pacer.Pace(11000, 1000000);
+  auto elapsed = Pacer::clock_type::now() - start;
+  EXPECT_GE(elapsed, milliseconds(9)) << "Pacer did not re-anchor";
+}
+
+TEST_F(PacerTest, ClockSwitch) {
+  pacer.SetMode(PACING::REAL_TIME);
+  pacer.Start(0, 1000000);
+  pacer.Pace(1000, 8000000);
+  EXPECT_EQ(pacer.NextPace(), 1000 + 8000) << "Batch not rescaled";
+}
@@ -0,0 +1,117 @@
+#include "pool_test.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <thread>
+
+TEST_F(PoolTest, Load) {
+  pool.Load(DOCUMENT_PATH, 3);
+  EXPECT_EQ(pool.GetIdle(DOCUMENT_PATH), 3);
+
+  auto instance = pool.Acquire(DOCUMENT_PATH);
+  EXPECT_EQ(pool.GetIdle(DOCUMENT_PATH), 2);
+  pool.Release(DOCUMENT_PATH, std::move(instance));
+  EXPECT_EQ(pool.GetIdle(DOCUMENT_PATH), 3);
+}
+
+TEST_F(PoolTest, Load_Limit) {
+  std::string firmware = DOCUMENT_PATH;
+  EXPECT_NE(server.Handle("load " + firmware + " 0xffffffff")
+                .find("\"ok\":false"),
+            std::string::npos);
+  EXPECT_THROW(pool.Load(DOCUMENT_PATH, Pool::MAX_IDLE + 1), PoolException);
+  EXPECT_EQ(pool.GetIdle(DOCUMENT_PATH), 1);
+
+  // Instances handed back past the limit are dropped
+  pool.Load(DOCUMENT_PATH, Pool::MAX_IDLE);
+  auto first = pool.Acquire(DOCUMENT_PATH);
+  auto second = pool.Acquire(DOCUMENT_PATH);
+  pool.Release(DOCUMENT_PATH, std::move(first));
+  pool.Release(DOCUMENT_PATH, std::move(second));
+  pool.Release(DOCUMENT_PATH, std::make_unique<PoolInstance>());
+  EXPECT_EQ(pool.GetIdle(DOCUMENT_PATH), Pool::MAX_IDLE);
+}
+
+TEST_F(PoolTest, Release_Resets) {
+  auto instance = pool.Acquire(DOCUMENT_PATH);
+  auto& debug = instance->emulator.GetDebugger();
+  EXPECT_EQ(debug.GetPC(), 0xf842);
+
+  EXPECT_THROW(instance->emulator.Run(), ProcessorException);
+  EXPECT_EQ(instance->output.str(), "P1OUT: 0x1\n");
+  debug.mem.SetUint8(0x200, 0xAA);
+  pool.Release(DOCUMENT_PATH, std::move(instance));
+
+  instance = pool.Acquire(DOCUMENT_PATH);
+  auto& reset = instance->emulator.GetDebugger();
+  EXPECT_EQ(reset.GetPC(), 0xf842);
+  EXPECT_EQ(reset.GetSP(), 0);
+  EXPECT_EQ(reset.mem.GetUint8(0x200), 0);
+  EXPECT_EQ(reset.mem.GetUint8(0x21), 0);
+  EXPECT_EQ(instance->emulator.GetCycles(), 0);
+  EXPECT_EQ(instance->output.str(), "");
+  EXPECT_EQ(reset.proc.history.GetCount(), 0);
+  EXPECT_EQ(reset.clock.GetNanoseconds(0), 0);
+
+  // Same run as a freshly loaded instance
+  EXPECT_THROW(instance->emulator.Run(), ProcessorException);
+  EXPECT_EQ(instance->emulator.GetInstructions(), 14);
+  EXPECT_EQ(instance->emulator.GetCycles(), 52);
+}
+
+TEST_F(PoolTest, Handle_Run) {
+  std::string firmware = DOCUMENT_PATH;
+  auto response = server.Handle("run " + firmware +
+                                " pc=0xf800 set=0x200:0x5a read=0x200:2");
+  EXPECT_NE(response.find("\"exit_reason\":\"pc_reached\""),
+            std::string::npos);
+  EXPECT_NE(response.find("\"r0\":63488"), std::string::npos);
+  EXPECT_NE(response.find("\"512\":\"5a00\""), std::string::npos);
+
+  response = server.Handle("run " + firmware);
+  EXPECT_NE(response.find("\"exit_reason\":\"fault\""), std::string::npos);
+  EXPECT_NE(response.find("\"output\":\"P1OUT: 0x1\\u000a\""),
+            std::string::npos);
+  EXPECT_EQ(pool.GetIdle(DOCUMENT_PATH), 1);
+}
+
+TEST_F(PoolTest, Handle_Invalid) {
+  EXPECT_EQ(server.Handle("ping"), "{\"ok\":true}");
+  EXPECT_NE(server.Handle("bogus").find("\"ok\":false"), std::string::npos);
+  EXPECT_NE(server.Handle("run x cycles").find("\"ok\":false"),
+            std::string::npos);
+  EXPECT_NE(server.Handle("run /does/not/exist").find("File does not exist"),
+            std::string::npos);
+}
+
+TEST_F(PoolTest, Socket) {
+  std::string path = "/tmp/msp430emu_pool_test_" + std::to_string(getpid());
+  server.Listen(path);
+  std::thread serve(&PoolServer::Serve, &server);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  std::copy(path.begin(), path.end(), addr.sun_path);
+  ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+  std::string request = "ping\nload " + std::string(DOCUMENT_PATH) + " 2\n";
+  ASSERT_EQ(write(fd, request.data(), request.size()),
+            static_cast<ssize_t>(request.size()));
+
+  std::string response;
+  char buffer[256];
+  while (std::count(response.begin(), response.end(), '\n') < 2) {
+    auto count = read(fd, buffer, sizeof(buffer));
+    ASSERT_GT(count, 0);
+    response.append(buffer, count);
+  }
+  EXPECT_EQ(response, "{\"ok\":true}\n{\"ok\":true,\"idle\":2}\n");
+
+  server.Stop();
+  serve.join();
+  close(fd);
+  EXPECT_NE(access(path.c_str(), F_OK), 0);
+}
@@ -0,0 +1,60 @@
+#include "serial_test.h"
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+
+TEST_F(SerialTest, File) {
+  auto path = testing::TempDir() + "serial_test.log";
+  {
+    SerialHost host(&debug.uart);
+    host.Open(path);
+    host.Start();
+    std::string text = "hello, world\n";
+    debug.uart.GetTxBuffer().Write(
+        reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    host.Stop();
+  }
+
+  std::ifstream log(path);
+  std::stringstream contents;
+  contents << log.rdbuf();
+  EXPECT_EQ(contents.str(), "hello, world\n");
+  unlink(path.c_str());
+}
+
+TEST_F(SerialTest, Pty) {
+  SerialHost host(&debug.uart);
+  host.Open("pty");
+  ASSERT_FALSE(host.GetPtyName().empty());
+
+  // Stands in for a terminal on the other end
+  auto fd = open(host.GetPtyName().c_str(), O_RDWR | O_NOCTTY);
+  ASSERT_GE(fd, 0);
+  termios attributes;
+  tcgetattr(fd, &attributes);
+  cfmakeraw(&attributes);
+  tcsetattr(fd, TCSANOW, &attributes);
+
+  ASSERT_EQ(write(fd, "ok", 2), 2);
+  auto& rx = debug.uart.GetRxBuffer();
+  for (int x = 0; x < 1000 && rx.Size() < 2; x++) {
+    host.Flush();
+    usleep(1000);
+  }
+  uint8_t val;
+  ASSERT_TRUE(rx.Pop(val));
+  EXPECT_EQ(val, 'o');
+  ASSERT_TRUE(rx.Pop(val));
+  EXPECT_EQ(val, 'k');
+
+  debug.uart.GetTxBuffer().Push('!');
+  host.Flush();
+  char echo = 0;
+  EXPECT_EQ(read(fd, &echo, 1), 1);
+  EXPECT_EQ(echo, '!');
+  close(fd);
+}
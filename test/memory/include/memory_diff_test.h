@@ -0,0 +1,33 @@
+#ifndef memory_diff_test_h
+#define memory_diff_test_h
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "memory.h"
+#include "memory_diff.h"
+
+class MemoryDiffTest : public ::testing::Test {
+ public:
+  MemoryDiffTest(){};
+  ~MemoryDiffTest(){};
+
+  void SetUp() {
+    std::mt19937 random(430);
+    for (auto& byte : a) {
+      byte = random();
+    }
+    b = a;
+  };
+  void TearDown(){};
+
+  std::vector<uint8_t> a = std::vector<uint8_t>(Memory::MEM_SIZE);
+  std::vector<uint8_t> b;
+
+  static constexpr DIFF_KERNEL KERNELS[] = {
+      DIFF_KERNEL::SCALAR, DIFF_KERNEL::SSE2, DIFF_KERNEL::AVX2,
+      DIFF_KERNEL::BEST};
+};
+
+#endif
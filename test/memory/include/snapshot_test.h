@@ -0,0 +1,20 @@
+#ifndef snapshot_test_h
+#define snapshot_test_h
+
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "snapshot.h"
+
+class SnapshotTest : public ::testing::Test {
+ public:
+  SnapshotTest(){};
+  ~SnapshotTest(){};
+
+  void SetUp(){};
+  void TearDown(){};
+
+  Snapshot snapshot;
+};
+
+#endif
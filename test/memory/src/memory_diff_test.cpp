@@ -0,0 +1,78 @@
+#include "memory_diff_test.h"
+
+TEST_F(MemoryDiffTest, Same) {
+  for (auto kernel : KERNELS) {
+    if (IsSupported(kernel)) {
+      EXPECT_TRUE(DiffMemory(a.data(), b.data(), a.size(), 0, kernel).empty());
+    }
+  }
+}
+
+TEST_F(MemoryDiffTest, Ranges) {
+  // Either end of memory and across vector boundaries
+  b[0] ^= 1;
+  for (int x = 30; x < 34; x++) {
+    b[x] ^= 0xFF;
+  }
+  b[0x200] ^= 0x80;
+  b[0x202] ^= 0x80;
+  for (int x = 0x1000; x < 0x1100; x++) {
+    b[x] ^= 0x5A;
+  }
+  b[0xFFFF] ^= 1;
+
+  for (auto kernel : KERNELS) {
+    if (!IsSupported(kernel)) {
+      continue;
+    }
+    auto ranges = DiffMemory(a.data(), b.data(), a.size(), 0, kernel);
+    ASSERT_EQ(ranges.size(), 6);
+    EXPECT_EQ(ranges[0].addr, 0);
+    EXPECT_EQ(ranges[0].size, 1);
+    EXPECT_EQ(ranges[1].addr, 30);
+    EXPECT_EQ(ranges[1].size, 4);
+    EXPECT_EQ(ranges[2].addr, 0x200);
+    EXPECT_EQ(ranges[3].addr, 0x202);
+    EXPECT_EQ(ranges[4].addr, 0x1000);
+    EXPECT_EQ(ranges[4].size, 0x100);
+    EXPECT_EQ(ranges[5].addr, 0xFFFF);
+    EXPECT_EQ(ranges[5].size, 1);
+
+    // One equal byte apart
+    ranges = DiffMemory(a.data(), b.data(), a.size(), 1, kernel);
+    ASSERT_EQ(ranges.size(), 5);
+    EXPECT_EQ(ranges[2].addr, 0x200);
+    EXPECT_EQ(ranges[2].size, 3);
+  }
+}
+
+TEST_F(MemoryDiffTest, Random) {
+  std::mt19937 random(2553);
+  for (int x = 0; x < 2000; x++) {
+    b[random() % b.size()] ^= 1 << (random() % 8);
+  }
+  // Every differing byte is in exactly one range
+  auto expected = DiffMemory(a.data(), b.data(), a.size(), 0,
+                             DIFF_KERNEL::SCALAR);
+  std::vector<bool> covered(a.size());
+  for (auto& range : expected) {
+    for (uint32_t x = range.addr; x < range.addr + range.size; x++) {
+      covered[x] = true;
+    }
+  }
+  for (size_t x = 0; x < a.size(); x++) {
+    EXPECT_EQ(covered[x], a[x] != b[x]) << x;
+  }
+
+  for (auto kernel : KERNELS) {
+    if (!IsSupported(kernel)) {
+      continue;
+    }
+    auto ranges = DiffMemory(a.data(), b.data(), a.size(), 0, kernel);
+    ASSERT_EQ(ranges.size(), expected.size());
+    for (size_t x = 0; x < ranges.size(); x++) {
+      EXPECT_EQ(ranges[x].addr, expected[x].addr);
+      EXPECT_EQ(ranges[x].size, expected[x].size);
+    }
+  }
+}
@@ -1,5 +1,36 @@
 #include "memory_test.h"
 
+#include <elf.h>
+#include <sstream>
+
+namespace {
+
+/**
+ * @brief ELF image with a single loadable segment and nothing else
+ *
+ */
+std::string SegmentElf(Elf32_Addr addr, Elf32_Word mem_size,
+                       Elf32_Word file_size) {
+  std::string image(0x1000, '\0');
+  Elf32_Ehdr header{};
+  std::copy(ELFMAG, ELFMAG + SELFMAG, header.e_ident);
+  header.e_phoff = sizeof(header);
+  header.e_phentsize = sizeof(Elf32_Phdr);
+  header.e_phnum = 1;
+  Elf32_Phdr segment{};
+  segment.p_type = PT_LOAD;
+  segment.p_paddr = addr;
+  segment.p_memsz = mem_size;
+  segment.p_filesz = file_size;
+  image.replace(0, sizeof(header), reinterpret_cast<char*>(&header),
+                sizeof(header));
+  image.replace(sizeof(header), sizeof(segment),
+                reinterpret_cast<char*>(&segment), sizeof(segment));
+  return image;
+}
+
+}  // namespace
+
 TEST_F(MemoryTest, GetUint8) {
   for (uint32_t addr = 0; addr < Memory::MEM_SIZE; addr++) {
     ASSERT_EQ(mem.GetUint8(addr), 0x00)
@@ -44,3 +75,55 @@ TEST_F(MemoryTest, ElfReader) {
   auto val = mem.GetUint16(0xfffe);
   EXPECT_EQ(val, 0xf842) << "Memory not loaded properly";
 }
+
+TEST_F(MemoryTest, ElfSegmentTooLarge) {
+  // File data running past the end of its segment at the top of memory
+  std::istringstream elf(SegmentElf(0xfff0, 0x10, 0x1000));
+  EXPECT_THROW(mem.LoadElf(elf), MemoryException);
+}
+
+TEST_F(MemoryTest, ElfSegmentOutOfRange) {
+  // An address that only fits once cut down to 16 bits
+  std::istringstream elf(SegmentElf(0x410000, 0x10, 0x10));
+  EXPECT_THROW(mem.LoadElf(elf), MemoryException);
+  std::istringstream wrap(SegmentElf(0xffffffff, 0x10, 0));
+  EXPECT_THROW(mem.LoadElf(wrap), MemoryException);
+}
+
+TEST_F(MemoryTest, Watch) {
+  std::vector<std::vector<uint16_t>> accesses;
+  mem.SetWatchHook([&](MemAddr addr, uint16_t old_val, uint16_t val,
+                       bool byte, bool write) {
+    accesses.push_back({addr, old_val, val, byte, write});
+  });
+  mem.Watch(0x0300, 2, false, true);
+  mem.Watch(0x0301, 1, true, false);
+
+  mem.SetUint16BSwap(0x0300, 0x1234);
+  mem.SetUint8(0x0300, 0x56);
+  mem.SetUint8(0x0302, 0x78);
+  EXPECT_EQ(mem.GetUint16(0x0300), 0x1256);
+  EXPECT_EQ(mem.GetUint8(0x0300), 0x56);
+  ASSERT_EQ(accesses.size(), 3);
+  EXPECT_EQ(accesses[0], std::vector<uint16_t>({0x0300, 0, 0x1234, 0, 1}));
+  EXPECT_EQ(accesses[1], std::vector<uint16_t>({0x0300, 0x34, 0x56, 1, 1}));
+  EXPECT_EQ(accesses[2],
+            std::vector<uint16_t>({0x0300, 0x1256, 0x1256, 0, 0}));
+
+  mem.ClearWatches();
+  mem.SetUint16BSwap(0x0300, 0);
+  EXPECT_EQ(mem.GetUint16(0x0300), 0);
+  EXPECT_EQ(accesses.size(), 3);
+}
+
+TEST_F(MemoryTest, Dump) {
+  const uint8_t data[] = "Hello, MSP430!\x01\xff" "ab";
+  mem.WriteBlock(0x0200, data, 18);
+  EXPECT_EQ(mem.Dump(0x0200, 18),
+            "00000200  48 65 6c 6c 6f 2c 20 4d  53 50 34 33 30 21 01 ff"
+            "  |Hello, MSP430!..|\n"
+            "00000210  61 62" + std::string(45, ' ') + "|ab|\n");
+  EXPECT_EQ(mem.Dump(0xfff0, 16).size(), 79);
+  EXPECT_EQ(mem.Dump(0x0200, 0), "");
+  EXPECT_THROW(mem.Dump(0xfff0, 17), MemoryException);
+}
@@ -0,0 +1,87 @@
+#include "snapshot_test.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <fstream>
+
+TEST_F(SnapshotTest, PutGet) {
+  snapshot.Put(static_cast<uint16_t>(0x1234));
+  snapshot.Put(true);
+  snapshot.PutString("G2553");
+  snapshot.Put(std::array<uint32_t, 2>{7, 8});
+  EXPECT_EQ(snapshot.GetSize(), 2u + 1u + 4u + 5u + 8u);
+
+  uint16_t word;
+  bool flag;
+  std::array<uint32_t, 2> values;
+  snapshot.Get(word);
+  snapshot.Get(flag);
+  EXPECT_EQ(snapshot.GetString(), "G2553");
+  snapshot.Get(values);
+  EXPECT_EQ(word, 0x1234);
+  EXPECT_TRUE(flag);
+  EXPECT_EQ(values[1], 8u);
+  EXPECT_THROW(snapshot.Get(word), SnapshotException);
+
+  snapshot.Rewind();
+  snapshot.Get(word);
+  EXPECT_EQ(word, 0x1234);
+
+  snapshot.Clear();
+  EXPECT_EQ(snapshot.GetSize(), 0u);
+  EXPECT_THROW(snapshot.Get(flag), SnapshotException);
+}
+
+TEST_F(SnapshotTest, File) {
+  auto path = testing::TempDir() + "snapshot_test.snap";
+  uint8_t block[300];
+  for (int x = 0; x < 300; x++) {
+    block[x] = x;
+  }
+  snapshot.PutBlock(block, sizeof(block));
+  snapshot.Write(path);
+
+  Snapshot read;
+  read.Read(path);
+  EXPECT_EQ(read.GetSize(), sizeof(block));
+  uint8_t copy[300];
+  read.GetBlock(copy, sizeof(copy));
+  EXPECT_EQ(copy[299], 299 & 0xFF);
+
+  // Bump the version
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(sizeof(Snapshot::MAGIC));
+    uint32_t version = Snapshot::VERSION + 1;
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  }
+  EXPECT_THROW(read.Read(path), SnapshotException);
+
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "not a snapshot";
+  }
+  EXPECT_THROW(read.Read(path), SnapshotException);
+  unlink(path.c_str());
+
+  EXPECT_THROW(read.Read(path), SnapshotException);
+}
+
+TEST_F(SnapshotTest, BadSize) {
+  auto path = testing::TempDir() + "snapshot_test_size.snap";
+  snapshot.Put(static_cast<uint16_t>(0x1234));
+  snapshot.Write(path);
+
+  // Claim more data than the file holds, up to an unallocatable size
+  for (uint64_t size : {uint64_t{3}, uint64_t{1} << 40, UINT64_MAX}) {
+    {
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(sizeof(Snapshot::MAGIC) + sizeof(Snapshot::VERSION));
+      file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    }
+    Snapshot read;
+    EXPECT_THROW(read.Read(path), SnapshotException) << size;
+  }
+  unlink(path.c_str());
+}
@@ -0,0 +1,23 @@
+#ifndef msp430emu_test_h
+#define msp430emu_test_h
+
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "msp430emu.h"
+
+class Msp430EmuTest : public ::testing::Test {
+ public:
+  Msp430EmuTest(){};
+  ~Msp430EmuTest(){};
+
+  void SetUp() { emu = msp430emu_create(); };
+  void TearDown() { msp430emu_destroy(emu); };
+  void LoadProgram(std::vector<uint16_t> words);
+
+  msp430emu* emu;
+  static constexpr uint16_t PROGRAM = 0xF000;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "msp430emu_test.h"
+
+#include <fstream>
+#include <iterator>
+
+/**
+ * @brief Load words at PROGRAM, point the reset vector at them and reset
+ *
+ */
+void Msp430EmuTest::LoadProgram(std::vector<uint16_t> words) {
+  std::vector<uint8_t> bytes;
+  for (auto word : words) {
+    bytes.push_back(word & 0xFF);
+    bytes.push_back(word >> 8);
+  }
+  uint8_t reset[2] = {PROGRAM & 0xFF, PROGRAM >> 8};
+  ASSERT_EQ(msp430emu_load_image(emu, PROGRAM, bytes.data(), bytes.size()),
+            MSP430EMU_OK);
+  ASSERT_EQ(msp430emu_load_image(emu, 0xFFFE, reset, 2), MSP430EMU_OK);
+  ASSERT_EQ(msp430emu_reset(emu), MSP430EMU_OK);
+}
+
+TEST_F(Msp430EmuTest, LoadFile) {
+  ASSERT_EQ(msp430emu_load_file(emu, DOCUMENT_PATH), MSP430EMU_OK);
+  uint16_t regs[MSP430EMU_REGISTERS];
+  ASSERT_EQ(msp430emu_read_registers(emu, regs, MSP430EMU_REGISTERS),
+            MSP430EMU_OK);
+  EXPECT_EQ(regs[0], 0xf842) << "PC not at reset vector";
+
+  EXPECT_EQ(msp430emu_load_file(emu, "/bad"), MSP430EMU_ERROR);
+  EXPECT_STREQ(msp430emu_last_error(emu), "File does not exist");
+}
+
+TEST_F(Msp430EmuTest, LoadElf) {
+  std::ifstream file(DOCUMENT_PATH, std::ios::binary);
+  std::vector<uint8_t> elf((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+  ASSERT_EQ(msp430emu_load_elf(emu, elf.data(), elf.size()), MSP430EMU_OK);
+
+  uint16_t pc;
+  msp430emu_read_registers(emu, &pc, 1);
+  EXPECT_EQ(pc, 0xf842);
+
+  uint8_t text[4];
+  ASSERT_EQ(msp430emu_read_memory(emu, 0xf800, text, 4), MSP430EMU_OK);
+  EXPECT_EQ(text[0], 0x21);
+  EXPECT_EQ(text[1], 0x83);
+}
+
+TEST_F(Msp430EmuTest, Run) {
+  LoadProgram({
+      0x4034, 0x1234,  // MOV #0x1234, R4
+      0x44C2, 0x0200,  // MOV.B R4, &0x0200
+      0x3FFF,          // JMP $
+  });
+
+  ASSERT_EQ(msp430emu_run(emu, 20), MSP430EMU_OK);
+  EXPECT_GE(msp430emu_cycles(emu), 20);
+
+  uint16_t regs[MSP430EMU_REGISTERS];
+  msp430emu_read_registers(emu, regs, MSP430EMU_REGISTERS);
+  EXPECT_EQ(regs[4], 0x1234);
+  EXPECT_EQ(regs[0], PROGRAM + 8);
+
+  uint8_t val;
+  msp430emu_read_memory(emu, 0x0200, &val, 1);
+  EXPECT_EQ(val, 0x34);
+}
+
+TEST_F(Msp430EmuTest, Breakpoint) {
+  LoadProgram({
+      0x4034, 0x1234,  // MOV #0x1234, R4
+      0x5314,          // ADD #1, R4
+      0x3FFE,          // JMP PROGRAM + 4
+  });
+  ASSERT_EQ(msp430emu_set_breakpoint(emu, PROGRAM + 4, 1), MSP430EMU_OK);
+
+  uint16_t regs[MSP430EMU_REGISTERS];
+  for (uint16_t count = 0; count < 3; count++) {
+    ASSERT_EQ(msp430emu_continue(emu, 100), MSP430EMU_BREAKPOINT);
+    msp430emu_read_registers(emu, regs, MSP430EMU_REGISTERS);
+    EXPECT_EQ(regs[0], PROGRAM + 4);
+    EXPECT_EQ(regs[4], 0x1234 + count);
+  }
+
+  ASSERT_EQ(msp430emu_set_breakpoint(emu, PROGRAM + 4, 0), MSP430EMU_OK);
+  EXPECT_EQ(msp430emu_continue(emu, 100), MSP430EMU_OK);
+  msp430emu_read_registers(emu, regs, MSP430EMU_REGISTERS);
+  EXPECT_EQ(regs[4], 0x1234 + 2 + 50);
+}
+
+TEST_F(Msp430EmuTest, Fault) {
+  LoadProgram({0x0000});
+  EXPECT_EQ(msp430emu_run(emu, 20), MSP430EMU_FAULT);
+  EXPECT_STREQ(msp430emu_last_error(emu), "Undefined Opcode");
+}
+
+TEST_F(Msp430EmuTest, Registers) {
+  uint16_t regs[MSP430EMU_REGISTERS];
+  for (uint16_t x = 0; x < MSP430EMU_REGISTERS; x++) {
+    regs[x] = 0x100 + x;
+  }
+  ASSERT_EQ(msp430emu_write_registers(emu, regs, MSP430EMU_REGISTERS),
+            MSP430EMU_OK);
+
+  uint16_t read[MSP430EMU_REGISTERS];
+  ASSERT_EQ(msp430emu_read_registers(emu, read, MSP430EMU_REGISTERS),
+            MSP430EMU_OK);
+  for (uint16_t x = 0; x < MSP430EMU_REGISTERS; x++) {
+    EXPECT_EQ(read[x], 0x100 + x);
+  }
+
+  EXPECT_EQ(msp430emu_read_registers(emu, read, 17), MSP430EMU_ERROR);
+  EXPECT_STREQ(msp430emu_last_error(emu), "register count 17 is out of range");
+  EXPECT_EQ(msp430emu_write_registers(emu, regs, 17), MSP430EMU_ERROR);
+}
+
+TEST_F(Msp430EmuTest, Memory) {
+  std::vector<uint8_t> data(256);
+  for (size_t x = 0; x < data.size(); x++) {
+    data[x] = x;
+  }
+  ASSERT_EQ(msp430emu_write_memory(emu, 0x200, data.data(), data.size()),
+            MSP430EMU_OK);
+
+  std::vector<uint8_t> read(256);
+  ASSERT_EQ(msp430emu_read_memory(emu, 0x200, read.data(), read.size()),
+            MSP430EMU_OK);
+  EXPECT_EQ(read, data);
+
+  EXPECT_EQ(msp430emu_read_memory(emu, 0xFFFF, read.data(), 2),
+            MSP430EMU_ERROR);
+}
+
+TEST_F(Msp430EmuTest, Callbacks) {
+  LoadProgram({
+      0x4034, 0x1234,  // MOV #0x1234, R4
+      0x44C2, 0x0200,  // MOV.B R4, &0x0200
+      0x4255, 0x0202,  // MOV.B &0x0202, R5
+      0x3FFF,          // JMP $
+  });
+
+  std::vector<std::pair<uint16_t, uint8_t>> writes;
+  auto on_write = [](void* user, uint16_t addr, uint8_t val) {
+    static_cast<std::vector<std::pair<uint16_t, uint8_t>>*>(user)->push_back(
+        {addr, val});
+  };
+  auto on_read = [](void*, uint16_t) -> uint8_t { return 0x5A; };
+
+  ASSERT_EQ(msp430emu_set_write_callback(emu, 0x0200, on_write, &writes),
+            MSP430EMU_OK);
+  ASSERT_EQ(msp430emu_set_read_callback(emu, 0x0202, on_read, nullptr),
+            MSP430EMU_OK);
+  msp430emu_run(emu, 20);
+
+  ASSERT_EQ(writes.size(), 1);
+  EXPECT_EQ(writes[0].first, 0x0200);
+  EXPECT_EQ(writes[0].second, 0x34);
+
+  uint16_t regs[MSP430EMU_REGISTERS];
+  msp430emu_read_registers(emu, regs, MSP430EMU_REGISTERS);
+  EXPECT_EQ(regs[5], 0x5A);
+
+  // Removing the callback stops further calls
+  ASSERT_EQ(msp430emu_set_write_callback(emu, 0x0200, nullptr, nullptr),
+            MSP430EMU_OK);
+  msp430emu_reset(emu);
+  msp430emu_run(emu, 20);
+  EXPECT_EQ(writes.size(), 1);
+}
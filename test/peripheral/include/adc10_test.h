@@ -0,0 +1,29 @@
+#ifndef adc10_test_h
+#define adc10_test_h
+
+#include "adc10.h"
+#include "peripheral_fixture.h"
+
+class Adc10Test : public PeripheralFixture<Adc10> {
+ public:
+  // ADC10CTL0/ADC10CTL1 bits
+  static constexpr uint16_t ADC10SC = 0x0001;
+  static constexpr uint16_t ENC = 0x0002;
+  static constexpr uint16_t ADC10IFG = 0x0004;
+  static constexpr uint16_t ADC10IE = 0x0008;
+  static constexpr uint16_t ADC10ON = 0x0010;
+  static constexpr uint16_t MSC = 0x0080;
+  static constexpr uint16_t ADC10BUSY = 0x0001;
+  static constexpr uint16_t CONSEQ_1 = 0x0002;
+  static constexpr uint16_t CONSEQ_2 = 0x0004;
+  static constexpr uint16_t ADC10SSEL_3 = 0x0018;
+  static constexpr uint16_t ADC10DF = 0x0200;
+  static constexpr uint16_t INCH_2 = 0x2000;
+
+  // 4 sample + 13 conversion SMCLK cycles
+  static constexpr uint64_t CONVERSION = 17;
+
+  Adc10& adc{device};
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef flash_test_h
+#define flash_test_h
+
+#include "flash.h"
+#include "peripheral_fixture.h"
+
+class FlashTest : public PeripheralFixture<Flash> {
+ public:
+  void SetUp() {
+    PeripheralFixture::SetUp();
+    flash.SetPuc([this]() {
+      pucs++;
+      clock.Reset();
+      flash.Reset();
+    });
+  };
+
+  void Unlock() { Write(Flash::FCTL3_ADDR, FWKEY); }
+
+  // FCTLx bits
+  static constexpr uint16_t FWKEY = 0xA500;
+  static constexpr uint16_t ERASE = 0x0002;
+  static constexpr uint16_t MERAS = 0x0004;
+  static constexpr uint16_t WRT = 0x0040;
+  static constexpr uint16_t BLKWRT = 0x0080;
+  static constexpr uint16_t BUSY = 0x0001;
+  static constexpr uint16_t KEYV = 0x0002;
+  static constexpr uint16_t ACCVIFG = 0x0004;
+  static constexpr uint16_t WAIT = 0x0008;
+  static constexpr uint16_t LOCK = 0x0010;
+  static constexpr uint16_t EMEX = 0x0020;
+  static constexpr uint16_t LOCKA = 0x0040;
+
+  // MCLK / 3 after reset
+  static constexpr uint64_t DIVIDER = 3;
+
+  Flash& flash{device};
+  int pucs{0};
+};
+
+#endif
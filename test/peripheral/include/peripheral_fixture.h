@@ -0,0 +1,57 @@
+#ifndef peripheral_fixture_h
+#define peripheral_fixture_h
+
+#include <iostream>
+
+#include "clock.h"
+#include "gtest/gtest.h"
+#include "memory.h"
+#include "processor.h"
+
+/**
+ * @brief Fixture for a peripheral T wired to a clock and processor
+ *
+ * Word is the register width Write and Read use.
+ */
+template <typename T, typename Word = uint16_t>
+class PeripheralFixture : public ::testing::Test {
+ public:
+  template <typename... Args>
+  explicit PeripheralFixture(Args... args) : device(&clock, &proc, args...){};
+  ~PeripheralFixture(){};
+
+  void SetUp() {
+    clock.Attach(&mem);
+    clock.SetCycleCounter(&proc.cycles);
+    device.Attach(&mem);
+  };
+  void TearDown(){};
+
+  void Run(uint64_t count) {
+    proc.cycles += count;
+    proc.RunEvents();
+  }
+  void Write(MemAddr addr, Word val) {
+    if constexpr (sizeof(Word) == 1) {
+      mem.SetUint8(addr, val);
+    } else {
+      mem.SetUint16BSwap(addr, val);
+    }
+  }
+  Word Read(MemAddr addr) {
+    if constexpr (sizeof(Word) == 1) {
+      return mem.GetUint8(addr);
+    } else {
+      return mem.GetUint16(addr);
+    }
+  }
+
+  Memory mem;
+  Processor proc;
+  Scheduler& scheduler{proc.scheduler};
+  uint64_t& cycles{proc.cycles};
+  Clock clock;
+  T device;
+};
+
+#endif
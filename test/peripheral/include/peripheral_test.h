@@ -0,0 +1,52 @@
+#ifndef peripheral_test_h
+#define peripheral_test_h
+
+#include <iostream>
+
+#include "clock.h"
+#include "gtest/gtest.h"
+#include "memory.h"
+#include "peripheral.h"
+
+class TestPeripheral : public Peripheral {
+ public:
+  TestPeripheral() {
+    AddRegister({"PLAIN", 0x40, 1, 0x12});
+    AddRegister({"STATUS", 0x42, 1, 0x00, 0x0F, 0x00});
+    AddRegister({"CTL", 0x160, 2, 0x0101, 0xFFFF, 0x00FF, HOOK::READ_WRITE});
+  };
+
+  uint16_t ReadCallback(const RegisterDescriptor& reg, uint16_t val) override {
+    reads++;
+    return val | 0x8000;
+  }
+  void WriteCallback(const RegisterDescriptor& reg, uint16_t old_val,
+                     uint16_t val) override {
+    writes++;
+    last_old = old_val;
+    last_val = val;
+  }
+
+  int reads{0};
+  int writes{0};
+  uint16_t last_old{};
+  uint16_t last_val{};
+};
+
+class PeripheralTest : public ::testing::Test {
+ public:
+  PeripheralTest(){};
+  ~PeripheralTest(){};
+
+  void SetUp() {
+    peripheral.Attach(&mem);
+    clock.Attach(&mem);
+  };
+  void TearDown(){};
+
+  Memory mem;
+  TestPeripheral peripheral;
+  Clock clock;
+};
+
+#endif
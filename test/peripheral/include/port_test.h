@@ -0,0 +1,42 @@
+#ifndef port_test_h
+#define port_test_h
+
+#include <sstream>
+
+#include "peripheral_fixture.h"
+#include "port.h"
+#include "stimulus.h"
+#include "vcd.h"
+
+class PortTest : public PeripheralFixture<Port, uint8_t> {
+ public:
+  PortTest()
+      : PeripheralFixture(Port::P1),
+        p2(&clock, &proc, Port::P2),
+        stimulus(&proc){};
+
+  void SetUp() {
+    PeripheralFixture::SetUp();
+    p2.Attach(&mem);
+    p1.SetOutput(&output);
+    p2.SetOutput(&output);
+    stimulus.AddPort(&p1);
+    stimulus.AddPort(&p2);
+  };
+
+  // P1 registers by offset
+  void Write(uint8_t reg, uint8_t val) {
+    PeripheralFixture::Write(P1IN + reg, val);
+  }
+  uint8_t Read(uint8_t reg) { return PeripheralFixture::Read(P1IN + reg); }
+
+  static constexpr MemAddr P1IN = 0x20;
+  static constexpr MemAddr P2IN = 0x28;
+
+  Port& p1{device};
+  Port p2;
+  Stimulus stimulus;
+  std::ostringstream output;
+};
+
+#endif
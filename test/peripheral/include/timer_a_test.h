@@ -0,0 +1,37 @@
+#ifndef timer_a_test_h
+#define timer_a_test_h
+
+#include "peripheral_fixture.h"
+#include "timer_a.h"
+
+class TimerATest : public PeripheralFixture<TimerA> {
+ public:
+  TimerATest() : PeripheralFixture(TimerA::TIMER0){};
+
+  // Timer0_A3 register addresses and TACTL/TACCTL bits
+  static constexpr MemAddr TACTL = 0x0160;
+  static constexpr MemAddr TACCTL0 = 0x0162;
+  static constexpr MemAddr TACCTL1 = 0x0164;
+  static constexpr MemAddr TAR = 0x0170;
+  static constexpr MemAddr TACCR0 = 0x0172;
+  static constexpr MemAddr TACCR1 = 0x0174;
+  static constexpr MemAddr TAIV = 0x012E;
+  static constexpr uint16_t TASSEL_2 = 0x0200;
+  static constexpr uint16_t ID_3 = 0x00C0;
+  static constexpr uint16_t MC_1 = 0x0010;
+  static constexpr uint16_t MC_2 = 0x0020;
+  static constexpr uint16_t MC_3 = 0x0030;
+  static constexpr uint16_t TACLR = 0x0004;
+  static constexpr uint16_t TAIE = 0x0002;
+  static constexpr uint16_t TAIFG = 0x0001;
+  static constexpr uint16_t CM_1 = 0x4000;
+  static constexpr uint16_t CCIS_2 = 0x2000;
+  static constexpr uint16_t CCIS_3 = 0x3000;
+  static constexpr uint16_t CAP = 0x0100;
+  static constexpr uint16_t CCIE = 0x0010;
+  static constexpr uint16_t CCIFG = 0x0001;
+
+  TimerA& timer{device};
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef uart_test_h
+#define uart_test_h
+
+#include "peripheral_fixture.h"
+#include "uart.h"
+
+class UartTest : public PeripheralFixture<Uart, uint8_t> {
+ public:
+  /**
+   * @brief 9600 baud from the 1 MHz SMCLK, 8N1
+   *
+   */
+  void Configure() {
+    Write(Uart::UCA0CTL1_ADDR, UCSSEL_2 | UCSWRST);
+    Write(Uart::UCA0BR0_ADDR, 104);
+    Write(Uart::UCA0BR1_ADDR, 0);
+    Write(Uart::UCA0MCTL_ADDR, UCBRS_1);
+    Write(Uart::UCA0CTL1_ADDR, UCSSEL_2);
+  }
+
+  // 10 bits of 104 1/8 ticks
+  static constexpr uint64_t FRAME = 1042;
+
+  static constexpr uint8_t UCSSEL_2 = 0x80;
+  static constexpr uint8_t UCSWRST = 0x01;
+  static constexpr uint8_t UCBRS_1 = 0x02;
+
+  Uart& uart{device};
+};
+
+#endif
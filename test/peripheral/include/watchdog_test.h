@@ -0,0 +1,30 @@
+#ifndef watchdog_test_h
+#define watchdog_test_h
+
+#include "peripheral_fixture.h"
+#include "watchdog.h"
+
+class WatchdogTest : public PeripheralFixture<Watchdog> {
+ public:
+  void SetUp() {
+    PeripheralFixture::SetUp();
+    watchdog.SetPuc([this]() {
+      pucs++;
+      clock.Reset();
+      watchdog.Reset();
+    });
+  };
+
+  // WDTCTL bits
+  static constexpr uint16_t WDTPW = 0x5A00;
+  static constexpr uint16_t WDTHOLD = 0x0080;
+  static constexpr uint16_t WDTTMSEL = 0x0010;
+  static constexpr uint16_t WDTCNTCL = 0x0008;
+  static constexpr uint16_t WDTSSEL = 0x0004;
+  static constexpr uint16_t WDTIS_3 = 0x0003;
+
+  Watchdog& watchdog{device};
+  int pucs{0};
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "adc10_test.h"
+
+#include <unistd.h>
+
+#include <fstream>
+
+TEST_F(Adc10Test, Single) {
+  adc.SetInput(0, 0x155);
+  Write(Adc10::ADC10CTL1_ADDR, ADC10SSEL_3);
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | ADC10IE);
+  EXPECT_EQ(adc.GetConversionCycles(0), CONVERSION);
+
+  // Nothing starts without ENC
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | ADC10IE | ADC10SC);
+  EXPECT_EQ(proc.scheduler.GetNext(), Scheduler::NEVER);
+
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | ADC10IE | ENC | ADC10SC);
+  // ADC10SC resets itself
+  EXPECT_EQ(Read(Adc10::ADC10CTL0_ADDR), ADC10ON | ADC10IE | ENC);
+  EXPECT_TRUE(Read(Adc10::ADC10CTL1_ADDR) & ADC10BUSY);
+
+  Run(CONVERSION - 1);
+  EXPECT_FALSE(Read(Adc10::ADC10CTL0_ADDR) & ADC10IFG);
+  Run(1);
+  EXPECT_EQ(Read(Adc10::ADC10MEM_ADDR), 0x155);
+  EXPECT_TRUE(Read(Adc10::ADC10CTL0_ADDR) & ADC10IFG);
+  EXPECT_FALSE(Read(Adc10::ADC10CTL1_ADDR) & ADC10BUSY);
+  EXPECT_EQ(proc.irq.GetHighest(true), InterruptController::ADC10);
+
+  // Servicing the interrupt resets the flag
+  proc.irq.Accept(InterruptController::ADC10);
+  EXPECT_FALSE(Read(Adc10::ADC10CTL0_ADDR) & ADC10IFG);
+  EXPECT_EQ(proc.scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(Adc10Test, DataFormat) {
+  adc.SetInput(0, 0x000);
+  Write(Adc10::ADC10CTL1_ADDR, ADC10SSEL_3 | ADC10DF);
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | ENC | ADC10SC);
+  Run(CONVERSION);
+  EXPECT_EQ(Read(Adc10::ADC10MEM_ADDR), 0x8000);
+}
+
+TEST_F(Adc10Test, Sequence_Dtc) {
+  adc.SetInput(0, 100);
+  adc.SetInput(1, 101);
+  adc.SetInput(2, 102);
+  mem.SetUint8(Adc10::ADC10DTC1_ADDR, 3);
+  Write(Adc10::ADC10SA_ADDR, 0x0300);
+  Write(Adc10::ADC10CTL1_ADDR, INCH_2 | ADC10SSEL_3 | CONSEQ_1);
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | MSC | ENC | ADC10SC);
+
+  Run(2 * CONVERSION);
+  EXPECT_FALSE(Read(Adc10::ADC10CTL0_ADDR) & ADC10IFG);
+  Run(CONVERSION);
+  EXPECT_TRUE(Read(Adc10::ADC10CTL0_ADDR) & ADC10IFG);
+  EXPECT_EQ(Read(0x0300), 102);
+  EXPECT_EQ(Read(0x0302), 101);
+  EXPECT_EQ(Read(0x0304), 100);
+  EXPECT_EQ(proc.scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(Adc10Test, Repeat_TwoBlocks) {
+  adc.SetInput(0, 7);
+  mem.SetUint8(Adc10::ADC10DTC0_ADDR, Adc10::ADC10TB);
+  mem.SetUint8(Adc10::ADC10DTC1_ADDR, 2);
+  Write(Adc10::ADC10SA_ADDR, 0x0300);
+  Write(Adc10::ADC10CTL1_ADDR, ADC10SSEL_3 | CONSEQ_2);
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | MSC | ENC | ADC10SC);
+
+  Run(2 * CONVERSION);
+  EXPECT_TRUE(Read(Adc10::ADC10CTL0_ADDR) & ADC10IFG);
+  EXPECT_TRUE(mem.GetUint8(Adc10::ADC10DTC0_ADDR) & Adc10::ADC10B1);
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | MSC | ENC);
+
+  adc.SetInput(0, 8);
+  Run(2 * CONVERSION);
+  EXPECT_TRUE(Read(Adc10::ADC10CTL0_ADDR) & ADC10IFG);
+  EXPECT_FALSE(mem.GetUint8(Adc10::ADC10DTC0_ADDR) & Adc10::ADC10B1);
+  EXPECT_EQ(Read(0x0302), 7);
+  EXPECT_EQ(Read(0x0304), 8);
+
+  // Clearing ENC lets the current conversion finish
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | MSC);
+  EXPECT_TRUE(Read(Adc10::ADC10CTL1_ADDR) & ADC10BUSY);
+  Run(CONVERSION);
+  EXPECT_FALSE(Read(Adc10::ADC10CTL1_ADDR) & ADC10BUSY);
+  EXPECT_EQ(proc.scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(Adc10Test, Stream) {
+  auto path = testing::TempDir() + "adc10_test.bin";
+  {
+    std::ofstream file(path, std::ios::binary);
+    // 100, 200, 300 at 1 kHz, little endian
+    const char samples[] = {100, 0, static_cast<char>(200), 0, 44, 1};
+    file.write(samples, sizeof(samples));
+  }
+  auto stream = std::make_shared<SampleStream>(path, 1000);
+  EXPECT_EQ(stream->GetCount(), 3);
+  EXPECT_EQ(stream->GetSample(0), 100);
+  EXPECT_EQ(stream->GetSample(999999), 100);
+  EXPECT_EQ(stream->GetSample(1000000), 200);
+  // The last sample is held
+  EXPECT_EQ(stream->GetSample(60000000000), 300);
+
+  adc.SetStream(0, stream);
+  Write(Adc10::ADC10CTL1_ADDR, ADC10SSEL_3);
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | ENC | ADC10SC);
+  Run(CONVERSION);
+  EXPECT_EQ(Read(Adc10::ADC10MEM_ADDR), 100);
+
+  // 2.5 ms in
+  while (clock.GetNanoseconds(proc.cycles) < 2500000) {
+    Run(1000);
+  }
+  Write(Adc10::ADC10CTL0_ADDR, ADC10ON | ENC | ADC10SC);
+  Run(CONVERSION);
+  EXPECT_EQ(Read(Adc10::ADC10MEM_ADDR), 300);
+  unlink(path.c_str());
+}
+
+TEST_F(Adc10Test, Stream_Missing) {
+  EXPECT_THROW(SampleStream("/nonexistent/samples.bin", 1000),
+               PeripheralException);
+}
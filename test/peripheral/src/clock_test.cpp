@@ -34,4 +34,90 @@ TEST_F(ClockTest, GetFrequency) {
 
   auto frequency = (mul * fdco * fdco) / ((mod * fdco) + ((mul - mod) * fdco));
   std::cout << "Frequency: " << frequency << std::endl;
-}
\ No newline at end of file
+}
+
+TEST_F(ClockTest, DCOTable) {
+  // DCOx = 3 column is the datasheet value
+  EXPECT_EQ(dco::TABLE[7 * dco::DCO_STEPS + 3], 1200000);
+  EXPECT_EQ(dco::TABLE[15 * dco::DCO_STEPS + 3], 15250000);
+  EXPECT_EQ(dco::TABLE[7 * dco::DCO_STEPS + 4], 1296000);
+
+  // PUC default is RSEL 7, DCO 3, MOD 0
+  EXPECT_EQ(clock.GetDCO(), 1200000);
+
+  // MODx mixes in f(DCO + 1)
+  clock.DCO.MODx = 16;
+  auto f0 = 1200000.0;
+  auto f1 = 1296000.0;
+  auto expected = (32 * f0 * f1) / (16 * f0 + 16 * f1);
+  EXPECT_EQ(clock.GetDCO(), static_cast<uint32_t>(expected));
+}
+
+TEST_F(ClockTest, ClockTree) {
+  EXPECT_EQ(clock.GetFrequency(CLOCK::MCLK), 1200000);
+  EXPECT_EQ(clock.GetFrequency(CLOCK::SMCLK), 1200000);
+  EXPECT_EQ(clock.GetFrequency(CLOCK::ACLK), Clock::LFXT1_HZ);
+
+  Memory mem;
+  uint64_t cycles = 0;
+  clock.Attach(&mem);
+  clock.SetCycleCounter(&cycles);
+
+  // SMCLK = DCO / 4, ACLK = VLO / 2
+  mem.SetUint8(Clock::BCSCTL2_ADDR, 0x04);
+  mem.SetUint8(Clock::BCSCTL1_ADDR, 0x97);
+  mem.SetUint8(Clock::BCSCTL3_ADDR, 0x20);
+  EXPECT_EQ(clock.GetFrequency(CLOCK::SMCLK), 300000);
+  EXPECT_EQ(clock.GetFrequency(CLOCK::ACLK), Clock::VLO_HZ / 2);
+
+  // MCLK from LFXT1
+  mem.SetUint8(Clock::BCSCTL2_ADDR, 0xC0);
+  EXPECT_EQ(clock.GetFrequency(CLOCK::MCLK), Clock::VLO_HZ);
+}
+
+TEST_F(ClockTest, Ticks) {
+  Memory mem;
+  uint64_t cycles = 0;
+  clock.Attach(&mem);
+  clock.SetCycleCounter(&cycles);
+
+  // SMCLK = MCLK / 8
+  mem.SetUint8(Clock::BCSCTL2_ADDR, 0x06);
+  EXPECT_EQ(clock.GetTicks(CLOCK::SMCLK, 800), 100);
+  EXPECT_EQ(clock.GetCycle(CLOCK::SMCLK, 100), 800);
+  EXPECT_EQ(clock.GetCycle(CLOCK::SMCLK, 101), 808);
+
+  // Switching to / 2 keeps the ticks counted so far
+  cycles = 800;
+  mem.SetUint8(Clock::BCSCTL2_ADDR, 0x02);
+  EXPECT_EQ(clock.GetTicks(CLOCK::SMCLK, 800), 100);
+  EXPECT_EQ(clock.GetTicks(CLOCK::SMCLK, 1000), 200);
+  EXPECT_EQ(clock.GetCycle(CLOCK::SMCLK, 200), 1000);
+
+  // MCLK ticks are CPU cycles
+  EXPECT_EQ(clock.GetTicks(CLOCK::MCLK, 1234), 1234);
+}
+
+TEST_F(ClockTest, Nanoseconds) {
+  Memory mem;
+  uint64_t cycles = 0;
+  clock.Attach(&mem);
+  clock.SetCycleCounter(&cycles);
+
+  // 16 MHz, 62.5 ns per cycle
+  mem.SetUint8(Clock::BCSCTL1_ADDR, 0x8F);
+  mem.SetUint8(Clock::DCOCTL_ADDR, 0x95);
+  auto mhz16 = clock.GetFrequency(CLOCK::MCLK);
+  EXPECT_EQ(clock.GetNanoseconds(mhz16), 1000000000);
+
+  // Slowing down keeps the time so far
+  cycles = mhz16;
+  mem.SetUint8(Clock::BCSCTL2_ADDR, 0x30);
+  auto slow = clock.GetFrequency(CLOCK::MCLK);
+  EXPECT_EQ(clock.GetNanoseconds(mhz16 + slow), 2000000000);
+
+  // A PUC doesn't turn back time
+  cycles = mhz16 + slow;
+  clock.Reset();
+  EXPECT_EQ(clock.GetNanoseconds(cycles), 2000000000);
+}
@@ -0,0 +1,268 @@
+#include "flash_test.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <vector>
+
+TEST_F(FlashTest, ResetState) {
+  EXPECT_EQ(Read(Flash::FCTL1_ADDR), 0x9600);
+  EXPECT_EQ(Read(Flash::FCTL2_ADDR), 0x9642);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9658);
+}
+
+TEST_F(FlashTest, Locked) {
+  Write(0xC000, 0x1234);
+  EXPECT_EQ(Read(0xC000), 0x0000);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9658 | ACCVIFG);
+
+  // Unlocked but neither erasing nor writing
+  Unlock();
+  mem.SetUint8(0xC000, 0x12);
+  EXPECT_EQ(Read(0xC000), 0x0000);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | ACCVIFG);
+}
+
+TEST_F(FlashTest, SegmentErase) {
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0xC210, 0);
+  for (MemAddr addr = 0xC200; addr < 0xC400; addr += 2) {
+    ASSERT_EQ(Read(addr), 0xFFFF);
+  }
+  EXPECT_EQ(Read(0xC1FE), 0x0000);
+  EXPECT_EQ(Read(0xC400), 0x0000);
+
+  // Running from RAM, BUSY until the erase is done
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | BUSY);
+  EXPECT_EQ(scheduler.GetNext(), Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+  Run(Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648);
+  EXPECT_EQ(Read(Flash::FCTL1_ADDR), 0x9600);
+
+  // Information memory has 64 byte segments
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0x1040, 0);
+  Run(Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0x103E), 0x0000);
+  EXPECT_EQ(Read(0x1040), 0xFFFF);
+  EXPECT_EQ(Read(0x107E), 0xFFFF);
+  EXPECT_EQ(Read(0x1080), 0x0000);
+}
+
+TEST_F(FlashTest, HeldFromFlash) {
+  *proc.PC = 0xC100;
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0xE000, 0);
+  EXPECT_EQ(proc.cycles, Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648);
+  EXPECT_EQ(Read(Flash::FCTL1_ADDR), 0x9600);
+
+  Write(Flash::FCTL1_ADDR, FWKEY | WRT);
+  Write(0xE000, 0x1234);
+  mem.SetUint8(0xE003, 0x5A);
+  EXPECT_EQ(Read(0xE000), 0x1234);
+  EXPECT_EQ(Read(0xE002), 0x5AFF);
+  EXPECT_EQ(proc.cycles,
+            (Flash::SEGMENT_ERASE_TICKS + 2 * Flash::WORD_TICKS) * DIVIDER);
+}
+
+TEST_F(FlashTest, Program) {
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0xC000, 0);
+  Run(Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+
+  Write(Flash::FCTL1_ADDR, FWKEY | WRT);
+  Write(0xC000, 0xF0F0);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | BUSY);
+  // Writing while busy is a violation
+  Write(0xC002, 0x0000);
+  EXPECT_EQ(Read(0xC002), 0xFFFF);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | BUSY | ACCVIFG);
+  Run(Flash::WORD_TICKS * DIVIDER);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | ACCVIFG);
+
+  // Programming only clears bits
+  Write(0xC000, 0x3C3C);
+  Run(Flash::WORD_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0xC000), 0x3030);
+}
+
+TEST_F(FlashTest, TimingGenerator) {
+  Unlock();
+  // SMCLK / 20
+  Write(Flash::FCTL2_ADDR, FWKEY | 0x0080 | 19);
+  EXPECT_EQ(Read(Flash::FCTL2_ADDR), 0x9693);
+  Write(Flash::FCTL1_ADDR, FWKEY | WRT);
+  Write(0xC000, 0);
+  EXPECT_EQ(scheduler.GetNext(), Flash::WORD_TICKS * 20);
+
+  // Can't be changed while busy
+  Write(Flash::FCTL2_ADDR, FWKEY | 0x0040);
+  EXPECT_EQ(Read(Flash::FCTL2_ADDR), 0x9693);
+  EXPECT_TRUE(Read(Flash::FCTL3_ADDR) & ACCVIFG);
+}
+
+TEST_F(FlashTest, EmergencyExit) {
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | MERAS);
+  Write(0xC000, 0);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | BUSY);
+  Write(Flash::FCTL3_ADDR, FWKEY | EMEX);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648);
+  EXPECT_EQ(scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(FlashTest, MassErase) {
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | MERAS);
+  Write(0xC000, 0);
+  EXPECT_EQ(scheduler.GetNext(), Flash::MASS_ERASE_TICKS * DIVIDER);
+  Run(Flash::MASS_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0xC000), 0xFFFF);
+  EXPECT_EQ(Read(0xFFFE), 0xFFFF);
+  EXPECT_EQ(Read(0x1000), 0x0000);
+  EXPECT_EQ(Read(Flash::FCTL1_ADDR), 0x9600);
+
+  // Information memory too, but only with LOCKA cleared
+  Write(Flash::FCTL1_ADDR, FWKEY | MERAS | ERASE);
+  Write(0xC000, 0);
+  Run(Flash::MASS_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0x1000), 0x0000);
+
+  Write(Flash::FCTL3_ADDR, FWKEY | LOCKA);
+  Write(Flash::FCTL1_ADDR, FWKEY | MERAS | ERASE);
+  Write(0xC000, 0);
+  Run(Flash::MASS_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0x1000), 0xFFFF);
+  EXPECT_EQ(Read(0x10FE), 0xFFFF);
+}
+
+TEST_F(FlashTest, SegmentA) {
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0x10C0, 0);
+  Run(Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0x10C0), 0x0000);
+
+  // Writing a one toggles LOCKA
+  Write(Flash::FCTL3_ADDR, FWKEY | LOCKA);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9608);
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0x10C0, 0);
+  Run(Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0x10C0), 0xFFFF);
+  EXPECT_EQ(Read(0x10FE), 0xFFFF);
+
+  Write(Flash::FCTL3_ADDR, FWKEY | LOCKA);
+  Write(Flash::FCTL1_ADDR, FWKEY | WRT);
+  Write(0x10C0, 0x1234);
+  Run(Flash::WORD_TICKS * DIVIDER);
+  EXPECT_EQ(Read(0x10C0), 0xFFFF);
+}
+
+TEST_F(FlashTest, BlockWrite) {
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0xC000, 0);
+  Run(Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+
+  Write(Flash::FCTL1_ADDR, FWKEY | BLKWRT | WRT);
+  Write(0xC000, 0x1111);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9640 | BUSY);
+  // WAIT is clear until the word is written
+  Write(0xC002, 0x2222);
+  EXPECT_EQ(Read(0xC002), 0xFFFF);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9640 | BUSY | ACCVIFG);
+  Write(Flash::FCTL3_ADDR, FWKEY);
+
+  Run(Flash::BLOCK_FIRST_TICKS * DIVIDER);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | BUSY);
+  Write(0xC002, 0x2222);
+  EXPECT_EQ(scheduler.GetNext(),
+            proc.cycles + Flash::BLOCK_NEXT_TICKS * DIVIDER);
+  Run(Flash::BLOCK_NEXT_TICKS * DIVIDER);
+
+  // Clearing BLKWRT ends the block
+  Write(Flash::FCTL1_ADDR, FWKEY | WRT);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | BUSY);
+  Run(Flash::BLOCK_END_TICKS * DIVIDER);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648);
+  EXPECT_EQ(Read(0xC000), 0x1111);
+  EXPECT_EQ(Read(0xC002), 0x2222);
+
+  // Filling the 64 byte block ends it as well
+  Write(Flash::FCTL1_ADDR, FWKEY | BLKWRT | WRT);
+  for (MemAddr addr = 0xC040; addr < 0xC080; addr += 2) {
+    Write(addr, addr);
+    Run(Flash::BLOCK_FIRST_TICKS * DIVIDER);
+  }
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648 | BUSY);
+  Run(Flash::BLOCK_END_TICKS * DIVIDER);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9648);
+  EXPECT_EQ(Read(0xC07E), 0xC07E);
+}
+
+TEST_F(FlashTest, Password) {
+  Write(Flash::FCTL1_ADDR, 0x1200 | WRT);
+  EXPECT_EQ(pucs, 0);
+  Run(0);
+  EXPECT_EQ(pucs, 1);
+  EXPECT_EQ(Read(Flash::FCTL1_ADDR), 0x9600);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9658 | KEYV);
+
+  // KEYV is cleared by software
+  Write(Flash::FCTL3_ADDR, FWKEY | LOCK);
+  EXPECT_EQ(Read(Flash::FCTL3_ADDR), 0x9658);
+}
+
+TEST_F(FlashTest, AccessViolationInterrupt) {
+  auto& irq = proc.irq;
+  mem.SetUint8(Flash::IE1_ADDR, Flash::ACCVIE);
+  Write(0xC000, 0);
+  EXPECT_EQ(irq.GetHighest(false), InterruptController::NMI);
+
+  irq.Accept(InterruptController::NMI);
+  EXPECT_EQ(mem.GetUint8(Flash::IE1_ADDR), 0x00);
+  EXPECT_EQ(irq.GetPending(), 0);
+  EXPECT_TRUE(Read(Flash::FCTL3_ADDR) & ACCVIFG);
+}
+
+TEST_F(FlashTest, Backing) {
+  char path[] = "/tmp/flash_test_XXXXXX";
+  auto fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  // A new file is filled from memory
+  mem.WriteRaw(0xFFFE, 0xC000, false);
+  flash.SetBacking(path);
+  Unlock();
+  Write(Flash::FCTL1_ADDR, FWKEY | ERASE);
+  Write(0x1000, 0);
+  Run(Flash::SEGMENT_ERASE_TICKS * DIVIDER);
+  Write(Flash::FCTL1_ADDR, FWKEY | WRT);
+  Write(0x1000, 0xBEEF);
+  Run(Flash::WORD_TICKS * DIVIDER);
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<char> image((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  ASSERT_EQ(image.size(), Memory::MEM_SIZE);
+  EXPECT_EQ(static_cast<uint8_t>(image[0x1000]), 0xEF);
+  EXPECT_EQ(static_cast<uint8_t>(image[0x1001]), 0xBE);
+  EXPECT_EQ(static_cast<uint8_t>(image[0x1002]), 0xFF);
+  EXPECT_EQ(static_cast<uint8_t>(image[0xFFFF]), 0xC0);
+
+  // An existing file is loaded
+  Memory other;
+  Processor other_proc;
+  Flash other_flash(&clock, &other_proc);
+  other_flash.Attach(&other);
+  other_flash.SetBacking(path);
+  EXPECT_EQ(other.GetUint16(0x1000), 0xBEEF);
+  EXPECT_EQ(other.GetUint16(0xFFFE), 0xC000);
+  unlink(path);
+}
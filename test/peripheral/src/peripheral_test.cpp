@@ -0,0 +1,79 @@
+#include "peripheral_test.h"
+
+TEST_F(PeripheralTest, Reset) {
+  EXPECT_EQ(mem.GetUint8(0x40), 0x12);
+  EXPECT_EQ(mem.GetUint8(Clock::DCOCTL_ADDR), 0x60);
+  EXPECT_EQ(mem.GetUint8(Clock::BCSCTL1_ADDR), 0x87);
+
+  mem.SetUint8(0x40, 0x34);
+  peripheral.Reset();
+  EXPECT_EQ(mem.GetUint8(0x40), 0x12);
+  EXPECT_EQ(peripheral.writes, 0);
+}
+
+TEST_F(PeripheralTest, Plain) {
+  mem.SetUint8(0x40, 0xAB);
+  EXPECT_EQ(mem.GetUint8(0x40), 0xAB);
+  EXPECT_EQ(peripheral.reads, 0);
+  EXPECT_EQ(peripheral.writes, 0);
+}
+
+TEST_F(PeripheralTest, Masks) {
+  // Read only, only the low nibble reads back
+  mem.WriteRaw(0x42, 0xFF, true);
+  mem.SetUint8(0x42, 0x00);
+  EXPECT_EQ(mem.ReadRaw(0x42, true), 0xFF);
+  EXPECT_EQ(mem.GetUint8(0x42), 0x0F);
+}
+
+TEST_F(PeripheralTest, Word) {
+  // Word register, stored values are pre swapped like the processor's
+  EXPECT_EQ(mem.GetUint16(0x160), 0x8101);
+  EXPECT_EQ(peripheral.reads, 1);
+
+  mem.SetUint16BSwap(0x160, 0xFFAA);
+  EXPECT_EQ(peripheral.writes, 1);
+  EXPECT_EQ(peripheral.last_old, 0x0101);
+  EXPECT_EQ(peripheral.last_val, 0x01AA);
+  EXPECT_EQ(mem.ReadRaw(0x160, false), 0x01AA);
+
+  // Byte access to the high byte
+  EXPECT_EQ(mem.GetUint8(0x161), 0x81);
+  mem.SetUint8(0x160, 0x55);
+  EXPECT_EQ(peripheral.writes, 2);
+  EXPECT_EQ(peripheral.last_val, 0x0155);
+}
+
+TEST_F(PeripheralTest, Hooks) {
+  // User hooks still see writes to peripheral registers
+  int hooked = 0;
+  mem.SetWriteHook(0x160, [&hooked](MemAddr, uint8_t) { hooked++; });
+  mem.SetUint16BSwap(0x160, 0x0011);
+  EXPECT_EQ(hooked, 1);
+  EXPECT_EQ(peripheral.writes, 1);
+
+  // Removing it leaves the peripheral mapped
+  mem.SetWriteHook(0x160, nullptr);
+  mem.SetUint8(0x160, 0x22);
+  EXPECT_EQ(hooked, 1);
+  EXPECT_EQ(peripheral.writes, 2);
+}
+
+TEST_F(PeripheralTest, Clock) {
+  mem.SetUint8(Clock::DCOCTL_ADDR, 0xB0);
+  mem.SetUint8(Clock::BCSCTL1_ADDR, 0x86);
+  EXPECT_EQ(clock.DCO.DCOx, 5);
+  EXPECT_EQ(clock.DCO.MODx, 16);
+  EXPECT_EQ(clock.BCSCTL1.RSELx, 6);
+
+  clock.Reset();
+  EXPECT_EQ(clock.DCO.val, 0x60);
+  EXPECT_EQ(mem.GetUint8(Clock::DCOCTL_ADDR), 0x60);
+}
+
+TEST_F(PeripheralTest, MapIo_Invalid) {
+  EXPECT_THROW(mem.MapIo(0x1FF, 2, &peripheral, 0, true, true),
+               MemoryException);
+  EXPECT_THROW(mem.MapIo(0x200, 1, &peripheral, 0, true, true),
+               MemoryException);
+}
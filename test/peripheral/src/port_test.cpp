@@ -0,0 +1,137 @@
+#include "port_test.h"
+
+#include <unistd.h>
+
+#include <fstream>
+
+TEST_F(PortTest, Output) {
+  Write(Port::IN, 0xFF);
+  EXPECT_EQ(Read(Port::IN), 0x00);
+
+  Write(Port::OUT, 0x41);
+  EXPECT_EQ(output.str(), "P1OUT: 0x41\n");
+  EXPECT_EQ(Read(Port::OUT), 0x41);
+
+  // Only pins set as outputs are driven
+  EXPECT_EQ(Read(Port::IN), 0x00);
+  Write(Port::DIR, 0x01);
+  EXPECT_EQ(Read(Port::IN), 0x01);
+  EXPECT_EQ(p1.GetPins(), 0x01);
+}
+
+TEST_F(PortTest, Input) {
+  p1.SetInput(3, true);
+  EXPECT_EQ(Read(Port::IN), 0x08);
+
+  // The port wins once the pin is an output
+  Write(Port::DIR, 0x08);
+  EXPECT_EQ(Read(Port::IN), 0x00);
+  Write(Port::DIR, 0x00);
+  EXPECT_EQ(Read(Port::IN), 0x08);
+}
+
+TEST_F(PortTest, PullResistor) {
+  Write(Port::OUT, 0x10);
+  Write(Port::REN, 0x10);
+  EXPECT_EQ(Read(Port::IN), 0x10);
+
+  // Driving the pin overrides the pull-up
+  p1.SetInput(4, false);
+  EXPECT_EQ(Read(Port::IN), 0x00);
+}
+
+TEST_F(PortTest, EdgeInterrupt) {
+  Write(Port::IE, 0x08);
+  EXPECT_EQ(proc.irq.GetHighest(true), -1);
+
+  p1.SetInput(3, true);
+  EXPECT_EQ(Read(Port::IFG), 0x08);
+  EXPECT_EQ(proc.irq.GetHighest(true), InterruptController::PORT1);
+
+  // Flags stay set until software clears them
+  Write(Port::IFG, 0x00);
+  EXPECT_EQ(proc.irq.GetHighest(true), -1);
+
+  // Rising edges only, then falling edges only
+  p1.SetInput(3, false);
+  EXPECT_EQ(Read(Port::IFG), 0x00);
+  Write(Port::IES, 0x08);
+  p1.SetInput(3, true);
+  EXPECT_EQ(Read(Port::IFG), 0x00);
+  p1.SetInput(3, false);
+  EXPECT_EQ(Read(Port::IFG), 0x08);
+}
+
+TEST_F(PortTest, Port2) {
+  mem.SetUint8(P2IN + Port::IE, 0x01);
+  p2.SetInput(0, true);
+  EXPECT_EQ(mem.GetUint8(P2IN), 0x01);
+  EXPECT_EQ(mem.GetUint8(P2IN + Port::IFG), 0x01);
+  EXPECT_EQ(proc.irq.GetHighest(true), InterruptController::PORT2);
+
+  mem.SetUint8(P2IN + Port::OUT, 0x02);
+  EXPECT_EQ(output.str(), "P2OUT: 0x2\n");
+}
+
+TEST_F(PortTest, Stimulus) {
+  std::istringstream input(
+      "# button presses\n"
+      "100 P1.0 1\n"
+      "\n"
+      "50 P1.1 1\n"
+      "0x100 P2.7 1\n"
+      "200 P1.0 0\n");
+  stimulus.Load(input);
+  EXPECT_EQ(stimulus.GetRemaining(), 4);
+  EXPECT_EQ(proc.scheduler.GetNext(), 50);
+
+  Run(50);
+  EXPECT_EQ(Read(Port::IN), 0x02);
+  Run(50);
+  EXPECT_EQ(Read(Port::IN), 0x03);
+  Run(100);
+  EXPECT_EQ(Read(Port::IN), 0x02);
+  Run(56);
+  EXPECT_EQ(mem.GetUint8(P2IN), 0x80);
+  EXPECT_EQ(stimulus.GetRemaining(), 0);
+  EXPECT_EQ(proc.scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(PortTest, Stimulus_Invalid) {
+  std::istringstream pin("10 P1.8 1\n");
+  EXPECT_THROW(stimulus.Load(pin), PeripheralException);
+  std::istringstream port("10 P3.0 1\n");
+  EXPECT_THROW(stimulus.Load(port), PeripheralException);
+  std::istringstream level("10 P1.0 2\n");
+  EXPECT_THROW(stimulus.Load(level), PeripheralException);
+  std::istringstream time("soon P1.0 1\n");
+  EXPECT_THROW(stimulus.Load(time), PeripheralException);
+}
+
+TEST_F(PortTest, Vcd) {
+  auto path = testing::TempDir() + "port_test.vcd";
+  VcdWriter vcd;
+  vcd.Open(path);
+  p1.SetTrace(&vcd);
+
+  Write(Port::DIR, 0x01);
+  Write(Port::OUT, 0x01);
+  Run(1000);
+  auto time = clock.GetNanoseconds(proc.cycles);
+  Write(Port::OUT, 0x00);
+  // No change on the pins, nothing recorded
+  Write(Port::OUT, 0x00);
+  vcd.Close();
+
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  auto text = contents.str();
+  EXPECT_NE(text.find("$var wire 1 ! P1.0 $end"), std::string::npos);
+  EXPECT_NE(text.find("$var wire 1 ( P1.7 $end"), std::string::npos);
+  EXPECT_NE(text.find("$dumpvars\n0!\n"), std::string::npos);
+  EXPECT_NE(text.find("$end\n1!\n#" + std::to_string(time) + "\n0!\n"),
+            std::string::npos);
+  EXPECT_EQ(text.substr(text.size() - 3), "0!\n");
+  unlink(path.c_str());
+}
@@ -0,0 +1,142 @@
+#include "timer_a_test.h"
+
+TEST_F(TimerATest, Stopped) {
+  Run(1000);
+  EXPECT_EQ(Read(TAR), 0);
+  EXPECT_EQ(scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(TimerATest, Continuous) {
+  // SMCLK runs at MCLK after PUC, one count per cycle
+  Write(TACTL, TASSEL_2 | MC_2);
+  Run(100);
+  EXPECT_EQ(Read(TAR), 100);
+
+  // Next event is the overflow
+  EXPECT_EQ(scheduler.GetNext(), 0x10000);
+  Run(0x10000 - 100);
+  EXPECT_EQ(Read(TAR), 0);
+  EXPECT_TRUE(Read(TACTL) & TAIFG);
+
+  // Nothing left to schedule with the flags set
+  EXPECT_EQ(scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(TimerATest, Compare) {
+  Write(TACCR1, 500);
+  Write(TACTL, TASSEL_2 | MC_2);
+  Run(499);
+  EXPECT_FALSE(Read(TACCTL1) & CCIFG);
+  Run(1);
+  EXPECT_TRUE(Read(TACCTL1) & CCIFG);
+
+  // Clearing the flag schedules the next match a full period later
+  Write(TACCTL1, 0);
+  EXPECT_FALSE(Read(TACCTL1) & CCIFG);
+  Run(0x10000);
+  EXPECT_TRUE(Read(TACCTL1) & CCIFG);
+}
+
+TEST_F(TimerATest, Compare_MidInstruction) {
+  // Due events are applied when the flags are read, before the scheduler
+  // gets to run
+  Write(TACCR1, 10);
+  Write(TACTL, TASSEL_2 | MC_2);
+  cycles += 20;
+  EXPECT_TRUE(Read(TACCTL1) & CCIFG);
+  EXPECT_EQ(Read(TAR), 20);
+}
+
+TEST_F(TimerATest, Up) {
+  Write(TACCR0, 99);
+  Write(TACTL, TASSEL_2 | MC_1);
+  Run(250);
+  EXPECT_EQ(Read(TAR), 50);
+  EXPECT_TRUE(Read(TACCTL0) & CCIFG);
+  EXPECT_TRUE(Read(TACTL) & TAIFG);
+}
+
+TEST_F(TimerATest, UpDown) {
+  Write(TACCR0, 100);
+  Write(TACTL, TASSEL_2 | MC_3);
+  Run(150);
+  EXPECT_EQ(Read(TAR), 50);
+  EXPECT_TRUE(Read(TACCTL0) & CCIFG);
+  EXPECT_FALSE(Read(TACTL) & TAIFG);
+
+  Run(50);
+  EXPECT_EQ(Read(TAR), 0);
+  EXPECT_TRUE(Read(TACTL) & TAIFG);
+
+  Run(30);
+  EXPECT_EQ(Read(TAR), 30);
+}
+
+TEST_F(TimerATest, Divider) {
+  Write(TACTL, TASSEL_2 | MC_2 | ID_3);
+  Run(80);
+  EXPECT_EQ(Read(TAR), 10);
+
+  // SMCLK / 2 from here on, the counts so far are kept
+  mem.SetUint8(Clock::BCSCTL2_ADDR, 0x02);
+  Run(160);
+  EXPECT_EQ(Read(TAR), 20);
+}
+
+TEST_F(TimerATest, Clear) {
+  Write(TACTL, TASSEL_2 | MC_2);
+  Run(100);
+  Write(TACTL, TASSEL_2 | MC_2 | TACLR);
+  EXPECT_EQ(Read(TAR), 0);
+  EXPECT_FALSE(Read(TACTL) & TACLR);
+  Run(5);
+  EXPECT_EQ(Read(TAR), 5);
+
+  Write(TAR, 0x1000);
+  Run(5);
+  EXPECT_EQ(Read(TAR), 0x1005);
+}
+
+TEST_F(TimerATest, Vector) {
+  Write(TACCR1, 10);
+  Write(TACCTL1, CCIE);
+  Write(TACTL, TASSEL_2 | MC_2 | TAIE);
+  Run(0x10000);
+  EXPECT_EQ(Read(TAIV), TimerA::IV_CCR1);
+  EXPECT_EQ(Read(TAIV), TimerA::IV_TAIFG);
+  EXPECT_EQ(Read(TAIV), TimerA::IV_NONE);
+  EXPECT_FALSE(Read(TACCTL1) & CCIFG);
+  EXPECT_FALSE(Read(TACTL) & TAIFG);
+}
+
+TEST_F(TimerATest, Capture) {
+  Write(TACCTL1, CAP | CM_1 | CCIS_2);
+  Write(TACTL, TASSEL_2 | MC_2);
+  Run(30);
+
+  // Rising edge from GND to VCC captures TAR
+  Write(TACCTL1, CAP | CM_1 | CCIS_3);
+  EXPECT_EQ(Read(TACCR1), 30);
+  EXPECT_TRUE(Read(TACCTL1) & CCIFG);
+}
+
+TEST_F(TimerATest, Interrupts) {
+  auto& irq = proc.irq;
+  Write(TACCR0, 99);
+  Write(TACCTL0, CCIE);
+  Write(TACCR1, 50);
+  Write(TACCTL1, CCIE);
+  Write(TACTL, TASSEL_2 | MC_1);
+
+  Run(50);
+  EXPECT_EQ(irq.GetHighest(true), InterruptController::TIMER0_A1);
+  Run(49);
+  EXPECT_EQ(irq.GetHighest(true), InterruptController::TIMER0_A0);
+
+  // Servicing TACCR0 resets its flag, the shared vector needs TAIV
+  irq.Accept(InterruptController::TIMER0_A0);
+  EXPECT_FALSE(Read(TACCTL0) & CCIFG);
+  EXPECT_EQ(irq.GetHighest(true), InterruptController::TIMER0_A1);
+  EXPECT_EQ(Read(TAIV), TimerA::IV_CCR1);
+  EXPECT_EQ(irq.GetHighest(true), -1);
+}
@@ -0,0 +1,98 @@
+#include "uart_test.h"
+
+TEST_F(UartTest, ResetState) {
+  EXPECT_EQ(Read(Uart::UCA0CTL1_ADDR), UCSWRST);
+  EXPECT_TRUE(Read(Uart::IFG2_ADDR) & Uart::UCA0TXIFG);
+  EXPECT_EQ(proc.scheduler.GetNext(), Scheduler::NEVER);
+}
+
+TEST_F(UartTest, FrameTicks) {
+  Configure();
+  EXPECT_EQ(uart.GetFrameTicks(), FRAME);
+
+  // Oversampling, 8E2
+  Write(Uart::UCA0CTL0_ADDR, 0xC8);
+  Write(Uart::UCA0BR0_ADDR, 6);
+  Write(Uart::UCA0MCTL_ADDR, 0x81);
+  EXPECT_EQ(uart.GetFrameTicks(), 12 * (16 * 6 + 8));
+}
+
+TEST_F(UartTest, Transmit) {
+  Configure();
+  auto& tx = uart.GetTxBuffer();
+  uint8_t val;
+
+  // The first byte goes straight to the shift register
+  Write(Uart::UCA0TXBUF_ADDR, 'H');
+  EXPECT_TRUE(Read(Uart::IFG2_ADDR) & Uart::UCA0TXIFG);
+  EXPECT_TRUE(Read(Uart::UCA0STAT_ADDR) & Uart::UCBUSY);
+  Write(Uart::UCA0TXBUF_ADDR, 'i');
+  EXPECT_FALSE(Read(Uart::IFG2_ADDR) & Uart::UCA0TXIFG);
+
+  Run(FRAME - 1);
+  EXPECT_TRUE(tx.Empty());
+  Run(1);
+  ASSERT_TRUE(tx.Pop(val));
+  EXPECT_EQ(val, 'H');
+  EXPECT_TRUE(Read(Uart::IFG2_ADDR) & Uart::UCA0TXIFG);
+
+  Run(FRAME);
+  ASSERT_TRUE(tx.Pop(val));
+  EXPECT_EQ(val, 'i');
+  EXPECT_FALSE(Read(Uart::UCA0STAT_ADDR) & Uart::UCBUSY);
+}
+
+TEST_F(UartTest, Receive) {
+  uart.GetRxBuffer().Push('A');
+  Configure();
+  Write(Uart::IE2_ADDR, Uart::UCA0RXIE);
+  EXPECT_EQ(proc.irq.GetHighest(true), -1);
+
+  Run(FRAME);
+  EXPECT_TRUE(Read(Uart::IFG2_ADDR) & Uart::UCA0RXIFG);
+  EXPECT_EQ(proc.irq.GetHighest(true), InterruptController::USCI_RX);
+
+  // Reading UCA0RXBUF resets the flag
+  EXPECT_EQ(Read(Uart::UCA0RXBUF_ADDR), 'A');
+  EXPECT_FALSE(Read(Uart::IFG2_ADDR) & Uart::UCA0RXIFG);
+  EXPECT_EQ(proc.irq.GetHighest(true), -1);
+}
+
+TEST_F(UartTest, Overrun) {
+  uart.GetRxBuffer().Push('A');
+  uart.GetRxBuffer().Push('B');
+  Configure();
+  Run(FRAME);
+  EXPECT_FALSE(Read(Uart::UCA0STAT_ADDR) & Uart::UCOE);
+  Run(FRAME);
+  EXPECT_TRUE(Read(Uart::UCA0STAT_ADDR) & Uart::UCOE);
+  EXPECT_EQ(Read(Uart::UCA0RXBUF_ADDR), 'B');
+  EXPECT_FALSE(Read(Uart::UCA0STAT_ADDR) & Uart::UCOE);
+}
+
+TEST_F(UartTest, Listen) {
+  Configure();
+  Write(Uart::UCA0STAT_ADDR, Uart::UCLISTEN);
+  Write(Uart::UCA0TXBUF_ADDR, 0x55);
+  Run(FRAME);
+  EXPECT_TRUE(Read(Uart::IFG2_ADDR) & Uart::UCA0RXIFG);
+  EXPECT_EQ(Read(Uart::UCA0RXBUF_ADDR), 0x55);
+}
+
+TEST_F(UartTest, TransmitInterrupt) {
+  Configure();
+  Write(Uart::IE2_ADDR, Uart::UCA0TXIE);
+  EXPECT_EQ(proc.irq.GetHighest(true), InterruptController::USCI_TX);
+
+  // Setting UCSWRST disables the interrupts
+  Write(Uart::UCA0CTL1_ADDR, UCSSEL_2 | UCSWRST);
+  EXPECT_EQ(Read(Uart::IE2_ADDR), 0);
+  EXPECT_EQ(proc.irq.GetHighest(true), -1);
+}
+
+TEST_F(UartTest, Held) {
+  // Nothing happens while UCSWRST is set
+  Write(Uart::UCA0TXBUF_ADDR, 'x');
+  Run(100000);
+  EXPECT_TRUE(uart.GetTxBuffer().Empty());
+}
@@ -0,0 +1,98 @@
+#include "watchdog_test.h"
+
+TEST_F(WatchdogTest, ResetState) {
+  EXPECT_EQ(Read(Watchdog::WDTCTL_ADDR), 0x6900);
+  // Watchdog mode, SMCLK / 32768
+  EXPECT_EQ(scheduler.GetNext(), 32768);
+}
+
+TEST_F(WatchdogTest, Hold) {
+  Write(Watchdog::WDTCTL_ADDR, WDTPW | WDTHOLD);
+  EXPECT_EQ(Read(Watchdog::WDTCTL_ADDR), 0x6980);
+  EXPECT_EQ(scheduler.GetNext(), Scheduler::NEVER);
+
+  Run(100000);
+  EXPECT_EQ(pucs, 0);
+  EXPECT_EQ(watchdog.GetCount(), 0);
+}
+
+TEST_F(WatchdogTest, Expiry) {
+  Run(32767);
+  EXPECT_EQ(pucs, 0);
+  EXPECT_EQ(watchdog.GetCount(), 32767);
+  Run(1);
+  EXPECT_EQ(pucs, 1);
+  EXPECT_TRUE(mem.GetUint8(Watchdog::IFG1_ADDR) & Watchdog::WDTIFG);
+
+  // Counting again from the PUC
+  EXPECT_EQ(scheduler.GetNext(), 32768 * 2);
+}
+
+TEST_F(WatchdogTest, CounterClear) {
+  Run(30000);
+  Write(Watchdog::WDTCTL_ADDR, WDTPW | WDTCNTCL);
+  EXPECT_EQ(watchdog.GetCount(), 0);
+  // WDTCNTCL always reads back as zero
+  EXPECT_EQ(Read(Watchdog::WDTCTL_ADDR), 0x6900);
+  Run(30000);
+  EXPECT_EQ(pucs, 0);
+  Run(2768);
+  EXPECT_EQ(pucs, 1);
+}
+
+TEST_F(WatchdogTest, Password) {
+  Write(Watchdog::WDTCTL_ADDR, 0x1200 | WDTHOLD);
+  // The PUC waits for the end of the instruction
+  EXPECT_EQ(pucs, 0);
+  Run(0);
+  EXPECT_EQ(pucs, 1);
+  EXPECT_EQ(Read(Watchdog::WDTCTL_ADDR), 0x6900);
+  EXPECT_TRUE(mem.GetUint8(Watchdog::IFG1_ADDR) & Watchdog::WDTIFG);
+
+  // A byte write can't carry the password
+  mem.SetUint8(Watchdog::WDTCTL_ADDR, 0x80);
+  Run(0);
+  EXPECT_EQ(pucs, 2);
+}
+
+TEST_F(WatchdogTest, Interval) {
+  auto& irq = proc.irq;
+  Write(Watchdog::WDTCTL_ADDR, WDTPW | WDTTMSEL | WDTCNTCL | WDTIS_3);
+  mem.SetUint8(Watchdog::IE1_ADDR, Watchdog::WDTIE);
+  Run(63);
+  EXPECT_EQ(irq.GetHighest(true), -1);
+  Run(1);
+  EXPECT_EQ(pucs, 0);
+  EXPECT_TRUE(mem.GetUint8(Watchdog::IFG1_ADDR) & Watchdog::WDTIFG);
+  EXPECT_EQ(irq.GetHighest(true), InterruptController::WDT);
+
+  // Servicing the interrupt resets the flag
+  irq.Accept(InterruptController::WDT);
+  EXPECT_FALSE(mem.GetUint8(Watchdog::IFG1_ADDR) & Watchdog::WDTIFG);
+  EXPECT_EQ(irq.GetHighest(true), -1);
+
+  // Free running, the next interval follows straight on
+  EXPECT_EQ(scheduler.GetNext(), 128);
+  Run(64);
+  EXPECT_EQ(irq.GetHighest(true), InterruptController::WDT);
+}
+
+TEST_F(WatchdogTest, Interval_ACLK) {
+  Write(Watchdog::WDTCTL_ADDR,
+        WDTPW | WDTTMSEL | WDTCNTCL | WDTSSEL | WDTIS_3);
+  auto expiry = clock.GetCycle(CLOCK::ACLK, 64);
+  EXPECT_EQ(scheduler.GetNext(), expiry);
+  Run(expiry - 1);
+  EXPECT_FALSE(mem.GetUint8(Watchdog::IFG1_ADDR) & Watchdog::WDTIFG);
+  Run(1);
+  EXPECT_TRUE(mem.GetUint8(Watchdog::IFG1_ADDR) & Watchdog::WDTIFG);
+}
+
+TEST_F(WatchdogTest, Listener) {
+  int calls = 0;
+  watchdog.AddListener([&]() { calls++; });
+  mem.SetUint8(Watchdog::IE1_ADDR, 0x20);
+  EXPECT_EQ(calls, 1);
+  Write(Watchdog::WDTCTL_ADDR, WDTPW | WDTHOLD);
+  EXPECT_EQ(calls, 1);
+}
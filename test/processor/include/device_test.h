@@ -0,0 +1,23 @@
+#ifndef device_test_h
+#define device_test_h
+
+#include <iostream>
+
+#include "device.h"
+#include "gtest/gtest.h"
+#include "memory.h"
+#include "processor.h"
+
+class DeviceTest : public ::testing::Test {
+ public:
+  DeviceTest() : proc(Device::G2231){};
+  ~DeviceTest(){};
+
+  void SetUp() { proc.SetMemory(&mem); };
+  void TearDown(){};
+
+  Memory mem;
+  Processor proc;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef history_test_h
+#define history_test_h
+
+#include "gtest/gtest.h"
+#include "history.h"
+#include "memory.h"
+#include "processor.h"
+
+class HistoryTest : public ::testing::Test {
+ public:
+  HistoryTest() : proc(Device::G2553){};
+  ~HistoryTest(){};
+
+  void SetUp() { proc.SetMemory(&mem); };
+  void TearDown(){};
+
+  History history;
+  Memory mem;
+  Processor proc;
+};
+
+#endif
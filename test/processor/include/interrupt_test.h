@@ -0,0 +1,28 @@
+#ifndef interrupt_test_h
+#define interrupt_test_h
+
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "interrupt.h"
+#include "memory.h"
+#include "processor.h"
+
+class InterruptTest : public ::testing::Test {
+ public:
+  InterruptTest(){};
+  ~InterruptTest(){};
+
+  void SetUp();
+  void TearDown(){};
+  void Load(MemAddr addr, std::vector<uint16_t> words);
+
+  static constexpr MemAddr MAIN = 0xF000;
+  static constexpr MemAddr ISR = 0xF100;
+  static constexpr MemAddr STACK = 0x0400;
+
+  Memory mem;
+  Processor proc;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#include "device_test.h"
+
+// The memory maps are constant expressions
+static_assert(Device::G2553.IsRam(0x03FF) && !Device::G2553.IsRam(0x0400));
+static_assert(Device::G2231.IsFlash(0xF800) && !Device::G2231.IsFlash(0xF7FE));
+static_assert(Device::G2452.IsFlash(0x10FF) && !Device::G2452.IsFlash(0x1100));
+static_assert(!Device::G2231.Has(Device::USCI) &&
+              Device::G2553.Has(Device::TIMER1 | Device::USCI));
+
+TEST_F(DeviceTest, Find) {
+  EXPECT_EQ(Device::Find("G2553"), &Device::G2553);
+  EXPECT_EQ(Device::Find("MSP430G2452"), &Device::G2452);
+  EXPECT_EQ(Device::Find("G2231"), &Device::G2231);
+  EXPECT_EQ(Device::Find("G2955"), nullptr);
+}
+
+TEST_F(DeviceTest, Fetch) {
+  // jmp $
+  mem.SetUint16BSwap(0x0200, 0x3FFF);
+  mem.SetUint16BSwap(0xF800, 0x3FFF);
+  EXPECT_EQ(proc.FetchInstruction(0x0200), 0x3FFF);
+  EXPECT_EQ(proc.FetchInstruction(0xF800), 0x3FFF);
+
+  // Past the end of RAM and below the start of flash on a G2231
+  EXPECT_THROW(proc.FetchInstruction(0x0280), ProcessorException);
+  EXPECT_THROW(proc.FetchInstruction(0xC000), ProcessorException);
+  EXPECT_THROW(proc.FetchInstruction(0x0100), ProcessorException);
+}
+
+TEST_F(DeviceTest, Vectors) {
+  // A G2231 has no USCI or Timer1
+  proc.irq.Set(InterruptController::USCI_RX, true);
+  proc.irq.Set(InterruptController::TIMER1_A0, true);
+  EXPECT_EQ(proc.irq.GetPending(), 0);
+
+  proc.irq.Set(InterruptController::USI, true);
+  EXPECT_EQ(proc.irq.GetHighest(true), InterruptController::USI);
+}
@@ -0,0 +1,47 @@
+#include "history_test.h"
+
+TEST_F(HistoryTest, Wrap) {
+  EXPECT_EQ(history.GetSize(), 0);
+  for (uint16_t x = 0; x < History::SIZE + 10; x++) {
+    history.Add(x, 2 * x, 0x4303, 0x280, 0);
+  }
+  EXPECT_EQ(history.GetCount(), History::SIZE + 10);
+  ASSERT_EQ(history.GetSize(), History::SIZE);
+  EXPECT_EQ(history.Get(0).cycles, 10);
+  EXPECT_EQ(history.Get(History::SIZE - 1).pc, 2 * (History::SIZE + 9));
+
+  history.Clear();
+  EXPECT_EQ(history.GetSize(), 0);
+}
+
+TEST_F(HistoryTest, Mnemonic) {
+  EXPECT_EQ(History::Mnemonic(0x4031), "mov");
+  EXPECT_EQ(History::Mnemonic(0x5354), "add.b");
+  EXPECT_EQ(History::Mnemonic(0xF0B2), "and");
+  EXPECT_EQ(History::Mnemonic(0x1284), "call");
+  EXPECT_EQ(History::Mnemonic(0x1300), "reti");
+  EXPECT_EQ(History::Mnemonic(0x1244), "push.b");
+  EXPECT_EQ(History::Mnemonic(0x10C4), "swpb");
+  EXPECT_EQ(History::Mnemonic(0x3FFF), "jmp");
+  EXPECT_EQ(History::Mnemonic(0x2400), "jeq");
+  EXPECT_EQ(History::Mnemonic(0x1380), "???");
+  EXPECT_EQ(History::Mnemonic(0x0000), "???");
+}
+
+TEST_F(HistoryTest, Fault) {
+  // inc r4, then branch into the peripherals
+  const uint8_t program[] = {0x14, 0x53, 0x30, 0x40, 0x00, 0x01};
+  mem.LoadImage(0x200, program, sizeof(program));
+  *proc.PC = 0x200;
+  proc.Step();
+  proc.Step();
+  EXPECT_THROW(proc.Step(), ProcessorException);
+
+  auto& history = proc.history;
+  ASSERT_EQ(history.GetSize(), 2);
+  EXPECT_EQ(history.Get(0).pc, 0x200);
+  EXPECT_EQ(history.Get(0).opcode, 0x5314);
+  EXPECT_EQ(history.Get(1).pc, 0x202);
+  EXPECT_EQ(History::Mnemonic(history.Get(1).opcode), "mov");
+  EXPECT_EQ(history.Get(1).cycles, history.Get(0).cycles + 1);
+}
@@ -0,0 +1,140 @@
+#include "interrupt_test.h"
+
+void InterruptTest::SetUp() {
+  // bis #GIE, SR; jmp $
+  Load(MAIN, {0xD232, 0x3FFF});
+  // bis #GIE+CPUOFF, SR
+  Load(MAIN + 0x10, {0xD032, 0x0018});
+  // reti
+  Load(ISR, {0x1300});
+
+  Load(Processor::RESET_VECTOR, {MAIN});
+  Load(InterruptController::GetVectorAddress(InterruptController::TIMER0_A0),
+       {ISR});
+  Load(InterruptController::GetVectorAddress(InterruptController::NMI), {ISR});
+
+  proc.SetMemory(&mem);
+  *proc.SP = STACK;
+}
+
+void InterruptTest::Load(MemAddr addr, std::vector<uint16_t> words) {
+  for (auto word : words) {
+    mem.SetUint16BSwap(addr, word);
+    addr += 2;
+  }
+}
+
+TEST_F(InterruptTest, Priority) {
+  InterruptController irq;
+  EXPECT_EQ(irq.GetHighest(true), -1);
+
+  irq.Set(InterruptController::PORT1, true);
+  irq.Set(InterruptController::WDT, true);
+  EXPECT_EQ(irq.GetHighest(true), InterruptController::WDT);
+  EXPECT_EQ(irq.GetHighest(false), -1);
+
+  irq.Set(InterruptController::WDT, false);
+  EXPECT_EQ(irq.GetHighest(true), InterruptController::PORT1);
+
+  // NMI ignores GIE
+  irq.Set(InterruptController::NMI, true);
+  EXPECT_EQ(irq.GetHighest(false), InterruptController::NMI);
+
+  EXPECT_EQ(InterruptController::GetVectorAddress(InterruptController::NMI),
+            0xFFFC);
+}
+
+TEST_F(InterruptTest, Dirty) {
+  InterruptController irq;
+  irq.dirty = false;
+  irq.Set(InterruptController::PORT1, false);
+  EXPECT_FALSE(irq.dirty);
+  irq.Set(InterruptController::PORT1, true);
+  EXPECT_TRUE(irq.dirty);
+}
+
+TEST_F(InterruptTest, Masked) {
+  proc.irq.Set(InterruptController::TIMER0_A0, true);
+  proc.Step();
+  // GIE was still clear when the bis ran
+  EXPECT_EQ(*proc.PC, MAIN + 2);
+  EXPECT_TRUE(proc.SR->general_int_en);
+}
+
+TEST_F(InterruptTest, EntryAndReti) {
+  int acknowledged = 0;
+  proc.irq.SetAcknowledge(InterruptController::TIMER0_A0, [&]() {
+    acknowledged++;
+    proc.irq.Set(InterruptController::TIMER0_A0, false);
+  });
+
+  proc.Step();
+  proc.Step();
+  EXPECT_EQ(*proc.PC, MAIN + 2);
+
+  proc.SR->carry = 1;
+  proc.irq.Set(InterruptController::TIMER0_A0, true);
+  auto cycles = proc.cycles;
+  proc.Step();
+  EXPECT_EQ(*proc.PC, ISR);
+  EXPECT_EQ(*proc.SP, STACK - 4);
+  EXPECT_EQ(mem.GetUint16(STACK - 2), MAIN + 2);
+  EXPECT_EQ(mem.GetUint16(STACK - 4), 0x0009);
+  EXPECT_EQ(proc.SR->val, 0);
+  EXPECT_EQ(proc.cycles - cycles, Processor::INTERRUPT_CYCLES);
+  EXPECT_EQ(acknowledged, 1);
+
+  cycles = proc.cycles;
+  proc.Step();
+  EXPECT_EQ(*proc.PC, MAIN + 2);
+  EXPECT_EQ(*proc.SP, STACK);
+  EXPECT_EQ(proc.SR->val, 0x0009);
+  EXPECT_EQ(proc.cycles - cycles, Processor::RETI_CYCLES);
+
+  // Not pending anymore, back to the loop
+  proc.Step();
+  EXPECT_EQ(*proc.PC, MAIN + 2);
+  EXPECT_EQ(acknowledged, 1);
+}
+
+TEST_F(InterruptTest, NonMaskable) {
+  proc.irq.Set(InterruptController::NMI, true);
+  proc.Step();
+  EXPECT_EQ(*proc.PC, ISR);
+}
+
+TEST_F(InterruptTest, LowPowerMode) {
+  *proc.PC = MAIN + 0x10;
+  proc.Step();
+  EXPECT_TRUE(proc.SR->cpu_off);
+  EXPECT_EQ(*proc.PC, MAIN + 0x14);
+
+  // Nothing scheduled, time moves on in steps
+  auto cycles = proc.cycles;
+  proc.Step();
+  EXPECT_EQ(proc.cycles - cycles, Processor::IDLE_CYCLES);
+  EXPECT_EQ(*proc.PC, MAIN + 0x14);
+
+  // Skips straight to the next event, which wakes the CPU up
+  auto wake = proc.scheduler.Add([&](uint64_t) {
+    proc.irq.Set(InterruptController::TIMER0_A0, true);
+  });
+  proc.scheduler.Schedule(wake, proc.cycles + 500);
+  cycles = proc.cycles;
+  proc.Step();
+  EXPECT_EQ(proc.cycles - cycles, 500);
+
+  proc.Step();
+  EXPECT_EQ(*proc.PC, ISR);
+  EXPECT_FALSE(proc.SR->cpu_off);
+
+  // RETI goes back to sleep
+  proc.irq.Set(InterruptController::TIMER0_A0, false);
+  proc.Step();
+  EXPECT_TRUE(proc.SR->cpu_off);
+}
+
+TEST_F(InterruptTest, LowPowerMode_Dead) {
+  proc.SR->cpu_off = 1;
+  EXPECT_THROW(proc.Step(), ProcessorException);
+}
@@ -430,4 +430,48 @@ TEST_F(ProcessorTest, OpAdd_Flags_Byte) {
 
 TEST_F(ProcessorTest, Step) { proc.Step(); }
 
-TEST_F(ProcessorTest, Cycle) { proc.Cycle(); }
\ No newline at end of file
+TEST_F(ProcessorTest, Cycle) { proc.Cycle(); }
+
+TEST_F(ProcessorTest, InstructionCycles) {
+  auto instruction = Processor::Format1();
+  instruction.op_code = 5;    // Add Op-Cpde
+  instruction.s_reg = 4;      // R4 Source Register
+  instruction.byte_word = 0;  // Word Operation
+  instruction.d_reg = 5;      // R5 Destination Register
+
+  // Register to register
+  instruction.as = 0;
+  instruction.ad = 0;
+  EXPECT_EQ(proc.InstructionCycles(instruction.val), 1);
+
+  // Indexed to indexed
+  instruction.as = 0b01;
+  instruction.ad = 1;
+  EXPECT_EQ(proc.InstructionCycles(instruction.val), 6);
+
+  // Constant generator counts as register mode
+  instruction.s_reg = 3;
+  instruction.as = 0b01;
+  instruction.ad = 0;
+  EXPECT_EQ(proc.InstructionCycles(instruction.val), 1);
+
+  // Immediate to PC (BR #N)
+  instruction.s_reg = 0;
+  instruction.as = 0b11;
+  instruction.d_reg = 0;
+  EXPECT_EQ(proc.InstructionCycles(instruction.val), 3);
+
+  // CALL #N, JMP
+  EXPECT_EQ(proc.InstructionCycles(0x12b0), 5);
+  EXPECT_EQ(proc.InstructionCycles(0x3ff3), 2);
+
+  // Step accumulates cycles
+  instruction.op_code = 5;
+  instruction.s_reg = 4;
+  instruction.as = 0;
+  instruction.d_reg = 5;
+  SetInstruction(instruction.val);
+  auto cycles = proc.cycles;
+  proc.Step();
+  EXPECT_EQ(proc.cycles, cycles + 1);
+}
@@ -43,4 +43,17 @@ TEST_F(ReadElfTest, GetSections_GoodFile) {
   auto sections = reader.GetSections();
   ASSERT_TRUE(sections.has_value()) << "File did not have any sections";
   ASSERT_EQ(sections.value().size(), 50) << "Incorrect amount of sections";
-}
\ No newline at end of file
+}
+
+TEST_F(ReadElfTest, GetSymbols) {
+  auto symbols = reader.GetSymbols();
+  ASSERT_TRUE(symbols.has_value()) << "File did not have any symbols";
+
+  auto main = symbols.value().find("main");
+  ASSERT_NE(main, symbols.value().end()) << "main not found";
+  EXPECT_EQ(main->second.st_value, 0xf800);
+  EXPECT_EQ(main->second.st_size, 66);
+
+  EXPECT_EQ(symbols.value().count("P1OUT"), 1);
+  EXPECT_EQ(symbols.value().at("P1OUT").st_value, 0x21);
+}
@@ -4,21 +4,25 @@
 #include <elf.h>
 
 #include <filesystem>
+#include <istream>
 #include <map>
 #include <optional>
 #include <string>
 #include <vector>
 
 typedef std::map<std::string, Elf32_Shdr> section_map;
+typedef std::map<std::string, Elf32_Sym> symbol_map;
 
 class ElfReader {
  public:
   ElfReader();
   ElfReader(std::string filepath);
+  ElfReader(std::istream& elf_file);
   ~ElfReader();
 
   std::optional<section_map> GetSections();
   std::optional<std::vector<Elf32_Phdr>> GetLoadableSegments();
+  std::optional<symbol_map> GetSymbols();
 
   Elf32_Ehdr header;
   Elf32_Shdr section_header;
@@ -27,10 +31,14 @@ class ElfReader {
   Elf32_Phdr program_header;
 
  private:
+  void Parse(std::istream& elf_file);
+  void ParseSymbols(std::istream& elf_file);
+
   std::vector<Elf32_Shdr> sections;
   std::vector<Elf32_Sym> symbols;
   std::vector<Elf32_Phdr> loadable_headers;
   section_map m_section_map;
+  symbol_map m_symbol_map;
   uint8_t magic[4]{0x7f, 0x45, 0x4c, 0x46};
 };
 
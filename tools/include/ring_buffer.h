@@ -0,0 +1,81 @@
+#ifndef ring_buffer_h
+#define ring_buffer_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Lock-free ring buffer for one producer thread and one consumer
+ * thread
+ *
+ * head and tail only ever increase and are masked on access, so CAPACITY
+ * must be a power of two. Each side owns one index and only reads the
+ * other, the block calls move as much as fits with a single publish.
+ */
+template <typename T, size_t CAPACITY>
+class RingBuffer {
+  static_assert(CAPACITY && (CAPACITY & (CAPACITY - 1)) == 0,
+                "capacity must be a power of two");
+
+ public:
+  RingBuffer(){};
+  ~RingBuffer(){};
+
+  bool Push(const T& val) { return Write(&val, 1) == 1; }
+  bool Pop(T& val) { return Read(&val, 1) == 1; }
+
+  /**
+   * @brief Producer side, returns how many of the count values fit
+   *
+   */
+  size_t Write(const T* data, size_t count) {
+    auto tail = this->tail.load(std::memory_order_relaxed);
+    auto head = this->head.load(std::memory_order_acquire);
+    count = std::min(count, CAPACITY - (tail - head));
+    for (size_t x = 0; x < count; x++) {
+      buffer[(tail + x) & MASK] = data[x];
+    }
+    this->tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Consumer side, returns how many values were read
+   *
+   */
+  size_t Read(T* data, size_t count) {
+    auto head = this->head.load(std::memory_order_relaxed);
+    auto tail = this->tail.load(std::memory_order_acquire);
+    count = std::min(count, tail - head);
+    // Moved out so the slot doesn't hold on to anything it owns
+    for (size_t x = 0; x < count; x++) {
+      data[x] = std::move(buffer[(head + x) & MASK]);
+    }
+    this->head.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  size_t Size() const {
+    return tail.load(std::memory_order_acquire) -
+           head.load(std::memory_order_acquire);
+  }
+  bool Empty() const { return Size() == 0; }
+
+  /**
+   * @brief Drop everything, only safe while neither side is active
+   *
+   */
+  void Clear() { head.store(tail.load()); }
+
+  static constexpr size_t MASK = CAPACITY - 1;
+
+ private:
+  T buffer[CAPACITY];
+  // Separate cache lines so the two sides don't contend
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
+
+#endif
@@ -3,6 +3,17 @@
 #include <fstream>
 #include <iostream>
 
+static std::string ReadString(std::istream& elf_file, std::streamoff offset) {
+  elf_file.clear();
+  elf_file.seekg(offset, std::ios::beg);
+  std::string name = "";
+  char ch;
+  while (elf_file.get(ch) && ch != '\0') {
+    name += ch;
+  }
+  return name;
+}
+
 ElfReader::ElfReader() {}
 
 ElfReader::ElfReader(std::string filepath) {
@@ -10,19 +21,22 @@ ElfReader::ElfReader(std::string filepath) {
     throw(ElfReaderException("File does not exist"));
   }
 
-  std::ifstream elf_file(filepath, std::ios::binary | std::ios::ate);
-  std::streamsize size = elf_file.tellg();
+  std::ifstream elf_file(filepath, std::ios::binary);
+  Parse(elf_file);
+}
+
+ElfReader::ElfReader(std::istream& elf_file) { Parse(elf_file); }
+
+void ElfReader::Parse(std::istream& elf_file) {
   elf_file.seekg(0, std::ios::beg);
 
   if (!elf_file.read((char*)&header, sizeof(Elf32_Ehdr))) {
-    elf_file.close();
     throw(ElfReaderException("Could not read file"));
   }
 
   // Check Magic Bytes
   for (int x = 0; x < 4; x++) {
     if (header.e_ident[x] != magic[x]) {
-      elf_file.close();
       throw(ElfReaderException("Invalid magic bytes"));
     }
   }
@@ -37,17 +51,8 @@ ElfReader::ElfReader(std::string filepath) {
 
   // Add to section map
   for (auto sec : sections) {
-    elf_file.seekg(sections.at(header.e_shstrndx).sh_offset + sec.sh_name,
-                   std::ios::beg);
-    std::string name = "";
-    char ch;
-    while (true) {
-      ch = elf_file.get();
-      if (ch == '\0') {
-        break;
-      }
-      name += ch;
-    }
+    auto name = ReadString(
+        elf_file, sections.at(header.e_shstrndx).sh_offset + sec.sh_name);
     m_section_map.emplace(name, sec);
   }
 
@@ -58,6 +63,47 @@ ElfReader::ElfReader(std::string filepath) {
     elf_file.read((char*)&program_header, sizeof(Elf32_Phdr));
     loadable_headers.push_back(program_header);
   }
+
+  ParseSymbols(elf_file);
+}
+
+void ElfReader::ParseSymbols(std::istream& elf_file) {
+  for (auto sec : sections) {
+    if (sec.sh_type == SHT_SYMTAB) {
+      symbol_section = sec;
+      break;
+    }
+  }
+  if (!symbol_section.has_value() ||
+      symbol_section->sh_link >= sections.size()) {
+    return;
+  }
+
+  auto strings = sections.at(symbol_section->sh_link).sh_offset;
+  auto count = symbol_section->sh_size / sizeof(Elf32_Sym);
+  for (Elf32_Word index = 0; index < count; index++) {
+    elf_file.seekg(symbol_section->sh_offset + (index * sizeof(Elf32_Sym)),
+                   std::ios::beg);
+    if (!elf_file.read((char*)&symbol, sizeof(Elf32_Sym))) {
+      break;
+    }
+    symbols.push_back(symbol);
+  }
+
+  for (auto sym : symbols) {
+    auto type = ELF32_ST_TYPE(sym.st_info);
+    if (sym.st_name == 0 || type == STT_FILE || type == STT_SECTION) {
+      continue;
+    }
+    auto name = ReadString(elf_file, strings + sym.st_name);
+
+    // Globals win over locals of the same name
+    if (ELF32_ST_BIND(sym.st_info) == STB_GLOBAL) {
+      m_symbol_map[name] = sym;
+    } else {
+      m_symbol_map.emplace(name, sym);
+    }
+  }
 }
 
 ElfReader::~ElfReader() {}
@@ -75,3 +121,10 @@ std::optional<std::vector<Elf32_Phdr>> ElfReader::GetLoadableSegments() {
   }
   return {};
 }
+
+std::optional<symbol_map> ElfReader::GetSymbols() {
+  if (m_symbol_map.size() > 0) {
+    return m_symbol_map;
+  }
+  return {};
+}